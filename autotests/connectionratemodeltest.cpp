@@ -0,0 +1,90 @@
+/*
+  SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+  SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "connectionratemodeltest.h"
+using namespace Qt::Literals::StringLiterals;
+
+#include "connectionratemodel.h"
+#include "debugmodel.h"
+
+#include <QSignalSpy>
+#include <QStandardItemModel>
+#include <QTest>
+
+namespace
+{
+QStringList connections(const ConnectionRateModel &model)
+{
+    QStringList result;
+    for (int row = 0; row < model.rowCount(); ++row) {
+        result << model.index(row, ConnectionRateModel::ConnectionColumn).data().toString();
+    }
+    return result;
+}
+}
+
+ConnectionRateModelTest::ConnectionRateModelTest(QObject *parent)
+    : QObject(parent)
+{
+}
+
+ConnectionRateModelTest::~ConnectionRateModelTest() = default;
+
+void ConnectionRateModelTest::shouldListConnections()
+{
+    DebugModel debugModel;
+    QStandardItemModel senders;
+    debugModel.setSenderFilterModel(&senders);
+    ConnectionRateModel model(&debugModel);
+    QCOMPARE(model.rowCount(), 0);
+
+    debugModel.addMessage(u"akonadi_imap_resource (0xa)"_s, DebugModel::ClientToServer, u"1 LOGIN"_s);
+    debugModel.addMessage(u"kmail (0xb)"_s, DebugModel::ClientToServer, u"2 SELECT"_s);
+    // Only refreshed while active
+    QCOMPARE(model.rowCount(), 0);
+
+    model.setActive(true);
+    QCOMPARE(connections(model), QStringList({u"akonadi_imap_resource (0xa)"_s, u"kmail (0xb)"_s}));
+    QCOMPARE(model.index(1, ConnectionRateModel::MessageCountColumn).data().toULongLong(), 1ULL);
+    model.setActive(false);
+}
+
+void ConnectionRateModelTest::shouldRemoveRowsWithTheirConnections()
+{
+    DebugModel debugModel;
+    QStandardItemModel senders;
+    debugModel.setSenderFilterModel(&senders);
+    ConnectionRateModel model(&debugModel);
+
+    debugModel.addMessage(u"akonadi_imap_resource (0xa)"_s, DebugModel::ClientToServer, u"1 LOGIN"_s);
+    debugModel.addMessage(u"kmail (0xb)"_s, DebugModel::ClientToServer, u"2 SELECT"_s);
+    debugModel.addMessage(u"korganizer (0xc)"_s, DebugModel::ClientToServer, u"3 SELECT"_s);
+    debugModel.addMessage(u"korganizer (0xc)"_s, DebugModel::ClientToServer, u"4 FETCH"_s);
+    model.setActive(true);
+    QCOMPARE(model.rowCount(), 3);
+
+    // The last connection takes the id of the removed one, without waiting for the next refresh
+    QSignalSpy resetSpy(&model, &QAbstractItemModel::modelReset);
+    QVERIFY(debugModel.removeRows(0, 1));
+    QCOMPARE(resetSpy.count(), 1);
+    QCOMPARE(connections(model), QStringList({u"korganizer (0xc)"_s, u"kmail (0xb)"_s}));
+    QCOMPARE(model.index(0, ConnectionRateModel::MessageCountColumn).data().toULongLong(), 2ULL);
+
+    // Rows of a connection with messages left stay
+    QVERIFY(debugModel.removeRows(1, 1));
+    QCOMPARE(resetSpy.count(), 1);
+    QCOMPARE(model.rowCount(), 2);
+
+    QVERIFY(debugModel.removeRows(0, debugModel.rowCount()));
+    QCOMPARE(resetSpy.count(), 2);
+    QCOMPARE(model.rowCount(), 0);
+    QVERIFY(!model.index(0, ConnectionRateModel::ConnectionColumn).data().isValid());
+    model.setActive(false);
+}
+
+QTEST_GUILESS_MAIN(ConnectionRateModelTest)
+
+#include "moc_connectionratemodeltest.cpp"
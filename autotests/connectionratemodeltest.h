@@ -0,0 +1,19 @@
+/*
+  SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+  SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <QObject>
+
+class ConnectionRateModelTest : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ConnectionRateModelTest(QObject *parent = nullptr);
+    ~ConnectionRateModelTest() override;
+private Q_SLOTS:
+    void shouldListConnections();
+    void shouldRemoveRowsWithTheirConnections();
+};
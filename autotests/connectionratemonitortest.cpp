@@ -0,0 +1,142 @@
+/*
+  SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+  SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "connectionratemonitortest.h"
+using namespace Qt::Literals::StringLiterals;
+
+#include "connectionratemonitor.h"
+
+#include <QTest>
+
+namespace
+{
+constexpr qint64 Start = 1'700'000'000'000;
+constexpr auto Requests = ConnectionRateMonitor::ClientToServer;
+constexpr auto Responses = ConnectionRateMonitor::ServerToClient;
+
+// Sends @p rate requests of @p size bytes per second on @p identifier for @p seconds
+qint64 send(ConnectionRateMonitor &monitor, const QString &identifier, qint64 time, int seconds, int rate, qint64 size)
+{
+    for (int s = 0; s < seconds; ++s) {
+        for (int i = 0; i < rate; ++i) {
+            monitor.addMessage(time + i, identifier, Requests, size);
+        }
+        time += 1000;
+    }
+    return time;
+}
+}
+
+ConnectionRateMonitorTest::ConnectionRateMonitorTest(QObject *parent)
+    : QObject(parent)
+{
+}
+
+ConnectionRateMonitorTest::~ConnectionRateMonitorTest() = default;
+
+void ConnectionRateMonitorTest::shouldCountPerConnection()
+{
+    ConnectionRateMonitor monitor;
+    qint64 time = send(monitor, u"0x1"_s, Start, ConnectionRateMonitor::RateSeconds, 20, 100);
+    send(monitor, u"0x2"_s, Start, ConnectionRateMonitor::RateSeconds, 2, 10);
+    monitor.addMessage(Start + 500, u"0x2"_s, Responses, 1000);
+    monitor.advanceTo(time);
+
+    QCOMPARE(monitor.count(), 2);
+    QCOMPARE(monitor.identifier(0), u"0x1"_s);
+    QCOMPARE(monitor.messageRate(0, Requests), 20.0);
+    QCOMPARE(monitor.byteRate(0, Requests), 2000.0);
+    QCOMPARE(monitor.messageRate(0, Responses), 0.0);
+    QCOMPARE(monitor.messageRate(1, Requests), 2.0);
+    QCOMPARE(monitor.byteRate(1, Responses), 1000.0 / ConnectionRateMonitor::RateSeconds);
+    QCOMPARE(monitor.messageCount(0, Requests), quint64(20 * ConnectionRateMonitor::RateSeconds));
+
+    // The current second is not complete yet
+    time = send(monitor, u"0x1"_s, time, 1, 100, 1);
+    QCOMPARE(monitor.messageRate(0, Requests), 20.0);
+    monitor.advanceTo(time);
+    QCOMPARE(monitor.messageRate(0, Requests), 36.0);
+}
+
+void ConnectionRateMonitorTest::shouldForgetOldSeconds()
+{
+    ConnectionRateMonitor monitor;
+    qint64 time = send(monitor, u"0x1"_s, Start, 3, 10, 1);
+
+    // An idle connection decays without being touched
+    monitor.advanceTo(time + ConnectionRateMonitor::RateSeconds * 1000);
+    QCOMPARE(monitor.messageRate(0, Requests), 0.0);
+    QCOMPARE(monitor.messageCount(0, Requests), quint64(30));
+    monitor.advanceTo(Start + ConnectionRateMonitor::WindowSeconds * 1000);
+    QCOMPARE(monitor.messageCount(0, Requests), quint64(20));
+
+    // Its next message clears the seconds it skipped, which wrapped around the ring
+    time = Start + 2 * ConnectionRateMonitor::WindowSeconds * 1000;
+    send(monitor, u"0x1"_s, time, 1, 4, 1);
+    monitor.advanceTo(time);
+    QCOMPARE(monitor.messageCount(0, Requests), quint64(4));
+
+    // Messages older than the window are ignored
+    monitor.addMessage(Start, u"0x1"_s, Requests, 1);
+    monitor.addMessage(Start, u"0x2"_s, Requests, 1);
+    QCOMPARE(monitor.messageCount(0, Requests), quint64(4));
+    QCOMPARE(monitor.count(), 1);
+}
+
+void ConnectionRateMonitorTest::shouldAverageLatency()
+{
+    ConnectionRateMonitor monitor;
+    monitor.addMessage(Start, u"0x1"_s, Requests, 1);
+    QCOMPARE(monitor.averageLatency(0), -1.0);
+    monitor.addRoundTrip(Start + 10, u"0x1"_s, 10);
+    monitor.addRoundTrip(Start + 2000, u"0x1"_s, 30);
+    QCOMPARE(monitor.averageLatency(0), 20.0);
+
+    monitor.advanceTo(Start + (ConnectionRateMonitor::WindowSeconds + 1) * 1000);
+    QCOMPARE(monitor.averageLatency(0), 30.0);
+}
+
+void ConnectionRateMonitorTest::shouldRemoveConnections()
+{
+    ConnectionRateMonitor monitor;
+    send(monitor, u"0x1"_s, Start, 1, 1, 1);
+    send(monitor, u"0x2"_s, Start, 1, 2, 1);
+    send(monitor, u"0x3"_s, Start, 1, 3, 1);
+
+    monitor.remove(u"0x1"_s);
+    monitor.remove(u"0x4"_s);
+    QCOMPARE(monitor.count(), 2);
+    // The last connection took the place of the removed one
+    QCOMPARE(monitor.identifier(0), u"0x3"_s);
+    QCOMPARE(monitor.messageCount(0, Requests), quint64(3));
+
+    send(monitor, u"0x3"_s, Start, 1, 1, 1);
+    QCOMPARE(monitor.count(), 2);
+    QCOMPARE(monitor.messageCount(0, Requests), quint64(4));
+
+    monitor.clear();
+    QCOMPARE(monitor.count(), 0);
+}
+
+void ConnectionRateMonitorTest::shouldCountFromTheEpoch()
+{
+    // Synthetic captures can start right at the epoch, or even before it
+    ConnectionRateMonitor monitor;
+    monitor.addMessage(-1500, u"0x1"_s, Requests, 1);
+    monitor.addRoundTrip(-1000, u"0x1"_s, 10);
+    QCOMPARE(monitor.count(), 0);
+
+    const qint64 time = send(monitor, u"0x1"_s, 0, 2, 3, 1);
+    monitor.addRoundTrip(1500, u"0x1"_s, 10);
+    QCOMPARE(monitor.messageCount(0, Requests), quint64(6));
+    QCOMPARE(monitor.averageLatency(0), 10.0);
+    monitor.advanceTo(time);
+    QCOMPARE(monitor.messageRate(0, Requests), 6.0 / ConnectionRateMonitor::RateSeconds);
+}
+
+QTEST_GUILESS_MAIN(ConnectionRateMonitorTest)
+
+#include "moc_connectionratemonitortest.cpp"
@@ -0,0 +1,22 @@
+/*
+  SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+  SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <QObject>
+
+class ConnectionRateMonitorTest : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ConnectionRateMonitorTest(QObject *parent = nullptr);
+    ~ConnectionRateMonitorTest() override;
+private Q_SLOTS:
+    void shouldCountPerConnection();
+    void shouldForgetOldSeconds();
+    void shouldAverageLatency();
+    void shouldRemoveConnections();
+    void shouldCountFromTheEpoch();
+};
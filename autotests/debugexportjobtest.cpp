@@ -0,0 +1,193 @@
+/*
+  SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+  SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "debugexportjobtest.h"
+using namespace Qt::Literals::StringLiterals;
+
+#include "connectionratemodel.h"
+#include "debugcaptureloader.h"
+#include "debugexportjob.h"
+#include "debugmodel.h"
+#include "testutils.h"
+
+#include <QFile>
+#include <QSortFilterProxyModel>
+#include <QStandardItemModel>
+#include <QTemporaryDir>
+#include <QTest>
+
+namespace
+{
+void fillModel(DebugModel &model)
+{
+    model.addMessage(u"kmail (0x1)"_s, DebugModel::ClientToServer, u"1 LoginCommand"_s, 1000);
+    model.addMessage(u"korganizer (0x2)"_s, DebugModel::ClientToServer, u"1 FetchItemsCommand"_s, 1010);
+    model.addMessage(u"kmail (0x1)"_s, DebugModel::ServerToClient, u"1 LoginResponse"_s, 1020);
+    model.addMessage(u"korganizer (0x2)"_s, DebugModel::ServerToClient, u"1 FetchItemsResponse\nZpráva ✓"_s, 1100);
+}
+
+QByteArray readFile(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return {};
+    }
+    return file.readAll();
+}
+}
+
+DebugExportJobTest::DebugExportJobTest(QObject *parent)
+    : QObject(parent)
+{
+}
+
+DebugExportJobTest::~DebugExportJobTest() = default;
+
+void DebugExportJobTest::shouldWriteText()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    DebugModel model;
+    QStandardItemModel senders;
+    model.setSenderFilterModel(&senders);
+    fillModel(model);
+
+    DebugExportJob all(&model, nullptr, dir.filePath(u"all.txt"_s), DebugExportJob::Text);
+    QVERIFY(TestUtils::runJob(all));
+    QCOMPARE(readFile(all.fileName()),
+             u"<- kmail (0x1) 1 LoginCommand\n"
+             "<- korganizer (0x2) 1 FetchItemsCommand\n"
+             "-> kmail (0x1) 1 LoginResponse\n"
+             "-> korganizer (0x2) 1 FetchItemsResponse\nZpráva ✓\n"_s.toUtf8());
+
+    QSortFilterProxyModel filter;
+    filter.setSourceModel(&model);
+    filter.setFilterRole(DebugModel::IdentifierRole);
+    filter.setFilterFixedString(u"0x1"_s);
+    DebugExportJob filtered(&model, &filter, dir.filePath(u"filtered.txt"_s), DebugExportJob::Text);
+    // Messages arriving after the job was created are not saved
+    fillModel(model);
+    QVERIFY(TestUtils::runJob(filtered));
+    QCOMPARE(readFile(filtered.fileName()), QByteArray("<- kmail (0x1) 1 LoginCommand\n-> kmail (0x1) 1 LoginResponse\n"));
+}
+
+void DebugExportJobTest::shouldReplayCapture()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    DebugModel model;
+    QStandardItemModel senders;
+    model.setSenderFilterModel(&senders);
+    fillModel(model);
+    DebugExportJob job(&model, nullptr, dir.filePath(u"capture.akdebug"_s), DebugExportJob::Capture);
+    QVERIFY(TestUtils::runJob(job));
+
+    DebugModel replayed;
+    QStandardItemModel replayedSenders;
+    replayed.setSenderFilterModel(&replayedSenders);
+    replayed.addMessage(u"akonadiserver (0x9)"_s, DebugModel::ClientToServer, u"1 LoginCommand"_s);
+    DebugCaptureLoader loader(&replayed);
+    QString errorString;
+    QVERIFY2(TestUtils::load(loader, job.fileName(), &errorString), qPrintable(errorString));
+
+    // The capture replaces what was there, and is decoded and paired again
+    QCOMPARE(replayed.rowCount(), model.rowCount());
+    QCOMPARE(replayedSenders.rowCount(), 2);
+    for (int row = 0; row < model.rowCount(); ++row) {
+        for (int column = 0; column < DebugModel::_ColumnCount; ++column) {
+            QCOMPARE(replayed.index(row, column).data(), model.index(row, column).data());
+        }
+        QCOMPARE(replayed.messageAt(row).timestamp, model.messageAt(row).timestamp);
+    }
+    QCOMPARE(replayed.index(0, DebugModel::LatencyColumn).data().toString(), u"20 ms"_s);
+    QCOMPARE(replayed.statistics().count(), 2);
+}
+
+void DebugExportJobTest::shouldMeterReplayedCapture()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    DebugModel model;
+    QStandardItemModel senders;
+    model.setSenderFilterModel(&senders);
+    fillModel(model);
+    DebugExportJob job(&model, nullptr, dir.filePath(u"capture.akdebug"_s), DebugExportJob::Capture);
+    QVERIFY(TestUtils::runJob(job));
+
+    DebugModel replayed;
+    QStandardItemModel replayedSenders;
+    replayed.setSenderFilterModel(&replayedSenders);
+    ConnectionRateModel rates(&replayed);
+    // Live messages and refreshing the meters move them to the current time
+    replayed.addMessage(u"akonadiserver (0x9)"_s, DebugModel::ClientToServer, u"1 LoginCommand"_s);
+    rates.setActive(true);
+    rates.setActive(false);
+    QCOMPARE(rates.rowCount(), 1);
+    QVERIFY(!replayed.isReplay());
+
+    DebugCaptureLoader loader(&replayed);
+    QString errorString;
+    QVERIFY2(TestUtils::load(loader, job.fileName(), &errorString), qPrintable(errorString));
+    QVERIFY(replayed.isReplay());
+
+    // The capture is decades old, the meters still show it at its own time
+    rates.setActive(true);
+    QCOMPARE(rates.rowCount(), 2);
+    quint64 messages = 0;
+    for (int row = 0; row < rates.rowCount(); ++row) {
+        messages += rates.index(row, ConnectionRateModel::MessageCountColumn).data().toULongLong();
+        if (rates.index(row, ConnectionRateModel::ConnectionColumn).data().toString().contains(u"0x1"_s)) {
+            QCOMPARE(rates.index(row, ConnectionRateModel::AverageLatencyColumn).data(ConnectionRateModel::SortRole).toDouble(), 20.0);
+        }
+    }
+    QCOMPARE(messages, quint64(model.rowCount()));
+    rates.setActive(false);
+
+    // The next live message brings the meters back to the clock
+    replayed.addMessage(u"akonadiserver (0x9)"_s, DebugModel::ClientToServer, u"2 LoginCommand"_s);
+    QVERIFY(!replayed.isReplay());
+}
+
+void DebugExportJobTest::shouldRejectDamagedCapture()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    DebugModel model;
+    QStandardItemModel senders;
+    model.setSenderFilterModel(&senders);
+    fillModel(model);
+    DebugExportJob job(&model, nullptr, dir.filePath(u"capture.akdebug"_s), DebugExportJob::Capture);
+    QVERIFY(TestUtils::runJob(job));
+
+    // Cut off in the middle of the last message
+    const QByteArray capture = readFile(job.fileName());
+    const QString truncated = dir.filePath(u"truncated.akdebug"_s);
+    QFile file(truncated);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(capture.left(capture.size() - 3));
+    file.close();
+
+    DebugModel replayed;
+    QStandardItemModel replayedSenders;
+    replayed.setSenderFilterModel(&replayedSenders);
+    DebugCaptureLoader loader(&replayed);
+    QString errorString;
+    QVERIFY(!TestUtils::load(loader, truncated, &errorString));
+    QVERIFY(!errorString.isEmpty());
+    QCOMPARE(replayed.rowCount(), model.rowCount() - 1);
+
+    const QString text = dir.filePath(u"messages.txt"_s);
+    QFile textFile(text);
+    QVERIFY(textFile.open(QIODevice::WriteOnly));
+    textFile.write("<- kmail (0x1) 1 LoginCommand\n");
+    textFile.close();
+    DebugCaptureLoader textLoader(&replayed);
+    QVERIFY(!TestUtils::load(textLoader, text, &errorString));
+}
+
+QTEST_GUILESS_MAIN(DebugExportJobTest)
+
+#include "moc_debugexportjobtest.cpp"
@@ -0,0 +1,21 @@
+/*
+  SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+  SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <QObject>
+
+class DebugExportJobTest : public QObject
+{
+    Q_OBJECT
+public:
+    explicit DebugExportJobTest(QObject *parent = nullptr);
+    ~DebugExportJobTest() override;
+private Q_SLOTS:
+    void shouldWriteText();
+    void shouldReplayCapture();
+    void shouldMeterReplayedCapture();
+    void shouldRejectDamagedCapture();
+};
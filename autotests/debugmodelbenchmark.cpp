@@ -0,0 +1,42 @@
+/*
+  SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+  SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "debugmodelbenchmark.h"
+using namespace Qt::Literals::StringLiterals;
+
+#include "debugmodel.h"
+
+#include <QStandardItemModel>
+#include <QTest>
+
+DebugModelBenchmark::DebugModelBenchmark(QObject *parent)
+    : QObject(parent)
+{
+}
+
+DebugModelBenchmark::~DebugModelBenchmark() = default;
+
+void DebugModelBenchmark::benchmarkClear()
+{
+    DebugModel model;
+    QStandardItemModel senders;
+    model.setSenderFilterModel(&senders);
+    model.setMaximumCount(0);
+    for (int i = 0; i < 1'000'000; ++i) {
+        model.addMessage(u"akonadi_imap_resource (0x%1)"_s.arg(i % 50), DebugModel::ClientToServer, u"%1 FETCH"_s.arg(i));
+    }
+    QCOMPARE(senders.rowCount(), 50);
+
+    QBENCHMARK_ONCE {
+        QVERIFY(model.removeRows(0, model.rowCount()));
+    }
+    QCOMPARE(model.rowCount(), 0);
+    QCOMPARE(senders.rowCount(), 0);
+}
+
+QTEST_GUILESS_MAIN(DebugModelBenchmark)
+
+#include "moc_debugmodelbenchmark.cpp"
@@ -0,0 +1,18 @@
+/*
+  SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+  SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <QObject>
+
+class DebugModelBenchmark : public QObject
+{
+    Q_OBJECT
+public:
+    explicit DebugModelBenchmark(QObject *parent = nullptr);
+    ~DebugModelBenchmark() override;
+private Q_SLOTS:
+    void benchmarkClear();
+};
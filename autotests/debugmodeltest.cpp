@@ -0,0 +1,203 @@
+/*
+  SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+  SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "debugmodeltest.h"
+using namespace Qt::Literals::StringLiterals;
+
+#include "debugmodel.h"
+
+#include <QSignalSpy>
+#include <QStandardItemModel>
+#include <QTest>
+
+namespace
+{
+QString messageAt(const DebugModel &model, int row)
+{
+    return model.index(row, DebugModel::MessageColumn).data().toString();
+}
+
+void addMessages(DebugModel &model, int first, int count)
+{
+    for (int i = first; i < first + count; ++i) {
+        model.addMessage(u"akonadi_imap_resource (0x%1)"_s.arg(i % 3), DebugModel::ClientToServer, QString::number(i));
+    }
+}
+}
+
+DebugModelTest::DebugModelTest(QObject *parent)
+    : QObject(parent)
+{
+}
+
+DebugModelTest::~DebugModelTest() = default;
+
+void DebugModelTest::shouldDropOldestMessages()
+{
+    DebugModel model;
+    QStandardItemModel senders;
+    model.setSenderFilterModel(&senders);
+    model.setMaximumCount(160);
+    QSignalSpy removedSpy(&model, &QAbstractItemModel::rowsRemoved);
+
+    addMessages(model, 0, 160);
+    QCOMPARE(model.rowCount(), 160);
+    QCOMPARE(removedSpy.count(), 0);
+
+    // A full buffer drops a sixteenth of its messages at once
+    addMessages(model, 160, 1);
+    QCOMPARE(removedSpy.count(), 1);
+    QCOMPARE(model.rowCount(), 151);
+    QCOMPARE(messageAt(model, 0), u"10"_s);
+    QCOMPARE(messageAt(model, 150), u"160"_s);
+
+    addMessages(model, 161, 1000);
+    QVERIFY(model.rowCount() <= 160);
+    QCOMPARE(messageAt(model, model.rowCount() - 1), u"1160"_s);
+    for (int row = 1; row < model.rowCount(); ++row) {
+        QCOMPARE(messageAt(model, row).toInt(), messageAt(model, row - 1).toInt() + 1);
+    }
+
+    model.setMaximumCount(50);
+    QCOMPARE(model.rowCount(), 50);
+    QCOMPARE(messageAt(model, 0), u"1111"_s);
+}
+
+void DebugModelTest::shouldRemoveRowsAfterWrapping()
+{
+    DebugModel model;
+    QStandardItemModel senders;
+    model.setSenderFilterModel(&senders);
+    model.setMaximumCount(32);
+    addMessages(model, 0, 40);
+    const int count = model.rowCount();
+    const int first = messageAt(model, 0).toInt();
+
+    QVERIFY(model.removeRows(2, 3));
+    QCOMPARE(model.rowCount(), count - 3);
+    QCOMPARE(messageAt(model, 1).toInt(), first + 1);
+    QCOMPARE(messageAt(model, 2).toInt(), first + 5);
+
+    addMessages(model, 40, 1);
+    QCOMPARE(messageAt(model, model.rowCount() - 1), u"40"_s);
+
+    QVERIFY(model.removeRows(0, model.rowCount()));
+    QCOMPARE(model.rowCount(), 0);
+    QCOMPARE(senders.rowCount(), 0);
+    QVERIFY(!model.removeRows(0, 1));
+}
+
+void DebugModelTest::shouldRemoveUnusedSenders()
+{
+    DebugModel model;
+    QStandardItemModel senders;
+    model.setSenderFilterModel(&senders);
+    model.addMessage(u"akonadiserver (0x1)"_s, DebugModel::ClientToServer, u"1 LOGIN"_s);
+    model.addMessage(u"kmail (0x2)"_s, DebugModel::ClientToServer, u"2 LOGIN"_s);
+    model.addMessage(u"akonadiserver (0x1)"_s, DebugModel::ServerToClient, u"1 OK"_s);
+    QCOMPARE(senders.rowCount(), 2);
+
+    // The first sender still has a message
+    QVERIFY(model.removeRows(0, 2));
+    QCOMPARE(senders.rowCount(), 1);
+    QCOMPARE(senders.item(0)->data(DebugModel::IdentifierRole).toString(), u"0x1"_s);
+    // So do their meters
+    QCOMPARE(model.connectionRates().count(), 1);
+    QCOMPARE(model.connectionRates().identifier(0), u"0x1"_s);
+
+    QVERIFY(model.removeRows(0, 1));
+    QCOMPARE(senders.rowCount(), 0);
+
+    // Dropped messages release their senders too
+    model.setMaximumCount(16);
+    model.addMessage(u"kmail (0xa)"_s, DebugModel::ClientToServer, u"3 LOGIN"_s);
+    addMessages(model, 0, 16);
+    QCOMPARE(senders.rowCount(), 3);
+    QVERIFY(senders.findItems(u"kmail (0xa)"_s).isEmpty());
+}
+
+void DebugModelTest::shouldRemoveScatteredMessages()
+{
+    DebugModel model;
+    QStandardItemModel senders;
+    model.setSenderFilterModel(&senders);
+    addMessages(model, 0, 30);
+
+    QList<int> rows;
+    for (int row = 0; row < 30; row += 3) {
+        rows << row;
+    }
+    model.removeMessages(rows);
+    QCOMPARE(model.rowCount(), 20);
+    QCOMPARE(messageAt(model, 0), u"1"_s);
+    QCOMPARE(messageAt(model, 1), u"2"_s);
+    QCOMPARE(messageAt(model, 2), u"4"_s);
+    // Every third message came from the same sender
+    QCOMPARE(senders.rowCount(), 2);
+}
+
+void DebugModelTest::shouldPairRequestsAndResponses()
+{
+    DebugModel model;
+    QStandardItemModel senders;
+    model.setSenderFilterModel(&senders);
+    const QString kmail = u"kmail (0x1)"_s;
+    const QString korganizer = u"korganizer (0x2)"_s;
+    model.addMessage(kmail, DebugModel::ClientToServer, u"1 FetchItemsCommand"_s, 1000);
+    // The same tag on another connection is another request
+    model.addMessage(korganizer, DebugModel::ClientToServer, u"1 FetchItemsCommand"_s, 1010);
+    model.addMessage(kmail, DebugModel::ClientToServer, u"2 LoginCommand"_s, 1020);
+    model.addMessage(kmail, DebugModel::ServerToClient, u"1 FetchItemsResponse"_s, 1100);
+    model.addMessage(kmail, DebugModel::ServerToClient, u"1 FetchItemsResponse"_s, 1300);
+    model.addMessage(korganizer, DebugModel::ServerToClient, u"1 FetchItemsResponse"_s, 1060);
+    model.addMessage(kmail, DebugModel::ServerToClient, u"9 LoginResponse"_s, 1400);
+
+    const auto latency = [&model](int row) {
+        return model.index(row, DebugModel::LatencyColumn).data().toString();
+    };
+    const auto request = [&model](int row) {
+        return model.index(row, 0).data(DebugModel::RequestRole).toLongLong();
+    };
+    QCOMPARE(model.index(0, DebugModel::TagColumn).data().toLongLong(), qint64(1));
+    QCOMPARE(model.index(0, DebugModel::CommandColumn).data().toString(), u"FetchItems"_s);
+    // The request gets the latency of its first response
+    QCOMPARE(latency(0), u"100 ms"_s);
+    QCOMPARE(latency(1), u"50 ms"_s);
+    QVERIFY(latency(2).isEmpty());
+    QCOMPARE(latency(3), u"100 ms"_s);
+    QCOMPARE(latency(4), u"300 ms"_s);
+    QVERIFY(latency(6).isEmpty());
+
+    QCOMPARE(request(3), request(0));
+    QCOMPARE(request(4), request(0));
+    QCOMPARE(request(5), request(1));
+    QVERIFY(request(0) != request(1));
+    // An unpaired response is a group of its own
+    QCOMPARE(request(6), qint64(6));
+
+    const auto &statistics = model.statistics();
+    QCOMPARE(statistics.count(), 2);
+    const auto &fetch = statistics.at(0);
+    QCOMPARE(fetch.name, u"FetchItems"_s);
+    QCOMPARE(fetch.requests, quint64(2));
+    QCOMPARE(fetch.responses, quint64(3));
+    QCOMPARE(fetch.roundTrips, quint64(2));
+    QCOMPARE(fetch.minimumLatency, qint64(50));
+    QCOMPARE(fetch.maximumLatency, qint64(100));
+    QCOMPARE(fetch.averageLatency(), 75.0);
+    QCOMPARE(fetch.requestBytes, quint64(2 * 19));
+    const auto &login = statistics.at(1);
+    QCOMPARE(login.requests, quint64(1));
+    QCOMPARE(login.responses, quint64(1));
+    QCOMPARE(login.roundTrips, quint64(0));
+
+    model.resetStatistics();
+    QCOMPARE(model.statistics().count(), 0);
+}
+
+QTEST_GUILESS_MAIN(DebugModelTest)
+
+#include "moc_debugmodeltest.cpp"
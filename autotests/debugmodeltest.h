@@ -0,0 +1,22 @@
+/*
+  SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+  SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <QObject>
+
+class DebugModelTest : public QObject
+{
+    Q_OBJECT
+public:
+    explicit DebugModelTest(QObject *parent = nullptr);
+    ~DebugModelTest() override;
+private Q_SLOTS:
+    void shouldDropOldestMessages();
+    void shouldRemoveRowsAfterWrapping();
+    void shouldRemoveUnusedSenders();
+    void shouldRemoveScatteredMessages();
+    void shouldPairRequestsAndResponses();
+};
@@ -0,0 +1,102 @@
+/*
+  SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+  SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "exportjobtest.h"
+using namespace Qt::Literals::StringLiterals;
+
+#include "exportjob.h"
+
+#include <QApplication>
+#include <QFile>
+#include <QMessageBox>
+#include <QPointer>
+#include <QPushButton>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QTimer>
+
+namespace
+{
+class FailingJob : public ExportJob
+{
+public:
+    using ExportJob::ExportJob;
+
+    bool canceling = false;
+
+protected:
+    bool write(QIODevice *device) override
+    {
+        Q_UNUSED(device)
+        if (canceling) {
+            cancel();
+        } else {
+            setErrorString(u"No space left on device"_s);
+        }
+        return false;
+    }
+};
+
+// Collects the text of the warnings shown while @p closer runs, and closes them
+void acceptWarnings(QTimer &closer, QStringList &warnings)
+{
+    closer.setInterval(10);
+    QObject::connect(&closer, &QTimer::timeout, [&warnings]() {
+        const auto widgets = QApplication::topLevelWidgets();
+        for (auto widget : widgets) {
+            auto box = qobject_cast<QMessageBox *>(widget);
+            if (box && box->isVisible()) {
+                warnings.append(box->text());
+                box->button(QMessageBox::Ok)->click();
+            }
+        }
+    });
+    closer.start();
+}
+}
+
+ExportJobTest::ExportJobTest(QObject *parent)
+    : QObject(parent)
+{
+}
+
+ExportJobTest::~ExportJobTest() = default;
+
+void ExportJobTest::shouldReportFailureInProgressDialog()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    auto job = new FailingJob(dir.filePath(u"export.txt"_s));
+    QPointer<ExportJob> guard(job);
+    QStringList warnings;
+    QTimer closer;
+    acceptWarnings(closer, warnings);
+    job->startWithProgressDialog(nullptr, u"Saving..."_s);
+    // The job deletes itself once the dialog is done
+    QTRY_VERIFY(guard.isNull());
+    QCOMPARE(warnings.count(), 1);
+    QVERIFY(warnings.constFirst().contains(u"No space left on device"_s));
+    QVERIFY(!QFile::exists(dir.filePath(u"export.txt"_s)));
+}
+
+void ExportJobTest::shouldNotReportCancellation()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    auto job = new FailingJob(dir.filePath(u"export.txt"_s));
+    job->canceling = true;
+    QPointer<ExportJob> guard(job);
+    QStringList warnings;
+    QTimer closer;
+    acceptWarnings(closer, warnings);
+    job->startWithProgressDialog(nullptr, u"Saving..."_s);
+    QTRY_VERIFY(guard.isNull());
+    QVERIFY(warnings.isEmpty());
+}
+
+QTEST_MAIN(ExportJobTest)
+
+#include "moc_exportjobtest.cpp"
@@ -0,0 +1,19 @@
+/*
+  SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+  SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <QObject>
+
+class ExportJobTest : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ExportJobTest(QObject *parent = nullptr);
+    ~ExportJobTest() override;
+private Q_SLOTS:
+    void shouldReportFailureInProgressDialog();
+    void shouldNotReportCancellation();
+};
@@ -0,0 +1,77 @@
+/*
+  SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+  SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "logcaptureloaderbenchmark.h"
+using namespace Qt::Literals::StringLiterals;
+
+#include "logcaptureloader.h"
+#include "logexportjob.h"
+#include "loggingfiltermodel.h"
+#include "loggingmodel.h"
+#include "testutils.h"
+
+#include <QTemporaryDir>
+#include <QTest>
+
+namespace
+{
+constexpr int MessagesCount = 200'000;
+
+void fillModel(LoggingModel &model)
+{
+    const QStringList apps = {u"akonadiserver"_s, u"akonadi_imap_resource"_s, u"kmail"_s};
+    for (int i = 0; i < MessagesCount; ++i) {
+        model.addMessage(1000 + i,
+                         apps.at(i % apps.count()),
+                         100 + i % apps.count(),
+                         i % 2 ? QtWarningMsg : QtDebugMsg,
+                         u"org.kde.pim.akonadiserver"_s,
+                         u"/src/file%1.cpp"_s.arg(i % 7),
+                         u"foo()"_s,
+                         i,
+                         u"Zpráva č. %1 ✓"_s.arg(i));
+    }
+}
+
+QString saveCapture(const QTemporaryDir &dir, LoggingModel &model)
+{
+    LoggingFilterModel filter;
+    filter.setSourceModel(&model);
+    filter.setCheckedApps({u"akonadiserver"_s, u"akonadi_imap_resource"_s, u"kmail"_s});
+    filter.setCheckedCategories({u"org.kde.pim.akonadiserver"_s});
+    filter.setCheckedTypes({QtDebugMsg, QtWarningMsg});
+    filter.invalidate();
+    LogExportJob job(&filter, dir.filePath(u"log.aklog"_s), LogExportJob::Capture);
+    return TestUtils::runJob(job) ? job.fileName() : QString();
+}
+}
+
+LogCaptureLoaderBenchmark::LogCaptureLoaderBenchmark(QObject *parent)
+    : QObject(parent)
+{
+}
+
+LogCaptureLoaderBenchmark::~LogCaptureLoaderBenchmark() = default;
+
+void LogCaptureLoaderBenchmark::benchmarkLoadCapture()
+{
+    LoggingModel model;
+    fillModel(model);
+    QTemporaryDir dir;
+    const QString fileName = saveCapture(dir, model);
+    QVERIFY(!fileName.isEmpty());
+
+    LoggingModel loaded;
+    QBENCHMARK {
+        LogCaptureLoader loader(&loaded);
+        QVERIFY(TestUtils::load(loader, fileName));
+    }
+    QCOMPARE(loaded.store().count(), MessagesCount);
+}
+
+QTEST_GUILESS_MAIN(LogCaptureLoaderBenchmark)
+
+#include "moc_logcaptureloaderbenchmark.cpp"
@@ -0,0 +1,18 @@
+/*
+  SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+  SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <QObject>
+
+class LogCaptureLoaderBenchmark : public QObject
+{
+    Q_OBJECT
+public:
+    explicit LogCaptureLoaderBenchmark(QObject *parent = nullptr);
+    ~LogCaptureLoaderBenchmark() override;
+private Q_SLOTS:
+    void benchmarkLoadCapture();
+};
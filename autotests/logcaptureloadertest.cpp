@@ -0,0 +1,189 @@
+/*
+  SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+  SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "logcaptureloadertest.h"
+using namespace Qt::Literals::StringLiterals;
+
+#include "logcaptureloader.h"
+#include "logexportjob.h"
+#include "loggingfiltermodel.h"
+#include "loggingmodel.h"
+#include "testutils.h"
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+namespace
+{
+const QList<QtMsgType> AllTypes = {QtDebugMsg, QtInfoMsg, QtWarningMsg, QtCriticalMsg, QtFatalMsg};
+
+void fillModel(LoggingModel &model, int count)
+{
+    const QStringList apps = {u"akonadiserver"_s, u"akonadi_imap_resource"_s, u"kmail"_s};
+    for (int i = 0; i < count; ++i) {
+        model.addMessage(1000 + i,
+                         apps.at(i % apps.count()),
+                         100 + i % apps.count(),
+                         i % 2 ? QtWarningMsg : QtDebugMsg,
+                         i % 5 ? u"org.kde.pim.akonadiserver"_s : QString(),
+                         u"/src/file%1.cpp"_s.arg(i % 7),
+                         i % 3 ? u"foo()"_s : QString(),
+                         i,
+                         i % 4 ? u"Zpráva č. %1 ✓"_s.arg(i) : QString());
+    }
+}
+
+void showAll(LoggingFilterModel &filter, LoggingModel &model)
+{
+    filter.setSourceModel(&model);
+    filter.setCheckedApps({u"akonadiserver"_s, u"akonadi_imap_resource"_s, u"kmail"_s});
+    filter.setCheckedCategories({u"org.kde.pim.akonadiserver"_s, QString()});
+    filter.setCheckedTypes(AllTypes);
+    filter.invalidate();
+}
+
+QString saveCapture(const QTemporaryDir &dir, LoggingModel &model)
+{
+    LoggingFilterModel filter;
+    showAll(filter, model);
+    LogExportJob job(&filter, dir.filePath(u"log.aklog"_s), LogExportJob::Capture);
+    return TestUtils::runJob(job) ? job.fileName() : QString();
+}
+
+void writeFile(const QString &fileName, const QByteArray &content)
+{
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(content);
+}
+}
+
+LogCaptureLoaderTest::LogCaptureLoaderTest(QObject *parent)
+    : QObject(parent)
+{
+}
+
+LogCaptureLoaderTest::~LogCaptureLoaderTest() = default;
+
+void LogCaptureLoaderTest::shouldReloadCapture()
+{
+    LoggingModel model;
+    const int count = LogMessageStore::BlockSize + 100;
+    fillModel(model, count);
+
+    QTemporaryDir dir;
+    const QString fileName = saveCapture(dir, model);
+    QVERIFY(!fileName.isEmpty());
+
+    LoggingModel loaded;
+    // Loading replaces what was there
+    fillModel(loaded, 10);
+    LogCaptureLoader loader(&loaded);
+    QString errorString;
+    QVERIFY2(TestUtils::load(loader, fileName, &errorString), qPrintable(errorString));
+
+    const auto &expected = model.store();
+    const auto &actual = loaded.store();
+    QCOMPARE(actual.count(), count);
+    for (int row = 0; row < count; ++row) {
+        QCOMPARE(actual.timestamp(row), expected.timestamp(row));
+        QCOMPARE(actual.pid(row), expected.pid(row));
+        QCOMPARE(actual.type(row), expected.type(row));
+        QCOMPARE(actual.apps().at(actual.appId(row)), expected.apps().at(expected.appId(row)));
+        QCOMPARE(actual.categories().at(actual.categoryId(row)), expected.categories().at(expected.categoryId(row)));
+        QCOMPARE(actual.files().at(actual.fileId(row)), expected.files().at(expected.fileId(row)));
+        QCOMPARE(actual.functions().at(actual.functionId(row)), expected.functions().at(expected.functionId(row)));
+        QCOMPARE(actual.line(row), expected.line(row));
+        QCOMPARE(actual.text(row), expected.text(row));
+    }
+
+    LoggingFilterModel filter;
+    filter.setSourceModel(&loaded);
+    filter.setCheckedApps({u"kmail"_s});
+    filter.setCheckedCategories({u"org.kde.pim.akonadiserver"_s, QString()});
+    filter.setCheckedTypes(AllTypes);
+    filter.invalidate();
+    QCOMPARE(filter.rowCount(), (count + 1) / 3);
+}
+
+void LogCaptureLoaderTest::shouldLoadJsonLines()
+{
+    QTemporaryDir dir;
+    const QString fileName = dir.filePath(u"log.jsonl"_s);
+    writeFile(fileName,
+              "{\"timestamp\":1000,\"app\":\"akonadiserver\",\"pid\":10,\"type\":2,\"category\":\"org.kde.pim.akonadiserver\","
+              "\"file\":\"a.cpp\",\"function\":\"foo()\",\"line\":12,\"message\":\"Tab\\tquote\\\" \\u00e9\\ud83d\\ude00 ✓\"}\n"
+              "\n"
+              "  { \"message\" : \"Only a text\" , \"host\" : \"example\", \"level\": null }\r\n"
+              "{\"timestamp\":-5,\"app\":\"kmail\",\"type\":4}");
+
+    LoggingModel model;
+    LogCaptureLoader loader(&model);
+    QString errorString;
+    QVERIFY2(TestUtils::load(loader, fileName, &errorString), qPrintable(errorString));
+
+    const auto &store = model.store();
+    QCOMPARE(store.count(), 3);
+    QCOMPARE(store.timestamp(0), qint64(1000));
+    QCOMPARE(store.apps().at(store.appId(0)), u"akonadiserver"_s);
+    QCOMPARE(store.pid(0), qint64(10));
+    QCOMPARE(store.type(0), QtCriticalMsg);
+    QCOMPARE(store.categories().at(store.categoryId(0)), u"org.kde.pim.akonadiserver"_s);
+    QCOMPARE(store.files().at(store.fileId(0)), u"a.cpp"_s);
+    QCOMPARE(store.functions().at(store.functionId(0)), u"foo()"_s);
+    QCOMPARE(store.line(0), 12);
+    QCOMPARE(store.text(0), u"Tab\tquote\" é😀 ✓"_s);
+
+    QCOMPARE(store.text(1), u"Only a text"_s);
+    QCOMPARE(store.type(1), QtDebugMsg);
+    QCOMPARE(store.timestamp(2), qint64(-5));
+    QCOMPARE(store.type(2), QtInfoMsg);
+}
+
+void LogCaptureLoaderTest::shouldRejectDamagedCapture()
+{
+    LoggingModel model;
+    fillModel(model, 100);
+    QTemporaryDir dir;
+    const QString fileName = saveCapture(dir, model);
+    QVERIFY(!fileName.isEmpty());
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.resize(file.size() - 5));
+    file.close();
+
+    LoggingModel loaded;
+    LogCaptureLoader loader(&loaded);
+    QString errorString;
+    QVERIFY(!TestUtils::load(loader, fileName, &errorString));
+    QVERIFY(!errorString.isEmpty());
+    // The messages before the damage are kept
+    QCOMPARE(loaded.store().count(), 99);
+}
+
+void LogCaptureLoaderTest::shouldRejectInvalidJsonLine()
+{
+    QTemporaryDir dir;
+    const QString fileName = dir.filePath(u"log.jsonl"_s);
+    writeFile(fileName, "{\"message\":\"one\"}\n{\"message\":\"two\",\"type\":9}\n");
+
+    LoggingModel model;
+    LogCaptureLoader loader(&model);
+    QString errorString;
+    QVERIFY(!TestUtils::load(loader, fileName, &errorString));
+    QVERIFY2(errorString.contains(u"2"_s), qPrintable(errorString));
+    QCOMPARE(model.store().count(), 1);
+
+    writeFile(fileName, "Not a capture\n");
+    LogCaptureLoader textLoader(&model);
+    QVERIFY(!TestUtils::load(textLoader, fileName, &errorString));
+}
+
+QTEST_GUILESS_MAIN(LogCaptureLoaderTest)
+
+#include "moc_logcaptureloadertest.cpp"
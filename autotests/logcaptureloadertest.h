@@ -0,0 +1,21 @@
+/*
+  SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+  SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <QObject>
+
+class LogCaptureLoaderTest : public QObject
+{
+    Q_OBJECT
+public:
+    explicit LogCaptureLoaderTest(QObject *parent = nullptr);
+    ~LogCaptureLoaderTest() override;
+private Q_SLOTS:
+    void shouldReloadCapture();
+    void shouldLoadJsonLines();
+    void shouldRejectDamagedCapture();
+    void shouldRejectInvalidJsonLine();
+};
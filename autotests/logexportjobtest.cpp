@@ -0,0 +1,157 @@
+/*
+  SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+  SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "logexportjobtest.h"
+using namespace Qt::Literals::StringLiterals;
+
+#include "logexportjob.h"
+#include "loggingfiltermodel.h"
+#include "loggingmodel.h"
+#include "testutils.h"
+
+#include <KCompressionDevice>
+
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QTest>
+
+namespace
+{
+const QList<QtMsgType> AllTypes = {QtDebugMsg, QtInfoMsg, QtWarningMsg, QtCriticalMsg, QtFatalMsg};
+
+void fillModel(LoggingModel &model)
+{
+    // 2026-10-18T12:30:15.042Z
+    const qint64 timestamp = 1792326615042;
+    model.addMessage(timestamp, u"akonadiserver"_s, 10, QtDebugMsg, u"org.kde.pim.akonadiserver"_s, u"/src/a.cpp"_s, u"foo()"_s, 12, u"Starting"_s);
+    model.addMessage(timestamp + 1000, u"kmail"_s, 11, QtWarningMsg, QString(), QString(), QString(), 0, u"Tab\tquote\" ✓"_s);
+    model.addMessage(timestamp + 2000, u"akonadiserver"_s, 10, QtCriticalMsg, u"org.kde.pim.akonadiserver"_s, QString(), QString(), 0, u"Failed"_s);
+}
+
+void setUpFilter(LoggingFilterModel &filter, LoggingModel &model, const QStringList &apps)
+{
+    filter.setSourceModel(&model);
+    filter.setCheckedApps(apps);
+    filter.setCheckedCategories({u"org.kde.pim.akonadiserver"_s, QString()});
+    filter.setCheckedTypes(AllTypes);
+    filter.invalidate();
+}
+
+QByteArray readFile(const QString &fileName, LogExportJob::Format format)
+{
+    if (format == LogExportJob::CompressedJsonLines) {
+        KCompressionDevice file(fileName, KCompressionDevice::GZip);
+        return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+    }
+    QFile file(fileName);
+    return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+}
+
+LogExportJobTest::LogExportJobTest(QObject *parent)
+    : QObject(parent)
+{
+}
+
+LogExportJobTest::~LogExportJobTest() = default;
+
+void LogExportJobTest::shouldWriteFilteredText()
+{
+    LoggingModel model;
+    fillModel(model);
+    LoggingFilterModel filter;
+    setUpFilter(filter, model, {u"akonadiserver"_s});
+    QCOMPARE(filter.rowCount(), 2);
+
+    QTemporaryDir dir;
+    LogExportJob job(&filter, dir.filePath(u"log.txt"_s), LogExportJob::Text);
+    QVERIFY(TestUtils::runJob(job));
+
+    const QStringList lines = QString::fromUtf8(readFile(job.fileName(), LogExportJob::Text)).split(u'\n', Qt::SkipEmptyParts);
+    QCOMPARE(lines,
+             QStringList({u"[2026-10-18T12:30:15.042Z] akonadiserver org.kde.pim.akonadiserver foo(): Starting"_s,
+                          u"[2026-10-18T12:30:17.042Z] akonadiserver org.kde.pim.akonadiserver Failed"_s}));
+}
+
+void LogExportJobTest::shouldWriteJsonLines_data()
+{
+    QTest::addColumn<LogExportJob::Format>("format");
+    QTest::newRow("plain") << LogExportJob::JsonLines;
+    QTest::newRow("compressed") << LogExportJob::CompressedJsonLines;
+}
+
+void LogExportJobTest::shouldWriteJsonLines()
+{
+    QFETCH(LogExportJob::Format, format);
+
+    LoggingModel model;
+    fillModel(model);
+    LoggingFilterModel filter;
+    setUpFilter(filter, model, {u"akonadiserver"_s, u"kmail"_s});
+    QCOMPARE(filter.rowCount(), 3);
+
+    QTemporaryDir dir;
+    LogExportJob job(&filter, dir.filePath(u"log.jsonl"_s), format);
+    QVERIFY(TestUtils::runJob(job));
+
+    const QList<QByteArray> lines = readFile(job.fileName(), format).split('\n');
+    QCOMPARE(lines.count(), 4);
+    QVERIFY(lines.last().isEmpty());
+
+    QJsonParseError error;
+    const QJsonObject first = QJsonDocument::fromJson(lines.at(0), &error).object();
+    QCOMPARE(error.error, QJsonParseError::NoError);
+    QCOMPARE(first["timestamp"_L1].toInteger(), qint64(1792326615042));
+    QCOMPARE(first["app"_L1].toString(), u"akonadiserver"_s);
+    QCOMPARE(first["pid"_L1].toInteger(), qint64(10));
+    QCOMPARE(first["type"_L1].toInt(), int(QtDebugMsg));
+    QCOMPARE(first["category"_L1].toString(), u"org.kde.pim.akonadiserver"_s);
+    QCOMPARE(first["file"_L1].toString(), u"/src/a.cpp"_s);
+    QCOMPARE(first["function"_L1].toString(), u"foo()"_s);
+    QCOMPARE(first["line"_L1].toInt(), 12);
+    QCOMPARE(first["message"_L1].toString(), u"Starting"_s);
+
+    const QJsonObject second = QJsonDocument::fromJson(lines.at(1), &error).object();
+    QCOMPARE(error.error, QJsonParseError::NoError);
+    QCOMPARE(second["type"_L1].toInt(), int(QtWarningMsg));
+    QCOMPARE(second["message"_L1].toString(), u"Tab\tquote\" ✓"_s);
+}
+
+void LogExportJobTest::shouldExportSnapshot()
+{
+    LoggingModel model;
+    const int count = LogMessageStore::BlockSize + 10;
+    for (int i = 0; i < count; ++i) {
+        model.addMessage(i, u"app"_s, 1, QtDebugMsg, u"cat"_s, QString(), QString(), 0, QString::number(i));
+    }
+    LoggingFilterModel filter;
+    filter.setSourceModel(&model);
+    filter.setCheckedApps({u"app"_s});
+    filter.setCheckedCategories({u"cat"_s});
+    filter.setCheckedTypes(AllTypes);
+    filter.invalidate();
+
+    QTemporaryDir dir;
+    LogExportJob job(&filter, dir.filePath(u"log.jsonl"_s), LogExportJob::JsonLines);
+    // Messages arriving after the job was created are not part of the export,
+    // and filling the block being written must not change the exported one
+    for (int i = count; i < count + 100; ++i) {
+        model.addMessage(i, u"app"_s, 1, QtDebugMsg, u"cat"_s, QString(), QString(), 0, QString::number(i));
+    }
+    QVERIFY(TestUtils::runJob(job));
+
+    const QList<QByteArray> lines = readFile(job.fileName(), LogExportJob::JsonLines).split('\n');
+    QCOMPARE(lines.count(), count + 1);
+    for (int i = 0; i < count; i += 97) {
+        QCOMPARE(QJsonDocument::fromJson(lines.at(i)).object()["message"_L1].toString(), QString::number(i));
+    }
+}
+
+QTEST_GUILESS_MAIN(LogExportJobTest)
+
+#include "moc_logexportjobtest.cpp"
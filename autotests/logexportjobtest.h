@@ -0,0 +1,21 @@
+/*
+  SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+  SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <QObject>
+
+class LogExportJobTest : public QObject
+{
+    Q_OBJECT
+public:
+    explicit LogExportJobTest(QObject *parent = nullptr);
+    ~LogExportJobTest() override;
+private Q_SLOTS:
+    void shouldWriteFilteredText();
+    void shouldWriteJsonLines_data();
+    void shouldWriteJsonLines();
+    void shouldExportSnapshot();
+};
@@ -0,0 +1,141 @@
+/*
+  SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+  SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "loggingfiltermodeltest.h"
+using namespace Qt::Literals::StringLiterals;
+
+#include "loggingfiltermodel.h"
+#include "loggingmodel.h"
+#include "logsearchindex.h"
+
+#include <QSignalSpy>
+#include <QTest>
+
+namespace
+{
+const QList<QtMsgType> AllTypes = {QtDebugMsg, QtInfoMsg, QtWarningMsg, QtCriticalMsg, QtFatalMsg};
+
+void addMessages(LoggingModel &model, int count)
+{
+    const QStringList apps = {u"akonadiserver"_s, u"akonadi_imap_resource"_s, u"kmail"_s};
+    const QStringList categories = {u"org.kde.pim.akonadiserver"_s, u"org.kde.pim.imap"_s};
+    for (int i = 0; i < count; ++i) {
+        model.addMessage(i,
+                         apps.at(i % apps.count()),
+                         i % apps.count(),
+                         i % 2 ? QtWarningMsg : QtDebugMsg,
+                         categories.at(i % categories.count()),
+                         QString(),
+                         QString(),
+                         0,
+                         u"message"_s);
+    }
+}
+
+// Applies the pending filter change without waiting for the timer
+void refilter(LoggingFilterModel &filter)
+{
+    filter.invalidate();
+}
+}
+
+LoggingFilterModelTest::LoggingFilterModelTest(QObject *parent)
+    : QObject(parent)
+{
+}
+
+LoggingFilterModelTest::~LoggingFilterModelTest() = default;
+
+void LoggingFilterModelTest::shouldFilterByAppCategoryAndType()
+{
+    LoggingModel model;
+    addMessages(model, 12);
+    LoggingFilterModel filter;
+    filter.setSourceModel(&model);
+    filter.setCheckedApps({u"akonadiserver"_s, u"kmail"_s});
+    filter.setCheckedCategories({u"org.kde.pim.akonadiserver"_s, u"org.kde.pim.imap"_s});
+    filter.setCheckedTypes(AllTypes);
+    refilter(filter);
+    QCOMPARE(filter.rowCount(), 8);
+
+    filter.setCheckedTypes({QtWarningMsg});
+    refilter(filter);
+    QCOMPARE(filter.rowCount(), 4);
+
+    filter.setCheckedCategories({u"org.kde.pim.imap"_s});
+    refilter(filter);
+    QCOMPARE(filter.rowCount(), 4);
+    filter.setCheckedCategories({u"org.kde.pim.akonadiserver"_s});
+    refilter(filter);
+    QCOMPARE(filter.rowCount(), 0);
+}
+
+void LoggingFilterModelTest::shouldAcceptNewlyCheckedApps()
+{
+    LoggingModel model;
+    LoggingFilterModel filter;
+    filter.setSourceModel(&model);
+    // Checked before any message of the program arrived
+    filter.setCheckedApps({u"kmail"_s});
+    filter.setCheckedCategories({u"org.kde.pim.imap"_s});
+    filter.setCheckedTypes(AllTypes);
+    refilter(filter);
+
+    model.addMessage(1, u"kmail"_s, 1, QtDebugMsg, u"org.kde.pim.imap"_s, QString(), QString(), 0, u"one"_s);
+    model.addMessage(2, u"korganizer"_s, 2, QtDebugMsg, u"org.kde.pim.imap"_s, QString(), QString(), 0, u"two"_s);
+    QCOMPARE(filter.rowCount(), 1);
+    QCOMPARE(filter.index(0, LoggingModel::MessageColumn).data().toString(), u"one"_s);
+}
+
+void LoggingFilterModelTest::shouldForgetDroppedSearchResults()
+{
+    LoggingModel model;
+    model.setMaximumCount(2 * LogMessageStore::BlockSize);
+    addMessages(model, 2 * LogMessageStore::BlockSize);
+    LoggingFilterModel filter;
+    filter.setSourceModel(&model);
+    filter.setCheckedApps({u"akonadiserver"_s, u"akonadi_imap_resource"_s, u"kmail"_s});
+    filter.setCheckedCategories({u"org.kde.pim.akonadiserver"_s, u"org.kde.pim.imap"_s});
+    filter.setCheckedTypes(AllTypes);
+
+    QSignalSpy spy(model.searchIndex(), &LogSearchIndex::searchFinished);
+    filter.setSearchText(u"mess"_s);
+    QVERIFY(spy.wait());
+    QCOMPARE(filter.searchResultCount(), 2 * LogMessageStore::BlockSize);
+
+    // The oldest block goes, and its results with it
+    addMessages(model, LogMessageStore::BlockSize);
+    QCOMPARE(model.rowCount(), 2 * LogMessageStore::BlockSize);
+    QCOMPARE(filter.searchResultCount(), LogMessageStore::BlockSize);
+    QCOMPARE(filter.rowCount(), 2 * LogMessageStore::BlockSize);
+
+    model.clear();
+    QCOMPARE(filter.searchResultCount(), 0);
+}
+
+void LoggingFilterModelTest::benchmarkRefilter()
+{
+    LoggingModel model;
+    addMessages(model, 1'000'000);
+    LoggingFilterModel filter;
+    filter.setSourceModel(&model);
+    filter.setCheckedApps({u"akonadiserver"_s, u"akonadi_imap_resource"_s, u"kmail"_s});
+    filter.setCheckedCategories({u"org.kde.pim.akonadiserver"_s, u"org.kde.pim.imap"_s});
+    filter.setCheckedTypes(AllTypes);
+    refilter(filter);
+    QCOMPARE(filter.rowCount(), 1'000'000);
+
+    bool unchecked = false;
+    QBENCHMARK {
+        unchecked = !unchecked;
+        filter.setCheckedApps(unchecked ? QStringList{u"kmail"_s} : QStringList{u"akonadiserver"_s, u"akonadi_imap_resource"_s, u"kmail"_s});
+        refilter(filter);
+    }
+}
+
+QTEST_GUILESS_MAIN(LoggingFilterModelTest)
+
+#include "moc_loggingfiltermodeltest.cpp"
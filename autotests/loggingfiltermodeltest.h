@@ -0,0 +1,21 @@
+/*
+  SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+  SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <QObject>
+
+class LoggingFilterModelTest : public QObject
+{
+    Q_OBJECT
+public:
+    explicit LoggingFilterModelTest(QObject *parent = nullptr);
+    ~LoggingFilterModelTest() override;
+private Q_SLOTS:
+    void shouldFilterByAppCategoryAndType();
+    void shouldAcceptNewlyCheckedApps();
+    void shouldForgetDroppedSearchResults();
+    void benchmarkRefilter();
+};
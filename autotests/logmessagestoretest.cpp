@@ -0,0 +1,188 @@
+/*
+  SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+  SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "logmessagestoretest.h"
+using namespace Qt::Literals::StringLiterals;
+
+#include "loggingmodel.h"
+#include "logmessagestore.h"
+
+#include <QTest>
+
+namespace
+{
+void appendMessages(LogMessageStore &store, int first, int count)
+{
+    for (int i = first; i < first + count; ++i) {
+        store.append(i, u"app"_s, 1, QtDebugMsg, u"cat"_s, QString(), QString(), 0, QString::number(i));
+    }
+}
+}
+
+LogMessageStoreTest::LogMessageStoreTest(QObject *parent)
+    : QObject(parent)
+{
+}
+
+LogMessageStoreTest::~LogMessageStoreTest() = default;
+
+void LogMessageStoreTest::shouldInternStrings()
+{
+    LogMessageStore store;
+    store.append(1, u"akonadiserver"_s, 10, QtDebugMsg, u"org.kde.pim.akonadiserver"_s, u"/src/a.cpp"_s, u"foo()"_s, 1, u"one"_s);
+    store.append(2, u"akonadi_imap_resource"_s, 11, QtWarningMsg, u"org.kde.pim.imap"_s, u"/src/b.cpp"_s, u"bar()"_s, 2, u"two"_s);
+    store.append(3, u"akonadiserver"_s, 10, QtInfoMsg, u"org.kde.pim.akonadiserver"_s, u"/src/a.cpp"_s, u"foo()"_s, 3, u"three"_s);
+
+    QCOMPARE(store.count(), 3);
+    QCOMPARE(store.apps().count(), 2);
+    QCOMPARE(store.categories().count(), 2);
+    QCOMPARE(store.appId(0), store.appId(2));
+    QCOMPARE(store.apps().at(store.appId(1)), u"akonadi_imap_resource"_s);
+    QCOMPARE(store.apps().indexOf(u"akonadiserver"_s), store.appId(0));
+    QCOMPARE(store.apps().indexOf(u"kmail"_s), -1);
+    QCOMPARE(store.type(1), QtWarningMsg);
+    QCOMPARE(store.line(2), 3);
+
+    store.clear();
+    QCOMPARE(store.count(), 0);
+    QCOMPARE(store.apps().count(), 2);
+}
+
+void LogMessageStoreTest::shouldStoreMessagesAcrossBlocks()
+{
+    LogMessageStore store;
+    const int count = LogMessageStore::BlockSize * 2 + 10;
+    for (int i = 0; i < count; ++i) {
+        // Empty and non-ASCII texts must survive the UTF-8 arena as well
+        const QString text = i % 3 == 0 ? QString() : u"Zpráva č. %1 ✓"_s.arg(i);
+        store.append(i, u"app"_s, i, QtDebugMsg, u"cat"_s, QString(), QString(), 0, text);
+    }
+
+    QCOMPARE(store.count(), count);
+    for (int i = 0; i < count; ++i) {
+        QCOMPARE(store.timestamp(i), qint64(i));
+        QCOMPARE(store.pid(i), qint64(i));
+        QCOMPARE(store.text(i), i % 3 == 0 ? QString() : u"Zpráva č. %1 ✓"_s.arg(i));
+    }
+}
+
+void LogMessageStoreTest::shouldDropOldestBlocks()
+{
+    LogMessageStore store;
+    store.setCapacity(LogMessageStore::BlockSize * 2);
+    appendMessages(store, 0, LogMessageStore::BlockSize * 2);
+    QCOMPARE(store.excessBlocks(0), 0);
+    QCOMPARE(store.excessBlocks(1), 1);
+
+    store.dropFrontBlocks(store.excessBlocks(1));
+    appendMessages(store, LogMessageStore::BlockSize * 2, 1);
+    QCOMPARE(store.count(), LogMessageStore::BlockSize + 1);
+    QCOMPARE(store.timestamp(0), qint64(LogMessageStore::BlockSize));
+    QCOMPARE(store.text(store.count() - 1), QString::number(LogMessageStore::BlockSize * 2));
+    QCOMPARE(store.spilledCount(), 0);
+}
+
+void LogMessageStoreTest::shouldSpillAndRestoreBlocks()
+{
+    LogMessageStore store;
+    store.setSpillEnabled(true);
+    QVERIFY(store.isSpillEnabled());
+    store.setCapacity(LogMessageStore::BlockSize);
+    appendMessages(store, 0, LogMessageStore::BlockSize * 3);
+    store.dropFrontBlocks(store.excessBlocks(0));
+    QCOMPARE(store.count(), LogMessageStore::BlockSize);
+    QCOMPARE(store.spilledCount(), qint64(LogMessageStore::BlockSize * 2));
+
+    // The newest spilled block comes back first
+    QVERIFY(store.readSpilledBlock());
+    store.restoreSpilledBlock();
+    QCOMPARE(store.count(), LogMessageStore::BlockSize * 2);
+    QCOMPARE(store.timestamp(0), qint64(LogMessageStore::BlockSize));
+    QCOMPARE(store.text(0), QString::number(LogMessageStore::BlockSize));
+    QCOMPARE(store.spilledCount(), qint64(LogMessageStore::BlockSize));
+
+    // Restored messages may take as much room again as the capacity
+    QCOMPARE(store.excessBlocks(0), 0);
+    store.releaseRestoredBlocks();
+    QCOMPARE(store.excessBlocks(0), 1);
+    store.dropFrontBlocks(1);
+    QCOMPARE(store.spilledCount(), qint64(LogMessageStore::BlockSize * 2));
+    QVERIFY(store.readSpilledBlock());
+    store.restoreSpilledBlock();
+    QCOMPARE(store.timestamp(0), qint64(LogMessageStore::BlockSize));
+
+    store.setSpillEnabled(false);
+    QCOMPARE(store.spilledCount(), 0);
+}
+
+void LogMessageStoreTest::shouldDropRestoredBlocksPastTheLimit()
+{
+    LogMessageStore store;
+    store.setSpillEnabled(true);
+    store.setCapacity(LogMessageStore::BlockSize * 2);
+    appendMessages(store, 0, LogMessageStore::BlockSize * 4);
+    store.dropFrontBlocks(store.excessBlocks(0));
+    QCOMPARE(store.spilledCount(), qint64(LogMessageStore::BlockSize * 2));
+
+    for (int i = 0; i < 2; ++i) {
+        QVERIFY(store.readSpilledBlock());
+        store.restoreSpilledBlock();
+    }
+    QCOMPARE(store.count(), LogMessageStore::BlockSize * 4);
+    QCOMPARE(store.excessBlocks(0), 0);
+
+    // Messages keep arriving while the restored ones are looked at
+    QCOMPARE(store.excessBlocks(1), 1);
+    store.dropFrontBlocks(1);
+    appendMessages(store, LogMessageStore::BlockSize * 4, LogMessageStore::BlockSize);
+    QCOMPARE(store.timestamp(0), qint64(LogMessageStore::BlockSize));
+    QCOMPARE(store.spilledCount(), qint64(LogMessageStore::BlockSize));
+    QCOMPARE(store.excessBlocks(1), 1);
+    store.dropFrontBlocks(1);
+    QCOMPARE(store.spilledCount(), qint64(LogMessageStore::BlockSize * 2));
+
+    // Every restored block is gone, so the capacity applies again
+    QCOMPARE(store.count(), LogMessageStore::BlockSize * 3);
+    QCOMPARE(store.excessBlocks(0), 1);
+    // They went back to disk in order, the newest comes back first
+    QVERIFY(store.readSpilledBlock());
+    store.restoreSpilledBlock();
+    QCOMPARE(store.text(0), QString::number(LogMessageStore::BlockSize));
+}
+
+void LogMessageStoreTest::shouldStopLoadingSpilledAtTheLimit()
+{
+    LoggingModel model;
+    model.setSpillToDisk(true);
+    model.setMaximumCount(LogMessageStore::BlockSize);
+    for (int i = 0; i < LogMessageStore::BlockSize * 4; ++i) {
+        model.addMessage(i, u"app"_s, 1, QtDebugMsg, u"cat"_s, QString(), QString(), 0, QString::number(i));
+    }
+    QCOMPARE(model.rowCount(), LogMessageStore::BlockSize);
+    QCOMPARE(model.spilledCount(), qint64(LogMessageStore::BlockSize * 3));
+
+    QVERIFY(model.store().canRestoreBlock());
+    QVERIFY(model.loadSpilled());
+    QCOMPARE(model.rowCount(), LogMessageStore::BlockSize * 2);
+    QCOMPARE(model.store().text(0), QString::number(LogMessageStore::BlockSize * 2));
+
+    // Memory already holds twice the maximum, the rest of the history stays on disk
+    QVERIFY(!model.store().canRestoreBlock());
+    QVERIFY(!model.loadSpilled());
+    QCOMPARE(model.rowCount(), LogMessageStore::BlockSize * 2);
+    QCOMPARE(model.spilledCount(), qint64(LogMessageStore::BlockSize * 2));
+
+    // Once the restored block went back to disk it can be loaded again
+    model.unloadSpilled();
+    QCOMPARE(model.rowCount(), LogMessageStore::BlockSize);
+    QCOMPARE(model.spilledCount(), qint64(LogMessageStore::BlockSize * 3));
+    QVERIFY(model.loadSpilled());
+    QCOMPARE(model.store().text(0), QString::number(LogMessageStore::BlockSize * 2));
+}
+
+QTEST_GUILESS_MAIN(LogMessageStoreTest)
+
+#include "moc_logmessagestoretest.cpp"
@@ -0,0 +1,23 @@
+/*
+  SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+  SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <QObject>
+
+class LogMessageStoreTest : public QObject
+{
+    Q_OBJECT
+public:
+    explicit LogMessageStoreTest(QObject *parent = nullptr);
+    ~LogMessageStoreTest() override;
+private Q_SLOTS:
+    void shouldInternStrings();
+    void shouldStoreMessagesAcrossBlocks();
+    void shouldDropOldestBlocks();
+    void shouldSpillAndRestoreBlocks();
+    void shouldDropRestoredBlocksPastTheLimit();
+    void shouldStopLoadingSpilledAtTheLimit();
+};
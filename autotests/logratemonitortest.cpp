@@ -0,0 +1,106 @@
+/*
+  SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+  SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "logratemonitortest.h"
+
+#include "logratemonitor.h"
+
+#include <QTest>
+
+namespace
+{
+constexpr qint64 Start = 1'700'000'000'000;
+
+// Logs @p rate messages per second from app 0, category 1 for @p seconds
+qint64 log(LogRateMonitor &monitor, qint64 time, int seconds, int rate)
+{
+    for (int s = 0; s < seconds; ++s) {
+        for (int i = 0; i < rate; ++i) {
+            monitor.addMessage(time + i, 0, 1);
+        }
+        time += 1000;
+    }
+    return time;
+}
+}
+
+LogRateMonitorTest::LogRateMonitorTest(QObject *parent)
+    : QObject(parent)
+{
+}
+
+LogRateMonitorTest::~LogRateMonitorTest() = default;
+
+void LogRateMonitorTest::shouldCountPerSecond()
+{
+    LogRateMonitor monitor;
+    const qint64 time = log(monitor, Start, 3, 7);
+    monitor.addMessage(time, 0, 1);
+
+    QCOMPARE(monitor.seriesCount(LogRateMonitor::App), 1);
+    QCOMPARE(monitor.seriesCount(LogRateMonitor::Category), 2);
+    QCOMPARE(monitor.count(LogRateMonitor::App, 0, 0), 1U);
+    QCOMPARE(monitor.count(LogRateMonitor::App, 0, 1), 7U);
+    QCOMPARE(monitor.count(LogRateMonitor::Category, 1, 3), 7U);
+    QCOMPARE(monitor.count(LogRateMonitor::Category, 1, 4), 0U);
+    QCOMPARE(monitor.count(LogRateMonitor::Category, 0, 1), 0U);
+    QCOMPARE(monitor.maximumCount(), 7U);
+
+    // Late messages still count, as long as they are within the window
+    monitor.addMessage(time - 2000, 0, 1);
+    QCOMPARE(monitor.count(LogRateMonitor::App, 0, 2), 8U);
+    monitor.addMessage(time - LogRateMonitor::WindowSeconds * 1000, 0, 1);
+    QCOMPARE(monitor.maximumCount(), 8U);
+}
+
+void LogRateMonitorTest::shouldDetectBursts()
+{
+    LogRateMonitor monitor;
+    qint64 time = log(monitor, Start, LogRateMonitor::WarmUpSeconds * 2, 10);
+    QVERIFY(!monitor.isBursting(LogRateMonitor::App, 0));
+
+    time = log(monitor, time, 1, 200);
+    QVERIFY(monitor.isBursting(LogRateMonitor::App, 0));
+    QVERIFY(monitor.isBursting(LogRateMonitor::Category, 1));
+
+    monitor.advanceTo(time + LogRateMonitor::BurstHoldSeconds * 1000);
+    QVERIFY(!monitor.isBursting(LogRateMonitor::App, 0));
+}
+
+void LogRateMonitorTest::shouldDecayWhenIdle()
+{
+    LogRateMonitor monitor;
+    const qint64 time = log(monitor, Start, 30, 100);
+    monitor.advanceTo(time);
+    const double baseline = monitor.baseline(LogRateMonitor::App, 0);
+    QVERIFY(baseline > 50.0);
+
+    monitor.advanceTo(time + 120'000);
+    QVERIFY(monitor.baseline(LogRateMonitor::App, 0) < baseline / 100);
+    QCOMPARE(monitor.maximumCount(), 0U);
+
+    monitor.clear();
+    QCOMPARE(monitor.seriesCount(LogRateMonitor::App), 0);
+}
+
+void LogRateMonitorTest::shouldCountFromTheEpoch()
+{
+    // Synthetic captures can start right at the epoch, or even before it
+    LogRateMonitor monitor;
+    monitor.addMessage(-1500, 0, 1);
+    monitor.advanceTo(-1000);
+    QCOMPARE(monitor.seriesCount(LogRateMonitor::App), 0);
+
+    log(monitor, 0, 2, 3);
+    for (int secondsAgo = 0; secondsAgo < LogRateMonitor::WindowSeconds; ++secondsAgo) {
+        QCOMPARE(monitor.count(LogRateMonitor::App, 0, secondsAgo), secondsAgo < 2 ? 3U : 0U);
+    }
+    QCOMPARE(monitor.maximumCount(), 3U);
+}
+
+QTEST_GUILESS_MAIN(LogRateMonitorTest)
+
+#include "moc_logratemonitortest.cpp"
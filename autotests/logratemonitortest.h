@@ -0,0 +1,21 @@
+/*
+  SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+  SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <QObject>
+
+class LogRateMonitorTest : public QObject
+{
+    Q_OBJECT
+public:
+    explicit LogRateMonitorTest(QObject *parent = nullptr);
+    ~LogRateMonitorTest() override;
+private Q_SLOTS:
+    void shouldCountPerSecond();
+    void shouldDetectBursts();
+    void shouldDecayWhenIdle();
+    void shouldCountFromTheEpoch();
+};
@@ -0,0 +1,88 @@
+/*
+  SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+  SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "logsearchindextest.h"
+using namespace Qt::Literals::StringLiterals;
+
+#include "logmessagestore.h"
+#include "logsearchindex.h"
+
+#include <QSignalSpy>
+#include <QTest>
+
+namespace
+{
+QList<qint64> search(LogSearchIndex &index, const QString &text)
+{
+    QSignalSpy spy(&index, &LogSearchIndex::searchFinished);
+    const quint64 generation = index.search(text);
+    if (!spy.wait()) {
+        return {-1};
+    }
+    if (spy.at(0).at(0).value<quint64>() != generation) {
+        return {-2};
+    }
+    return spy.at(0).at(1).value<QList<qint64>>();
+}
+}
+
+LogSearchIndexTest::LogSearchIndexTest(QObject *parent)
+    : QObject(parent)
+{
+}
+
+LogSearchIndexTest::~LogSearchIndexTest() = default;
+
+void LogSearchIndexTest::shouldTokenize()
+{
+    QCOMPARE(LogSearchIndex::tokenize(u"Item fetch failed: ID 42, a"_s), QStringList({u"item"_s, u"fetch"_s, u"failed"_s, u"id"_s, u"42"_s}));
+    QVERIFY(LogSearchIndex::matches(u"Item fetch failed"_s, {u"fet"_s, u"it"_s}));
+    QVERIFY(!LogSearchIndex::matches(u"Item fetch failed"_s, {u"etch"_s}));
+}
+
+void LogSearchIndexTest::shouldFindMessages()
+{
+    LogSearchIndex index;
+    index.addMessage(0, u"Connection to IMAP server established"_s);
+    index.addMessage(1, u"Fetching items of collection 42"_s);
+    index.addMessage(2, u"IMAP fetch failed"_s);
+    index.addMessage(LogMessageStore::BlockSize + 1, u"Retrying IMAP fetch"_s);
+
+    QCOMPARE(search(index, u"imap"_s), QList<qint64>({0, 2, LogMessageStore::BlockSize + 1}));
+    QCOMPARE(search(index, u"IMAP fetch"_s), QList<qint64>({2, LogMessageStore::BlockSize + 1}));
+    QCOMPARE(search(index, u"fetch"_s), QList<qint64>({1, 2, LogMessageStore::BlockSize + 1}));
+    QCOMPARE(search(index, u"kmail"_s), QList<qint64>());
+}
+
+void LogSearchIndexTest::shouldReportNewMatches()
+{
+    LogSearchIndex index;
+    index.addMessage(0, u"IMAP fetch failed"_s);
+    QCOMPARE(search(index, u"fail"_s), QList<qint64>({0}));
+
+    QSignalSpy spy(&index, &LogSearchIndex::matchesAdded);
+    index.addMessage(1, u"Everything is fine"_s);
+    index.addMessage(2, u"Fetch failed again"_s);
+    QVERIFY(spy.wait());
+    QCOMPARE(spy.at(0).at(1).value<QList<qint64>>(), QList<qint64>({2}));
+    QCOMPARE(spy.at(0).at(2).value<qint64>(), 2);
+}
+
+void LogSearchIndexTest::shouldDropOldMessages()
+{
+    LogSearchIndex index;
+    index.addMessage(0, u"IMAP fetch failed"_s);
+    index.addMessage(LogMessageStore::BlockSize, u"IMAP fetch failed"_s);
+    index.dropBefore(LogMessageStore::BlockSize);
+    QCOMPARE(search(index, u"imap"_s), QList<qint64>({LogMessageStore::BlockSize}));
+
+    index.clear();
+    QCOMPARE(search(index, u"imap"_s), QList<qint64>());
+}
+
+QTEST_GUILESS_MAIN(LogSearchIndexTest)
+
+#include "moc_logsearchindextest.cpp"
@@ -0,0 +1,21 @@
+/*
+  SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+  SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <QObject>
+
+class LogSearchIndexTest : public QObject
+{
+    Q_OBJECT
+public:
+    explicit LogSearchIndexTest(QObject *parent = nullptr);
+    ~LogSearchIndexTest() override;
+private Q_SLOTS:
+    void shouldTokenize();
+    void shouldFindMessages();
+    void shouldReportNewMatches();
+    void shouldDropOldMessages();
+};
@@ -0,0 +1,70 @@
+/*
+  SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+  SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "protocoldecodertest.h"
+using namespace Qt::Literals::StringLiterals;
+
+#include "protocoldecoder.h"
+
+#include <QTest>
+
+ProtocolDecoderTest::ProtocolDecoderTest(QObject *parent)
+    : QObject(parent)
+{
+}
+
+ProtocolDecoderTest::~ProtocolDecoderTest() = default;
+
+void ProtocolDecoderTest::shouldDecodeJson()
+{
+    // Nested objects have their own type and tag, only the top level counts
+    const auto request = ProtocolDecoder::decode(
+        uR"({"scope": {"type": "Uid", "tag": 7}, "tag": 42, "type": "FetchItems", "response": false, "name": "a \"type\": \"X\""})"_s);
+    QCOMPARE(request.tag, qint64(42));
+    QCOMPARE(request.command, u"FetchItems"_s);
+    QVERIFY(!request.response);
+
+    const auto response = ProtocolDecoder::decode(u"{\n    \"response\": true,\n    \"tag\": 42,\n    \"type\": \"FetchItemsResponse\"\n}\n"_s);
+    QCOMPARE(response.tag, qint64(42));
+    QCOMPARE(response.command, u"FetchItems"_s);
+    QVERIFY(response.response);
+
+    const auto untagged = ProtocolDecoder::decode(u"{\"items\": [{\"tag\": 1}]}"_s);
+    QCOMPARE(untagged.tag, qint64(-1));
+    QVERIFY(untagged.command.isEmpty());
+}
+
+void ProtocolDecoderTest::shouldDecodeText()
+{
+    const auto request = ProtocolDecoder::decode(u"12 LoginCommand session"_s);
+    QCOMPARE(request.tag, qint64(12));
+    QCOMPARE(request.command, u"Login"_s);
+    QVERIFY(!request.response);
+
+    const auto response = ProtocolDecoder::decode(u"  12 LoginResponse"_s);
+    QCOMPARE(response.tag, qint64(12));
+    QCOMPARE(response.command, u"Login"_s);
+    QVERIFY(response.response);
+
+    const auto untagged = ProtocolDecoder::decode(u"Hello"_s);
+    QCOMPARE(untagged.tag, qint64(-1));
+    QCOMPARE(untagged.command, u"Hello"_s);
+
+    const auto tagOnly = ProtocolDecoder::decode(u"3"_s);
+    QCOMPARE(tagOnly.tag, qint64(3));
+    QVERIFY(tagOnly.command.isEmpty());
+}
+
+void ProtocolDecoderTest::shouldMeasureUtf8Size()
+{
+    QCOMPARE(ProtocolDecoder::decode(u"1 OK"_s).size, qint64(4));
+    const QString text = u"1 Grüße € \U0001F600"_s;
+    QCOMPARE(ProtocolDecoder::decode(text).size, qint64(text.toUtf8().size()));
+}
+
+QTEST_GUILESS_MAIN(ProtocolDecoderTest)
+
+#include "moc_protocoldecodertest.cpp"
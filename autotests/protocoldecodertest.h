@@ -0,0 +1,20 @@
+/*
+  SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+  SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <QObject>
+
+class ProtocolDecoderTest : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ProtocolDecoderTest(QObject *parent = nullptr);
+    ~ProtocolDecoderTest() override;
+private Q_SLOTS:
+    void shouldDecodeJson();
+    void shouldDecodeText();
+    void shouldMeasureUtf8Size();
+};
@@ -0,0 +1,162 @@
+/*
+  SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+  SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "querycapturefiltertest.h"
+using namespace Qt::Literals::StringLiterals;
+
+#include "querycapturefilter.h"
+
+#include <QTest>
+
+#include <algorithm>
+
+QueryCaptureFilterTest::QueryCaptureFilterTest(QObject *parent)
+    : QObject(parent)
+{
+}
+
+QueryCaptureFilterTest::~QueryCaptureFilterTest() = default;
+
+void QueryCaptureFilterTest::shouldCaptureEverythingByDefault()
+{
+    QueryCaptureFilter filter;
+    QCOMPARE(filter.mode(), QueryCaptureFilter::CaptureAll);
+    QVERIFY(filter.accept(u"SELECT 1"_s, 0, QString()));
+    QVERIFY(filter.accept(u"SELECT 1"_s, 1000, QString()));
+}
+
+void QueryCaptureFilterTest::shouldCaptureSlowQueries()
+{
+    QueryCaptureFilter filter;
+    filter.setMode(QueryCaptureFilter::CaptureSlowerThan);
+    filter.setThreshold(50);
+    QVERIFY(!filter.accept(u"SELECT 1"_s, 49, QString()));
+    QVERIFY(filter.accept(u"SELECT 1"_s, 50, QString()));
+    QVERIFY(filter.accept(u"SELECT 1"_s, 500, QString()));
+}
+
+void QueryCaptureFilterTest::shouldCaptureTopSlowestPerQuery()
+{
+    QueryCaptureFilter filter;
+    filter.setMode(QueryCaptureFilter::CaptureTopSlowest);
+    filter.setTopCount(2);
+    const QString parts = u"SELECT * FROM parts WHERE id = 1"_s;
+    const QString flags = u"SELECT * FROM flags"_s;
+
+    // The first calls of each query always fill up the top list
+    QVERIFY(filter.accept(parts, 10, QString()));
+    QVERIFY(filter.accept(parts, 20, QString()));
+    QVERIFY(filter.accept(flags, 1, QString()));
+
+    QVERIFY(!filter.accept(parts, 5, QString()));
+    QVERIFY(!filter.accept(parts, 10, QString()));
+    QVERIFY(filter.accept(parts, 15, QString()));
+    // 10 was replaced by 15, the slowest two are now 15 and 20
+    QVERIFY(!filter.accept(parts, 12, QString()));
+    QVERIFY(filter.accept(flags, 2, QString()));
+    // Calls of the same statement with other literals share the top list
+    QVERIFY(!filter.accept(u"SELECT * FROM parts WHERE id = 42"_s, 14, QString()));
+
+    filter.reset();
+    QVERIFY(filter.accept(parts, 1, QString()));
+}
+
+void QueryCaptureFilterTest::shouldEvictDisplacedCalls()
+{
+    QueryCaptureFilter filter;
+    filter.setMode(QueryCaptureFilter::CaptureTopSlowest);
+    filter.setTopCount(2);
+    const QString query = u"SELECT * FROM pimitemtable WHERE id IN (?, ?)"_s;
+
+    QVERIFY(filter.accept(query, 10, QString()));
+    const quint64 first = filter.lastSerial();
+    QVERIFY(first != 0);
+    QVERIFY(filter.accept(u"SELECT * FROM pimitemtable WHERE id IN (?, ?, ?)"_s, 20, QString()));
+    const quint64 second = filter.lastSerial();
+    QVERIFY(second > first);
+    QVERIFY(filter.takeEvicted().isEmpty());
+
+    QVERIFY(!filter.accept(query, 5, QString()));
+    QCOMPARE(filter.lastSerial(), quint64(0));
+    QVERIFY(filter.takeEvicted().isEmpty());
+
+    QVERIFY(filter.accept(query, 15, QString()));
+    const quint64 third = filter.lastSerial();
+    QVERIFY(third > second);
+    QCOMPARE(filter.takeEvicted(), QList<quint64>{first});
+    QVERIFY(filter.takeEvicted().isEmpty());
+
+    // Errors are kept without taking a place in the top list
+    QVERIFY(filter.accept(query, 1, u"Deadlock found"_s));
+    QCOMPARE(filter.lastSerial(), quint64(0));
+    QVERIFY(filter.takeEvicted().isEmpty());
+
+    // Nothing bounds the kept calls once the top count or the mode changes
+    filter.setTopCount(3);
+    QList<quint64> evicted = filter.takeEvicted();
+    std::sort(evicted.begin(), evicted.end());
+    QCOMPARE(evicted, QList<quint64>({second, third}));
+    QVERIFY(filter.accept(query, 1, QString()));
+    const quint64 fourth = filter.lastSerial();
+    filter.setMode(QueryCaptureFilter::CaptureAll);
+    QCOMPARE(filter.takeEvicted(), QList<quint64>{fourth});
+}
+
+void QueryCaptureFilterTest::shouldLimitFingerprints()
+{
+    QueryCaptureFilter filter;
+    filter.setMode(QueryCaptureFilter::CaptureTopSlowest);
+    filter.setTopCount(1);
+
+    QList<quint64> serials;
+    for (int i = 0; i < QueryCaptureFilter::MaximumFingerprints; ++i) {
+        QVERIFY(filter.accept(u"SELECT * FROM table%1"_s.arg(i), 1000 + i, QString()));
+        serials << filter.lastSerial();
+    }
+    QVERIFY(filter.takeEvicted().isEmpty());
+
+    // The fingerprint whose slowest call is the fastest of all makes room
+    QVERIFY(filter.accept(u"SELECT * FROM another"_s, 5000, QString()));
+    QCOMPARE(filter.takeEvicted(), QList<quint64>{serials.at(0)});
+    QVERIFY(filter.accept(u"SELECT * FROM yetanother"_s, 1, QString()));
+    QCOMPARE(filter.takeEvicted(), QList<quint64>{serials.at(1)});
+}
+
+void QueryCaptureFilterTest::shouldFingerprintQueries_data()
+{
+    QTest::addColumn<QString>("query");
+    QTest::addColumn<QString>("fingerprint");
+
+    QTest::newRow("plain") << u"SELECT * FROM flagtable"_s << u"SELECT * FROM flagtable"_s;
+    QTest::newRow("whitespace") << u"  SELECT *\n  FROM\tflagtable  "_s << u"SELECT * FROM flagtable"_s;
+    QTest::newRow("literals") << u"SELECT * FROM t WHERE a = 12 AND b = 'it''s' AND c = 1.5"_s << u"SELECT * FROM t WHERE a = ? AND b = ? AND c = ?"_s;
+    QTest::newRow("identifiers with digits") << u"SELECT t1.id FROM t1"_s << u"SELECT t1.id FROM t1"_s;
+    QTest::newRow("placeholder list") << u"SELECT * FROM t WHERE id IN (?, ?, ?, ?)"_s << u"SELECT * FROM t WHERE id IN (?)"_s;
+    QTest::newRow("compact placeholder list") << u"SELECT * FROM t WHERE id IN (?,?)"_s << u"SELECT * FROM t WHERE id IN (?)"_s;
+    QTest::newRow("named placeholders") << u"SELECT * FROM t WHERE id IN (:0, :1, :2) AND a = :3"_s << u"SELECT * FROM t WHERE id IN (?) AND a = ?"_s;
+    QTest::newRow("separate placeholders") << u"UPDATE t SET a = ?, b = ? WHERE id = ?"_s << u"UPDATE t SET a = ?, b = ? WHERE id = ?"_s;
+    QTest::newRow("cast") << u"SELECT a::text FROM t"_s << u"SELECT a::text FROM t"_s;
+}
+
+void QueryCaptureFilterTest::shouldFingerprintQueries()
+{
+    QFETCH(QString, query);
+    QFETCH(QString, fingerprint);
+    QCOMPARE(QueryCaptureFilter::fingerprint(query), fingerprint);
+}
+
+void QueryCaptureFilterTest::shouldAlwaysCaptureErrors()
+{
+    QueryCaptureFilter filter;
+    filter.setMode(QueryCaptureFilter::CaptureSlowerThan);
+    filter.setThreshold(1000);
+    QVERIFY(!filter.accept(u"SELECT 1"_s, 1, u" "_s));
+    QVERIFY(filter.accept(u"SELECT 1"_s, 1, u"Deadlock found"_s));
+}
+
+QTEST_GUILESS_MAIN(QueryCaptureFilterTest)
+
+#include "moc_querycapturefiltertest.cpp"
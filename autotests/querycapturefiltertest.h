@@ -0,0 +1,25 @@
+/*
+  SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+  SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <QObject>
+
+class QueryCaptureFilterTest : public QObject
+{
+    Q_OBJECT
+public:
+    explicit QueryCaptureFilterTest(QObject *parent = nullptr);
+    ~QueryCaptureFilterTest() override;
+private Q_SLOTS:
+    void shouldCaptureEverythingByDefault();
+    void shouldCaptureSlowQueries();
+    void shouldCaptureTopSlowestPerQuery();
+    void shouldAlwaysCaptureErrors();
+    void shouldEvictDisplacedCalls();
+    void shouldLimitFingerprints();
+    void shouldFingerprintQueries_data();
+    void shouldFingerprintQueries();
+};
@@ -0,0 +1,96 @@
+/*
+  SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+  SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "querytreeexportjobtest.h"
+using namespace Qt::Literals::StringLiterals;
+
+#include "querytreeexportjob.h"
+#include "querytreemodel.h"
+#include "testutils.h"
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+namespace
+{
+void fillModel(QueryTreeModel &model)
+{
+    model.addConnection(1, u"con1"_s, 1000);
+    model.addQuery(1, 1001, 2, u"SELECT 1"_s, {}, 1, {{u"col"_s}, {1}}, QString());
+    model.addTransaction(1, u"trx"_s, 1010, 0, QString());
+    model.addQuery(1, 1011, 3, u"UPDATE foo SET bar = ?"_s, {{u":0"_s, 42}}, 1, {}, QString());
+    model.closeTransaction(1, false, 1020, 0, u"Deadlock"_s);
+    model.addConnection(2, u"con2"_s, 2000);
+    model.addTransaction(2, u"open"_s, 2001, 0, QString());
+}
+}
+
+QueryTreeExportJobTest::QueryTreeExportJobTest(QObject *parent)
+    : QObject(parent)
+{
+}
+
+QueryTreeExportJobTest::~QueryTreeExportJobTest() = default;
+
+void QueryTreeExportJobTest::shouldWriteText()
+{
+    QueryTreeModel model;
+    fillModel(model);
+
+    QTemporaryDir dir;
+    QueryTreeExportJob job(&model, dir.filePath(u"tree.txt"_s), QueryTreeExportJob::Text);
+    QVERIFY(TestUtils::runJob(job));
+
+    QFile file(job.fileName());
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QStringList lines = QString::fromUtf8(file.readAll()).split(u'\n', Qt::SkipEmptyParts);
+    QCOMPARE(lines.count(), 7);
+    QVERIFY(lines.at(0).startsWith(u"  |- con1"_s));
+    QVERIFY(lines.at(1).startsWith(u"  |  |- SELECT 1"_s));
+    QVERIFY(lines.at(2).startsWith(u"  |  |- ROLLBACK trx"_s));
+    QCOMPARE(lines.at(3), u"  |  |  Error: Deadlock"_s);
+    QVERIFY(lines.at(4).startsWith(u"  |  |  |- UPDATE foo"_s));
+    QVERIFY(lines.at(5).startsWith(u"  |- con2"_s));
+    QVERIFY(lines.at(6).startsWith(u"  |  |- BEGIN open"_s));
+}
+
+void QueryTreeExportJobTest::shouldReloadJsonLines()
+{
+    QueryTreeModel model;
+    fillModel(model);
+
+    QTemporaryDir dir;
+    QueryTreeExportJob job(&model, dir.filePath(u"tree.jsonl"_s), QueryTreeExportJob::JsonLines);
+    QVERIFY(TestUtils::runJob(job));
+
+    QueryTreeModel reloaded;
+    QFile file(job.fileName());
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QString errorString;
+    QVERIFY2(QueryTreeExportJob::load(&file, &reloaded, &errorString), qPrintable(errorString));
+
+    const auto expected = model.snapshot();
+    const auto actual = reloaded.snapshot();
+    QCOMPARE(actual.count(), expected.count());
+    for (int i = 0; i < expected.count(); ++i) {
+        QCOMPARE(actual.at(i).type, expected.at(i).type);
+        QCOMPARE(actual.at(i).connectionId, expected.at(i).connectionId);
+        QCOMPARE(actual.at(i).name, expected.at(i).name);
+        QCOMPARE(actual.at(i).start, expected.at(i).start);
+        QCOMPARE(actual.at(i).duration, expected.at(i).duration);
+        QCOMPARE(actual.at(i).transactionState, expected.at(i).transactionState);
+        QCOMPARE(actual.at(i).inTransaction, expected.at(i).inTransaction);
+        QCOMPARE(actual.at(i).error, expected.at(i).error);
+        QCOMPARE(actual.at(i).resultsCount, expected.at(i).resultsCount);
+    }
+    QCOMPARE(actual.at(1).results.count(), 2);
+    QCOMPARE(actual.at(3).values.value(u":0"_s).toInt(), 42);
+}
+
+QTEST_GUILESS_MAIN(QueryTreeExportJobTest)
+
+#include "moc_querytreeexportjobtest.cpp"
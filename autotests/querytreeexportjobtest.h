@@ -0,0 +1,19 @@
+/*
+  SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+  SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <QObject>
+
+class QueryTreeExportJobTest : public QObject
+{
+    Q_OBJECT
+public:
+    explicit QueryTreeExportJobTest(QObject *parent = nullptr);
+    ~QueryTreeExportJobTest() override;
+private Q_SLOTS:
+    void shouldWriteText();
+    void shouldReloadJsonLines();
+};
@@ -0,0 +1,94 @@
+/*
+  SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+  SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "querytreemodelbenchmark.h"
+using namespace Qt::Literals::StringLiterals;
+
+#include "querytreemodel.h"
+
+#include <QTest>
+
+namespace
+{
+constexpr int ConnectionsCount = 10;
+constexpr int TransactionsPerConnection = 1000;
+constexpr int QueriesPerTransaction = 100;
+
+int walk(const QAbstractItemModel *model, const QModelIndex &parent)
+{
+    int visited = 0;
+    for (int row = 0, count = model->rowCount(parent); row < count; ++row) {
+        const QModelIndex idx = model->index(row, 0, parent);
+        // Views resolve the parent of every index they paint
+        if (model->parent(idx) != parent) {
+            return -1;
+        }
+        const int children = walk(model, idx);
+        if (children < 0) {
+            return -1;
+        }
+        visited += 1 + children;
+    }
+    return visited;
+}
+}
+
+QueryTreeModelBenchmark::QueryTreeModelBenchmark(QObject *parent)
+    : QObject(parent)
+{
+}
+
+QueryTreeModelBenchmark::~QueryTreeModelBenchmark() = default;
+
+void QueryTreeModelBenchmark::benchmarkInsertion()
+{
+    mModel = new QueryTreeModel(this);
+    const QString query = u"SELECT id, name FROM PimItemTable WHERE collectionId = ?"_s;
+    const QMap<QString, QVariant> values = {{u":0"_s, 42}};
+
+    QBENCHMARK_ONCE {
+        qint64 timestamp = 0;
+        for (int con = 0; con < ConnectionsCount; ++con) {
+            mModel->addConnection(con, u"Connection %1"_s.arg(con), timestamp);
+            for (int trx = 0; trx < TransactionsPerConnection; ++trx) {
+                mModel->addTransaction(con, u"Transaction %1"_s.arg(trx), ++timestamp, 0, QString());
+                for (int q = 0; q < QueriesPerTransaction; ++q) {
+                    mModel->addQuery(con, ++timestamp, 1, query, values, 1, {}, QString());
+                }
+                mModel->closeTransaction(con, true, ++timestamp, 0, QString());
+            }
+        }
+    }
+
+    QCOMPARE(mModel->rowCount(), ConnectionsCount);
+}
+
+void QueryTreeModelBenchmark::benchmarkTraversal()
+{
+    QVERIFY(mModel);
+
+    int visited = 0;
+    QBENCHMARK {
+        visited = walk(mModel, QModelIndex());
+    }
+
+    QCOMPARE(visited, ConnectionsCount * (1 + TransactionsPerConnection * (1 + QueriesPerTransaction)));
+}
+
+void QueryTreeModelBenchmark::benchmarkClear()
+{
+    QVERIFY(mModel);
+
+    QBENCHMARK_ONCE {
+        mModel->clear();
+    }
+
+    QCOMPARE(mModel->rowCount(), 0);
+}
+
+QTEST_GUILESS_MAIN(QueryTreeModelBenchmark)
+
+#include "moc_querytreemodelbenchmark.cpp"
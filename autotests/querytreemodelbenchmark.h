@@ -0,0 +1,25 @@
+/*
+  SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+  SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <QObject>
+
+class QueryTreeModel;
+
+class QueryTreeModelBenchmark : public QObject
+{
+    Q_OBJECT
+public:
+    explicit QueryTreeModelBenchmark(QObject *parent = nullptr);
+    ~QueryTreeModelBenchmark() override;
+private Q_SLOTS:
+    void benchmarkInsertion();
+    void benchmarkTraversal();
+    void benchmarkClear();
+
+private:
+    QueryTreeModel *mModel = nullptr;
+};
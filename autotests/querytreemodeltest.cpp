@@ -0,0 +1,218 @@
+/*
+  SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+  SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "querytreemodeltest.h"
+using namespace Qt::Literals::StringLiterals;
+
+#include "querytreemodel.h"
+
+#include <QSignalSpy>
+#include <QTest>
+
+#include <algorithm>
+
+QueryTreeModelTest::QueryTreeModelTest(QObject *parent)
+    : QObject(parent)
+{
+}
+
+QueryTreeModelTest::~QueryTreeModelTest() = default;
+
+void QueryTreeModelTest::shouldShowQueriesAndTransactions()
+{
+    QueryTreeModel model;
+    model.addConnection(1, u"con1"_s, 1000);
+    model.addQuery(1, 1000, 5, u"SELECT 1"_s, {}, 0, {}, QString());
+    model.addTransaction(1, u"trx"_s, 1010, 0, QString());
+    const QMap<QString, QVariant> values = {{u":0"_s, 42}};
+    const QList<QList<QVariant>> results = {{1, u"a"_s}, {2, u"b"_s}};
+    model.addQuery(1, 1011, 2, u"SELECT * FROM parts WHERE id = :0"_s, values, 2, results, QString());
+    model.addQuery(1, 1013, 1, u"SELECT * FROM parts WHERE id = :0"_s, values, 0, {}, u" Lock wait timeout "_s);
+    model.closeTransaction(1, false, 1020, 0, u"Rolled back"_s);
+
+    const QModelIndex con = model.index(0, 0);
+    QCOMPARE(model.rowCount(con), 2);
+    const QModelIndex plain = model.index(0, 0, con);
+    QCOMPARE(plain.data().toString(), u"SELECT 1"_s);
+    QCOMPARE(plain.data(QueryTreeModel::QueryValuesRole).toMap(), QVariantMap());
+    QCOMPARE(plain.data(QueryTreeModel::QueryResultsRole).value<QList<QList<QVariant>>>(), QList<QList<QVariant>>());
+    QVERIFY(!plain.sibling(0, 4).data(Qt::BackgroundRole).isValid());
+
+    const QModelIndex trx = model.index(1, 0, con);
+    QCOMPARE(trx.data(QueryTreeModel::RowTypeRole).toInt(), int(QueryTreeModel::Transaction));
+    QCOMPARE(trx.data().toString(), u"ROLLBACK trx"_s);
+    QCOMPARE(trx.data(QueryTreeModel::QueryRole).toString(), u"trx"_s);
+    QCOMPARE(trx.sibling(1, 3).data().toString(), u"00:00:00.010"_s);
+    QCOMPARE(trx.sibling(1, 4).data().toString(), u"Rolled back"_s);
+
+    // Both executions show the same statement, each with its own details
+    QCOMPARE(model.rowCount(trx), 2);
+    const QModelIndex fetch = model.index(0, 0, trx);
+    QCOMPARE(fetch.data(QueryTreeModel::QueryRole).toString(), u"SELECT * FROM parts WHERE id = :0"_s);
+    QCOMPARE(fetch.data(QueryTreeModel::QueryValuesRole).toMap(), values);
+    QCOMPARE(fetch.data(QueryTreeModel::QueryResultsCountRole).toInt(), 2);
+    QCOMPARE(fetch.data(QueryTreeModel::QueryResultsRole).value<QList<QList<QVariant>>>(), results);
+    const QModelIndex failed = model.index(1, 0, trx);
+    QCOMPARE(failed.data().toString(), fetch.data().toString());
+    QCOMPARE(failed.sibling(1, 4).data().toString(), u"Lock wait timeout"_s);
+    QVERIFY(failed.sibling(1, 4).data(Qt::BackgroundRole).isValid());
+
+    const auto rows = model.snapshot();
+    QCOMPARE(rows.count(), 5);
+    QCOMPARE(rows.at(2).type, QueryTreeModel::Transaction);
+    QCOMPARE(rows.at(2).name, u"trx"_s);
+    QCOMPARE(rows.at(2).transactionState, QueryTreeModel::TransactionRolledBack);
+    QCOMPARE(rows.at(2).error, u"Rolled back"_s);
+    QCOMPARE(rows.at(3).values, values);
+    QCOMPARE(rows.at(3).results, results);
+    QVERIFY(rows.at(3).inTransaction);
+    QCOMPARE(rows.at(4).name, u"SELECT * FROM parts WHERE id = :0"_s);
+    QCOMPARE(rows.at(4).error, u"Lock wait timeout"_s);
+}
+
+void QueryTreeModelTest::shouldDetectRepeatedQueries()
+{
+    QueryTreeModel model;
+    QSignalSpy spy(&model, &QueryTreeModel::repeatedQueriesChanged);
+    model.addConnection(1, u"con1"_s, 1000);
+    model.addTransaction(1, u"trx"_s, 1000, 0, QString());
+    model.addQuery(1, 1001, 1, u"SELECT 1"_s, {}, 0, {}, QString());
+    // Each parent fetched on its own, interleaved with an unrelated statement
+    for (int i = 0; i < 10; ++i) {
+        model.addQuery(1, 1002 + i, 2, u"SELECT * FROM parts WHERE id = :0"_s, {{u":0"_s, i}}, 1, {}, QString());
+        model.addQuery(1, 1002 + i, 1, u"SELECT * FROM flags WHERE id = :0"_s, {{u":0"_s, i}}, 1, {}, QString());
+    }
+    QVERIFY(!spy.isEmpty());
+
+    const auto repeated = model.repeatedQueries(10);
+    QCOMPARE(repeated.count(), 2);
+    QCOMPARE(repeated.at(0).query, u"SELECT * FROM parts WHERE id = :0"_s);
+    QCOMPARE(repeated.at(0).count, 10);
+    QCOMPARE(repeated.at(0).duration, 20U);
+    QCOMPARE(repeated.at(0).connectionName, u"con1"_s);
+    QCOMPARE(repeated.at(0).transactionName, u"trx"_s);
+    QCOMPARE(repeated.at(0).first.row(), 1);
+    QVERIFY(!repeated.at(0).first.sibling(1, QueryTreeModel::RepeatedColumn).data().toString().isEmpty());
+    QVERIFY(repeated.at(0).first.sibling(3, QueryTreeModel::RepeatedColumn).data().toString().isEmpty());
+
+    model.clear();
+    QVERIFY(model.repeatedQueries(10).isEmpty());
+}
+
+void QueryTreeModelTest::shouldIgnoreDistantRepeats()
+{
+    QueryTreeModel model;
+    model.addConnection(1, u"con1"_s, 1000);
+    for (int i = 0; i < 10; ++i) {
+        model.addQuery(1, 1000, 1, u"SELECT 1"_s, {}, 0, {}, QString());
+        for (int j = 0; j <= QueryTreeModel::RepeatWindow; ++j) {
+            model.addQuery(1, 1000, 1, u"SELECT %1"_s.arg(i * 10 + j + 2), {}, 0, {}, QString());
+        }
+    }
+    QVERIFY(model.repeatedQueries(10).isEmpty());
+
+    // Queries in different transactions are not a run either
+    for (int i = 0; i < 10; ++i) {
+        model.addTransaction(1, u"trx"_s, 1000, 0, QString());
+        model.addQuery(1, 1000, 1, u"SELECT 1"_s, {}, 0, {}, QString());
+        model.closeTransaction(1, true, 1000, 0, QString());
+    }
+    QVERIFY(model.repeatedQueries(10).isEmpty());
+}
+
+void QueryTreeModelTest::shouldRemoveConnections()
+{
+    QueryTreeModel model;
+    for (qint64 id = 1; id <= 3; ++id) {
+        model.addConnection(id, u"con%1"_s.arg(id), 1000);
+        for (int i = 0; i < QueryTreeModel::RepeatThreshold; ++i) {
+            model.addQuery(id, 1000 + i, 1, u"SELECT %1"_s.arg(id), {}, 0, {}, QString());
+        }
+    }
+    QCOMPARE(model.repeatedQueries(10).count(), 3);
+
+    QSignalSpy removedSpy(&model, &QAbstractItemModel::rowsRemoved);
+    QSignalSpy repeatedSpy(&model, &QueryTreeModel::repeatedQueriesChanged);
+    const QPersistentModelIndex lastQuery = model.index(0, 0, model.index(2, 0));
+    model.removeConnection(2);
+    QCOMPARE(removedSpy.count(), 1);
+    QCOMPARE(repeatedSpy.count(), 1);
+    QCOMPARE(model.rowCount(), 2);
+    QCOMPARE(model.index(1, 0).data().toString(), u"con3"_s);
+    QCOMPARE(model.parent(lastQuery), model.index(1, 0));
+    QCOMPARE(lastQuery.data().toString(), u"SELECT 3"_s);
+    const auto repeated = model.repeatedQueries(10);
+    QCOMPARE(repeated.count(), 2);
+    QVERIFY(std::none_of(repeated.cbegin(), repeated.cend(), [](const QueryTreeModel::RepeatedQuery &query) {
+        return query.connectionName == u"con2"_s;
+    }));
+
+    // Unknown connections are ignored, known ones reuse the freed node
+    model.removeConnection(2);
+    QCOMPARE(removedSpy.count(), 1);
+    model.addConnection(4, u"con4"_s, 2000);
+    model.addQuery(4, 2000, 1, u"SELECT 4"_s, {}, 0, {}, QString());
+    QCOMPARE(model.rowCount(), 3);
+    QCOMPARE(model.rowCount(model.index(2, 0)), 1);
+    QCOMPARE(model.index(2, 0).data().toString(), u"con4"_s);
+}
+
+void QueryTreeModelTest::shouldRemoveCapturedQueries()
+{
+    QueryTreeModel model;
+    model.addConnection(1, u"con1"_s, 1000);
+    QList<QueryRecord> records;
+    for (int i = 0; i < QueryTreeModel::RepeatThreshold + 1; ++i) {
+        QueryRecord record;
+        record.connectionId = 1;
+        record.timestamp = 1000 + i;
+        record.duration = 10;
+        record.query = u"SELECT * FROM parts WHERE id = :0"_s;
+        record.captureSerial = i + 1;
+        records << record;
+    }
+    model.addQueries(1, records);
+    const QModelIndex con = model.index(0, 0);
+    QCOMPARE(model.rowCount(con), 6);
+    QCOMPARE(model.repeatedQueries(10).constFirst().count, 6);
+
+    QSignalSpy removedSpy(&model, &QAbstractItemModel::rowsRemoved);
+    QSignalSpy repeatedSpy(&model, &QueryTreeModel::repeatedQueriesChanged);
+    const QPersistentModelIndex last = model.index(5, 0, con);
+    // The first query of the run goes, the next one takes over
+    model.removeCapturedQueries({1, 99});
+    QCOMPARE(removedSpy.count(), 1);
+    QCOMPARE(repeatedSpy.count(), 1);
+    QCOMPARE(model.rowCount(con), 5);
+    QCOMPARE(last.row(), 4);
+    for (int row = 0; row < model.rowCount(con); ++row) {
+        QCOMPARE(model.parent(model.index(row, 0, con)), con);
+    }
+    auto repeated = model.repeatedQueries(10);
+    QCOMPARE(repeated.count(), 1);
+    QCOMPARE(repeated.constFirst().count, 5);
+    QCOMPARE(repeated.constFirst().duration, 50U);
+    QCOMPARE(repeated.constFirst().first.row(), 0);
+    QVERIFY(!model.index(0, QueryTreeModel::RepeatedColumn, con).data().toString().isEmpty());
+
+    // Already removed
+    model.removeCapturedQueries({1});
+    QCOMPARE(removedSpy.count(), 1);
+
+    model.removeCapturedQueries({2, 3, 4, 5, 6});
+    QCOMPARE(model.rowCount(con), 0);
+    QVERIFY(model.repeatedQueries(10).isEmpty());
+
+    // The freed nodes are reused
+    model.addQueries(1, records.mid(0, 1));
+    QCOMPARE(model.rowCount(con), 1);
+    QCOMPARE(model.index(0, 0, con).data().toString(), u"SELECT * FROM parts WHERE id = :0"_s);
+    QVERIFY(model.index(0, QueryTreeModel::RepeatedColumn, con).data().toString().isEmpty());
+}
+
+QTEST_GUILESS_MAIN(QueryTreeModelTest)
+
+#include "moc_querytreemodeltest.cpp"
@@ -0,0 +1,22 @@
+/*
+  SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+  SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <QObject>
+
+class QueryTreeModelTest : public QObject
+{
+    Q_OBJECT
+public:
+    explicit QueryTreeModelTest(QObject *parent = nullptr);
+    ~QueryTreeModelTest() override;
+private Q_SLOTS:
+    void shouldShowQueriesAndTransactions();
+    void shouldDetectRepeatedQueries();
+    void shouldIgnoreDistantRepeats();
+    void shouldRemoveConnections();
+    void shouldRemoveCapturedQueries();
+};
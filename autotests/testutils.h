@@ -0,0 +1,37 @@
+/*
+  SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+  SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include "captureloader.h"
+#include "exportjob.h"
+
+#include <QSignalSpy>
+
+namespace TestUtils
+{
+/** Runs @p job and waits for it, returns whether it succeeded. */
+inline bool runJob(ExportJob &job)
+{
+    QSignalSpy spy(&job, &ExportJob::finished);
+    job.start();
+    return spy.wait() && spy.at(0).at(0).toBool();
+}
+
+/** Loads @p fileName with @p loader and waits for it, @p errorString gets the loader's error. */
+inline bool load(CaptureLoader &loader, const QString &fileName, QString *errorString = nullptr)
+{
+    bool success = loader.open(fileName);
+    if (success) {
+        QSignalSpy spy(&loader, &CaptureLoader::finished);
+        loader.start();
+        success = spy.wait() && spy.at(0).at(0).toBool();
+    }
+    if (errorString) {
+        *errorString = loader.errorString();
+    }
+    return success;
+}
+}
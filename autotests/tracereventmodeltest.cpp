@@ -0,0 +1,84 @@
+/*
+  SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+  SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "tracereventmodeltest.h"
+using namespace Qt::Literals::StringLiterals;
+
+#include "tracereventmodel.h"
+
+#include <QSignalSpy>
+#include <QTest>
+
+namespace
+{
+QList<TracerEventModel::Event> events(int first, int count)
+{
+    QList<TracerEventModel::Event> events;
+    for (int i = first; i < first + count; ++i) {
+        events.push_back({i, TracerEventModel::Signal, u"itemChanged"_s, QString::number(i)});
+    }
+    return events;
+}
+
+QString messageAt(const TracerEventModel &model, int row)
+{
+    return model.index(row, TracerEventModel::MessageColumn).data().toString();
+}
+}
+
+TracerEventModelTest::TracerEventModelTest(QObject *parent)
+    : QObject(parent)
+{
+}
+
+TracerEventModelTest::~TracerEventModelTest() = default;
+
+void TracerEventModelTest::shouldShowEvents()
+{
+    TracerEventModel model;
+    model.addEvents({{0, TracerEventModel::Error, u"akonadi_imap_resource"_s, u"<b>Connection lost</b>"_s}});
+
+    QCOMPARE(model.rowCount(), 1);
+    QCOMPARE(model.index(0, TracerEventModel::ComponentColumn).data().toString(), u"akonadi_imap_resource"_s);
+    // Stored and shown as plain text
+    QCOMPARE(messageAt(model, 0), u"<b>Connection lost</b>"_s);
+    QCOMPARE(model.index(0, 0).data(TracerEventModel::SeverityRole).toInt(), int(TracerEventModel::Error));
+
+    model.clear();
+    QCOMPARE(model.rowCount(), 0);
+}
+
+void TracerEventModelTest::shouldDropOldestEvents()
+{
+    TracerEventModel model;
+    model.setMaximumCount(160);
+    QSignalSpy removedSpy(&model, &QAbstractItemModel::rowsRemoved);
+
+    model.addEvents(events(0, 160));
+    QCOMPARE(model.rowCount(), 160);
+    QCOMPARE(removedSpy.count(), 0);
+
+    // A full model drops a sixteenth of its events at once
+    model.addEvents(events(160, 1));
+    QCOMPARE(removedSpy.count(), 1);
+    QCOMPARE(model.rowCount(), 151);
+    QCOMPARE(messageAt(model, 0), u"10"_s);
+    QCOMPARE(messageAt(model, 150), u"160"_s);
+
+    // Only the newest events of a large batch are kept
+    model.addEvents(events(1000, 500));
+    QCOMPARE(model.rowCount(), 160);
+    QCOMPARE(messageAt(model, 0), u"1340"_s);
+    QCOMPARE(messageAt(model, 159), u"1499"_s);
+
+    model.setMaximumCount(50);
+    QCOMPARE(model.rowCount(), 50);
+    QCOMPARE(messageAt(model, 0), u"1450"_s);
+}
+
+QTEST_GUILESS_MAIN(TracerEventModelTest)
+
+#include "moc_tracereventmodeltest.cpp"
@@ -0,0 +1,19 @@
+/*
+  SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+  SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <QObject>
+
+class TracerEventModelTest : public QObject
+{
+    Q_OBJECT
+public:
+    explicit TracerEventModelTest(QObject *parent = nullptr);
+    ~TracerEventModelTest() override;
+private Q_SLOTS:
+    void shouldShowEvents();
+    void shouldDropOldestEvents();
+};
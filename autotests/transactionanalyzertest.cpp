@@ -0,0 +1,105 @@
+/*
+  SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+  SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "transactionanalyzertest.h"
+using namespace Qt::Literals::StringLiterals;
+
+#include "transactionanalyzer.h"
+
+#include <QTest>
+
+TransactionAnalyzerTest::TransactionAnalyzerTest(QObject *parent)
+    : QObject(parent)
+{
+}
+
+TransactionAnalyzerTest::~TransactionAnalyzerTest() = default;
+
+void TransactionAnalyzerTest::shouldBeEmpty()
+{
+    TransactionAnalyzer analyzer;
+    QVERIFY(analyzer.longestTransactions().isEmpty());
+    QVERIFY(analyzer.longestOverlaps().isEmpty());
+    QVERIFY(analyzer.connections().isEmpty());
+    QVERIFY(analyzer.rollbackHotSpots().isEmpty());
+    QCOMPARE(analyzer.totalTransactionTime(), 0);
+}
+
+void TransactionAnalyzerTest::shouldRankLongestTransactions()
+{
+    TransactionAnalyzer analyzer(2);
+    analyzer.addTransaction(1, u"con1"_s, u"a"_s, 0, 10, true);
+    analyzer.addTransaction(1, u"con1"_s, u"b"_s, 10, 40, true);
+    analyzer.addTransaction(1, u"con1"_s, u"c"_s, 40, 60, true);
+
+    const auto longest = analyzer.longestTransactions();
+    QCOMPARE(longest.count(), 2);
+    QCOMPARE(longest.at(0).name, u"b"_s);
+    QCOMPARE(longest.at(0).duration(), 30);
+    QCOMPARE(longest.at(1).name, u"c"_s);
+}
+
+void TransactionAnalyzerTest::shouldDetectOverlapsAcrossConnections()
+{
+    TransactionAnalyzer analyzer;
+    analyzer.addTransaction(1, u"con1"_s, u"a"_s, 0, 100, true);
+    // Same connection never counts as an overlap
+    analyzer.addTransaction(1, u"con1"_s, u"b"_s, 100, 150, true);
+    analyzer.addTransaction(2, u"con2"_s, u"c"_s, 80, 200, true);
+    // Starts after everything else has finished
+    analyzer.addTransaction(3, u"con3"_s, u"d"_s, 300, 310, true);
+
+    const auto overlaps = analyzer.longestOverlaps();
+    QCOMPARE(overlaps.count(), 2);
+    QCOMPARE(overlaps.at(0).first.name, u"b"_s);
+    QCOMPARE(overlaps.at(0).second.name, u"c"_s);
+    QCOMPARE(overlaps.at(0).duration, 50);
+    QCOMPARE(overlaps.at(1).first.name, u"a"_s);
+    QCOMPARE(overlaps.at(1).duration, 20);
+
+    const auto longest = analyzer.longestTransactions();
+    QCOMPARE(longest.at(0).name, u"c"_s);
+    QCOMPARE(longest.at(0).concurrent, 2);
+}
+
+void TransactionAnalyzerTest::shouldComputeConnectionShares()
+{
+    TransactionAnalyzer analyzer;
+    analyzer.addTransaction(1, u"con1"_s, u"a"_s, 0, 30, true);
+    analyzer.addTransaction(2, u"con2"_s, u"b"_s, 100, 110, true);
+    analyzer.addTransaction(1, u"con1"_s, u"c"_s, 200, 260, false);
+
+    QCOMPARE(analyzer.totalTransactionTime(), 100);
+    const auto connections = analyzer.connections();
+    QCOMPARE(connections.count(), 2);
+    QCOMPARE(connections.at(0).name, u"con1"_s);
+    QCOMPARE(connections.at(0).time, 90);
+    QCOMPARE(connections.at(0).transactions, 2);
+    QCOMPARE(connections.at(0).rollbacks, 1);
+    QCOMPARE(connections.at(1).time, 10);
+}
+
+void TransactionAnalyzerTest::shouldRankRollbackHotSpots()
+{
+    TransactionAnalyzer analyzer;
+    analyzer.addTransaction(1, u"con1"_s, u"a"_s, 0, 1, false);
+    analyzer.addTransaction(1, u"con1"_s, u"b"_s, 1, 2, false);
+    analyzer.addTransaction(1, u"con1"_s, u"b"_s, 2, 3, false);
+    analyzer.addTransaction(1, u"con1"_s, u"c"_s, 3, 4, true);
+
+    const auto hotSpots = analyzer.rollbackHotSpots();
+    QCOMPARE(hotSpots.count(), 2);
+    QCOMPARE(hotSpots.at(0).name, u"b"_s);
+    QCOMPARE(hotSpots.at(0).rollbacks, 2);
+    QCOMPARE(hotSpots.at(1).name, u"a"_s);
+
+    analyzer.clear();
+    QVERIFY(analyzer.rollbackHotSpots().isEmpty());
+}
+
+QTEST_GUILESS_MAIN(TransactionAnalyzerTest)
+
+#include "moc_transactionanalyzertest.cpp"
@@ -0,0 +1,22 @@
+/*
+  SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+  SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <QObject>
+
+class TransactionAnalyzerTest : public QObject
+{
+    Q_OBJECT
+public:
+    explicit TransactionAnalyzerTest(QObject *parent = nullptr);
+    ~TransactionAnalyzerTest() override;
+private Q_SLOTS:
+    void shouldBeEmpty();
+    void shouldRankLongestTransactions();
+    void shouldDetectOverlapsAcrossConnections();
+    void shouldComputeConnectionShares();
+    void shouldRankRollbackHotSpots();
+};
@@ -15,6 +15,10 @@ using namespace Qt::Literals::StringLiterals;
 
 #include <KCalendarCore/Incidence>
 
+#include <QDateTime>
+
+#include <limits>
+
 using IncidencePtr = QSharedPointer<KCalendarCore::Incidence>;
 
 class AkonadiBrowserModel::State
@@ -25,7 +29,22 @@ public:
     QStringList m_collectionHeaders;
     QStringList m_itemHeaders;
 
-    [[nodiscard]] virtual QVariant entityData(const Item &item, int column, int role) const = 0;
+    // Decodes every column of item at once, the cells left invalid fall back to the EntityTreeModel
+    virtual void fill(const Item &item, CachedItem &cached) const = 0;
+
+protected:
+    static void setText(CachedItem &cached, int column, const QString &text)
+    {
+        cached.display[column] = text;
+        cached.sortKeys[column].text = text;
+    }
+
+    static void setDateTime(CachedItem &cached, int column, const QString &text, const QDateTime &dateTime)
+    {
+        cached.display[column] = text;
+        // Missing dates sort first
+        cached.sortKeys[column].number = dateTime.isValid() ? dateTime.toMSecsSinceEpoch() : std::numeric_limits<qint64>::min();
+    }
 };
 
 class GenericState : public AkonadiBrowserModel::State
@@ -46,23 +65,13 @@ public:
         MimeTypeColumn = 3
     };
 
-    [[nodiscard]] QVariant entityData(const Item &item, int column, int role) const override
+    void fill(const Item &item, AkonadiBrowserModel::CachedItem &cached) const override
     {
-        if (Qt::DisplayRole != role) {
-            return {};
-        }
-
-        switch (column) {
-        case IdColumn:
-            return item.id();
-        case RemoteIdColumn:
-            return item.remoteId();
-        case GIDColumn:
-            return item.gid();
-        case MimeTypeColumn:
-            return item.mimeType();
-        }
-        return {};
+        cached.display[IdColumn] = item.id();
+        cached.sortKeys[IdColumn].number = item.id();
+        setText(cached, RemoteIdColumn, item.remoteId());
+        setText(cached, GIDColumn, item.gid());
+        setText(cached, MimeTypeColumn, item.mimeType());
     }
 };
 
@@ -77,40 +86,20 @@ public:
 
     ~MailState() override = default;
 
-    [[nodiscard]] QVariant entityData(const Item &item, int column, int role) const override
+    void fill(const Item &item, AkonadiBrowserModel::CachedItem &cached) const override
     {
-        if (Qt::DisplayRole != role) {
-            return {};
-        }
-
         if (!item.hasPayload<std::shared_ptr<KMime::Message>>()) {
-            return {};
+            return;
         }
         const auto mail = item.payload<std::shared_ptr<const KMime::Message>>();
 
-        // NOTE: remember to update AkonadiBrowserSortModel::lessThan if you insert/move columns
-        switch (column) {
-        case 0:
-            if (mail->subject()) {
-                return mail->subject()->asUnicodeString();
-            } else {
-                return u"(No subject)"_s;
-            }
-        case 1:
-            if (mail->from()) {
-                return mail->from()->asUnicodeString();
-            } else {
-                return QString();
-            }
-        case 2:
-            if (mail->date()) {
-                return mail->date()->asUnicodeString();
-            } else {
-                return QString();
-            }
+        setText(cached, 0, mail->subject() ? mail->subject()->asUnicodeString() : u"(No subject)"_s);
+        setText(cached, 1, mail->from() ? mail->from()->asUnicodeString() : QString());
+        if (const auto date = mail->date()) {
+            setDateTime(cached, 2, date->asUnicodeString(), date->dateTime());
+        } else {
+            setDateTime(cached, 2, QString(), QDateTime());
         }
-
-        return {};
     }
 };
 
@@ -125,38 +114,19 @@ public:
 
     ~ContactsState() override = default;
 
-    [[nodiscard]] QVariant entityData(const Item &item, int column, int role) const override
+    void fill(const Item &item, AkonadiBrowserModel::CachedItem &cached) const override
     {
-        if (Qt::DisplayRole != role) {
-            return {};
-        }
-
-        if (!item.hasPayload<KContacts::Addressee>() && !item.hasPayload<KContacts::ContactGroup>()) {
-            return {};
-        }
-
         if (item.hasPayload<KContacts::Addressee>()) {
             const auto addr = item.payload<KContacts::Addressee>();
-
-            switch (column) {
-            case 0:
-                return addr.givenName();
-            case 1:
-                return addr.familyName();
-            case 2:
-                return addr.preferredEmail();
-            }
-            return {};
-        }
-        if (item.hasPayload<KContacts::ContactGroup>()) {
-            switch (column) {
-            case 0:
-                const auto group = item.payload<KContacts::ContactGroup>();
-                return group.name();
-            }
-            return {};
+            setText(cached, 0, addr.givenName());
+            setText(cached, 1, addr.familyName());
+            setText(cached, 2, addr.preferredEmail());
+        } else if (item.hasPayload<KContacts::ContactGroup>()) {
+            const auto group = item.payload<KContacts::ContactGroup>();
+            setText(cached, 0, group.name());
+            setText(cached, 1, QString());
+            setText(cached, 2, QString());
         }
-        return {};
     }
 };
 
@@ -171,32 +141,20 @@ public:
 
     ~CalendarState() override = default;
 
-    [[nodiscard]] QVariant entityData(const Item &item, int column, int role) const override
+    void fill(const Item &item, AkonadiBrowserModel::CachedItem &cached) const override
     {
-        if (Qt::DisplayRole != role) {
-            return {};
-        }
-
         if (!item.hasPayload<IncidencePtr>()) {
-            return {};
+            return;
         }
         const auto incidence = item.payload<IncidencePtr>();
-        // NOTE: remember to update AkonadiBrowserSortModel::lessThan if you insert/move columns
-        switch (column) {
-        case 0:
-            return incidence->uid();
-        case 1:
-            return incidence->summary();
-        case 2:
-            return incidence->dtStart().toString();
-        case 3:
-            return incidence->dateTime(KCalendarCore::Incidence::RoleEnd).toString();
-        case 4:
-            return incidence->typeStr();
-        default:
-            break;
-        }
-        return {};
+
+        setText(cached, 0, incidence->uid());
+        setText(cached, 1, incidence->summary());
+        const QDateTime start = incidence->dtStart();
+        setDateTime(cached, 2, start.toString(), start);
+        const QDateTime end = incidence->dateTime(KCalendarCore::Incidence::RoleEnd);
+        setDateTime(cached, 3, end.toString(), end);
+        setText(cached, 4, QString::fromLatin1(incidence->typeStr()));
     }
 };
 
@@ -209,6 +167,16 @@ AkonadiBrowserModel::AkonadiBrowserModel(ChangeRecorder *monitor, QObject *paren
     m_calendarState = new CalendarState();
 
     m_currentState = m_genericState;
+
+    connect(this, &QAbstractItemModel::rowsInserted, this, &AkonadiBrowserModel::cacheRows);
+    connect(this, &QAbstractItemModel::rowsAboutToBeRemoved, this, &AkonadiBrowserModel::uncacheRows);
+    connect(this, &QAbstractItemModel::dataChanged, this, [this](const QModelIndex &topLeft, const QModelIndex &bottomRight) {
+        // Changed items are decoded again the next time they are shown
+        uncacheRows(topLeft.parent(), topLeft.row(), bottomRight.row());
+    });
+    connect(this, &QAbstractItemModel::modelReset, this, [this]() {
+        m_itemCache.clear();
+    });
 }
 
 AkonadiBrowserModel::~AkonadiBrowserModel()
@@ -219,9 +187,74 @@ AkonadiBrowserModel::~AkonadiBrowserModel()
     delete m_calendarState;
 }
 
+const AkonadiBrowserModel::CachedItem &AkonadiBrowserModel::cachedItem(const Item &item) const
+{
+    auto it = m_itemCache.find(item.id());
+    if (it != m_itemCache.end() && it->revision == item.revision() && (it->hasPayload || !item.hasPayload())) {
+        return *it;
+    }
+
+    if (it == m_itemCache.end()) {
+        it = m_itemCache.insert(item.id(), {});
+    }
+    auto &cached = *it;
+    const int columns = m_currentState->m_itemHeaders.size();
+    cached.revision = item.revision();
+    cached.hasPayload = item.hasPayload();
+    cached.display.fill(QVariant(), columns);
+    cached.sortKeys.fill(SortKey(), columns);
+    m_currentState->fill(item, cached);
+    return cached;
+}
+
+void AkonadiBrowserModel::cacheRows(const QModelIndex &parent, int first, int last)
+{
+    // Fetched items are decoded right away, so that neither painting nor sorting has to
+    for (int row = first; row <= last; ++row) {
+        const auto item = index(row, 0, parent).data(ItemRole).value<Item>();
+        if (item.isValid()) {
+            cachedItem(item);
+        }
+    }
+}
+
+void AkonadiBrowserModel::uncacheRows(const QModelIndex &parent, int first, int last)
+{
+    if (m_itemCache.isEmpty()) {
+        return;
+    }
+    for (int row = first; row <= last; ++row) {
+        const auto id = index(row, 0, parent).data(ItemIdRole).toLongLong();
+        if (id > 0) {
+            m_itemCache.remove(id);
+        }
+    }
+}
+
+const AkonadiBrowserModel::SortKey *AkonadiBrowserModel::cachedSortKey(Item::Id id, int column) const
+{
+    const auto it = m_itemCache.constFind(id);
+    if (it == m_itemCache.cend()) {
+        return nullptr;
+    }
+    static const SortKey noKey;
+    return column < it->sortKeys.size() ? &it->sortKeys.at(column) : &noKey;
+}
+
+void AkonadiBrowserModel::cacheItem(const Item &item) const
+{
+    cachedItem(item);
+}
+
 QVariant AkonadiBrowserModel::entityData(const Item &item, int column, int role) const
 {
-    QVariant var = m_currentState->entityData(item, column, role);
+    QVariant var;
+    if (role == Qt::DisplayRole) {
+        const auto &cached = cachedItem(item);
+        if (column < cached.display.size()) {
+            var = cached.display.at(column);
+        }
+    }
     if (!var.isValid()) {
         if (column < 1) {
             return EntityTreeModel::entityData(item, column, role);
@@ -317,6 +350,8 @@ void AkonadiBrowserModel::setItemDisplayMode(AkonadiBrowserModel::ItemDisplayMod
     } else {
         m_currentState = newState;
     }
+    // The columns mean something else now
+    m_itemCache.clear();
     headerDataChanged(Qt::Horizontal, 0, newColumnCount - 1);
 
     // The above is not enough to see the new headers, because EntityMimeTypeFilterModel gets column count and headers from our data,
@@ -332,44 +367,40 @@ AkonadiBrowserSortModel::AkonadiBrowserSortModel(AkonadiBrowserModel *model, QOb
 
 AkonadiBrowserSortModel::~AkonadiBrowserSortModel() = default;
 
-bool AkonadiBrowserSortModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
+Item::Id AkonadiBrowserSortModel::cachedItemId(const QModelIndex &index) const
 {
-    if (mBrowserModel->itemDisplayMode() == AkonadiBrowserModel::CalendarMode) {
-        if (left.column() == 2 || left.column() == 3) {
-            const Item leftItem = left.data(EntityTreeModel::ItemRole).value<Item>();
-            const Item rightItem = right.data(EntityTreeModel::ItemRole).value<Item>();
-            if (!leftItem.hasPayload<IncidencePtr>() || !rightItem.hasPayload<IncidencePtr>()) {
-                return false;
-            }
-            const auto leftInc = leftItem.payload<IncidencePtr>();
-            const auto rightInc = rightItem.payload<IncidencePtr>();
+    // Items are decoded when fetched and dropped from the cache when they change or the
+    // display mode switches, so usually the id is all that has to be read from the model
+    const auto id = index.data(EntityTreeModel::ItemIdRole).toLongLong();
+    if (id > 0 && mBrowserModel->cachedSortKey(id, index.column())) {
+        return id;
+    }
+    const auto item = index.data(EntityTreeModel::ItemRole).value<Item>();
+    if (!item.isValid()) {
+        return -1;
+    }
+    mBrowserModel->cacheItem(item);
+    return item.id();
+}
 
-            if (left.column() == 1) {
-                return leftInc->dtStart() < rightInc->dtStart();
-            } else if (left.column() == 2) {
-                return leftInc->dateTime(KCalendarCore::IncidenceBase::RoleEnd) < rightInc->dateTime(KCalendarCore::IncidenceBase::RoleEnd);
-            }
-        }
-    } else if (mBrowserModel->itemDisplayMode() == AkonadiBrowserModel::MailMode) {
-        if (left.column() == 2) {
-            const Item leftItem = left.data(EntityTreeModel::ItemRole).value<Item>();
-            const Item rightItem = right.data(EntityTreeModel::ItemRole).value<Item>();
-            if (!leftItem.hasPayload<std::shared_ptr<KMime::Message>>() || !rightItem.hasPayload<std::shared_ptr<KMime::Message>>()) {
-                return false;
-            }
-            const auto leftMail = leftItem.payload<std::shared_ptr<const KMime::Message>>();
-            const auto rightMail = rightItem.payload<std::shared_ptr<const KMime::Message>>();
-            const KMime::Headers::Date *ldate = leftMail->date();
-            const KMime::Headers::Date *rdate = rightMail->date();
-            if (ldate && rdate) {
-                return ldate->dateTime() < rdate->dateTime();
-            } else {
-                return false;
-            }
-        }
+bool AkonadiBrowserSortModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
+{
+    const auto leftId = cachedItemId(left);
+    const auto rightId = cachedItemId(right);
+    if (leftId < 0 || rightId < 0) {
+        return QSortFilterProxyModel::lessThan(left, right);
     }
 
-    return QSortFilterProxyModel::lessThan(left, right);
+    // Both are cached now, plain field reads from here on
+    const auto &leftKey = *mBrowserModel->cachedSortKey(leftId, left.column());
+    const auto &rightKey = *mBrowserModel->cachedSortKey(rightId, right.column());
+    if (leftKey.number != rightKey.number) {
+        return leftKey.number < rightKey.number;
+    }
+    if (isSortLocaleAware()) {
+        return leftKey.text.localeAwareCompare(rightKey.text) < 0;
+    }
+    return leftKey.text.compare(rightKey.text, sortCaseSensitivity()) < 0;
 }
 
 #include "moc_akonadibrowsermodel.cpp"
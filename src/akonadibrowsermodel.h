@@ -9,6 +9,8 @@
 #include <Akonadi/ChangeRecorder>
 #include <Akonadi/EntityTreeModel>
 
+#include <QHash>
+#include <QList>
 #include <QSortFilterProxyModel>
 
 using namespace Akonadi;
@@ -37,12 +39,43 @@ public:
 
     int entityColumnCount(HeaderGroup headerGroup) const override;
 
+    /** Sort key of a cell, dates sort by their time and everything else by its text. */
+    struct SortKey {
+        qint64 number = 0;
+        QString text;
+    };
+
+    /**
+     * What the current display mode shows of an item. It is decoded from the
+     * payload once, when the item is fetched, and again only when the item changes.
+     */
+    struct CachedItem {
+        qint64 revision = -1;
+        bool hasPayload = false;
+        QList<QVariant> display;
+        QList<SortKey> sortKeys;
+    };
+
+    /**
+     * Sort key of an item that is decoded already, nullptr when it is not or it
+     * changed since. The pointer is valid until the next item gets decoded.
+     */
+    [[nodiscard]] const SortKey *cachedSortKey(Item::Id id, int column) const;
+    /** Decodes @p item unless it is cached already. */
+    void cacheItem(const Item &item) const;
+
     class State;
 
 Q_SIGNALS:
     void columnsChanged();
 
 private:
+    const CachedItem &cachedItem(const Item &item) const;
+    void cacheRows(const QModelIndex &parent, int first, int last);
+    void uncacheRows(const QModelIndex &parent, int first, int last);
+
+    // By item id, for the current display mode
+    mutable QHash<Item::Id, CachedItem> m_itemCache;
     State *m_currentState = nullptr;
     State *m_genericState = nullptr;
     State *m_mailState = nullptr;
@@ -63,5 +96,8 @@ protected:
     bool lessThan(const QModelIndex &left, const QModelIndex &right) const override;
 
 private:
+    // Id of the item at index with its sort keys cached, -1 for collections
+    [[nodiscard]] Item::Id cachedItemId(const QModelIndex &index) const;
+
     AkonadiBrowserModel *const mBrowserModel;
 };
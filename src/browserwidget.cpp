@@ -28,6 +28,7 @@
 #include <Akonadi/ItemFetchScope>
 #include <Akonadi/ItemModifyJob>
 #include <Akonadi/Job>
+#include <Akonadi/MessageParts>
 #include <Akonadi/SelectionProxyModel>
 #include <Akonadi/Session>
 #include <Akonadi/StandardActionManager>
@@ -125,8 +126,7 @@ BrowserWidget::BrowserWidget(KXmlGuiWindow *xmlGuiWindow, QWidget *parent)
     mBrowserMonitor->setCollectionMonitored(Collection::root());
     mBrowserMonitor->fetchCollection(true);
     mBrowserMonitor->setAllMonitored(true);
-    // TODO: Only fetch the envelope etc if possible.
-    mBrowserMonitor->itemFetchScope().fetchFullPayload(true);
+    // The payload parts follow the display mode, see updateItemFetchScope()
     mBrowserMonitor->itemFetchScope().setCacheOnly(true);
     mBrowserMonitor->itemFetchScope().setFetchGid(true);
 
@@ -275,6 +275,7 @@ void BrowserWidget::currentChanged(const QModelIndex &index)
         return;
     }
 
+    // The list only holds what its columns need, the content view gets everything
     auto job = new ItemFetchJob(item, this);
     job->fetchScope().fetchFullPayload();
     job->fetchScope().fetchAllAttributes();
@@ -418,6 +419,7 @@ void BrowserWidget::modelChanged()
     default:
         mBrowserModel->setItemDisplayMode(AkonadiBrowserModel::GenericMode);
     }
+    updateItemFetchScope();
 }
 
 void BrowserWidget::save()
@@ -536,7 +538,36 @@ Akonadi::Collection BrowserWidget::currentCollection() const
 
 void BrowserWidget::updateItemFetchScope()
 {
-    mBrowserMonitor->itemFetchScope().setCacheOnly(mCacheOnlyAction->isChecked());
+    ItemFetchScope &scope = mBrowserMonitor->itemFetchScope();
+    scope.setCacheOnly(mCacheOnlyAction->isChecked());
+
+    const QSet<QByteArray> oldParts = scope.payloadParts();
+    const bool oldFullPayload = scope.fullPayload();
+    for (const QByteArray &part : oldParts) {
+        scope.fetchPayloadPart(part, false);
+    }
+    scope.fetchFullPayload(false);
+    switch (mBrowserModel->itemDisplayMode()) {
+    case AkonadiBrowserModel::MailMode:
+        // Subject, sender and date are all in the envelope, the bodies are only needed by the content view
+        scope.fetchPayloadPart(Akonadi::MessagePart::Envelope);
+        break;
+    case AkonadiBrowserModel::ContactsMode:
+    case AkonadiBrowserModel::CalendarMode:
+        // Contacts and incidences have no smaller part to fill the columns from
+        scope.fetchFullPayload(true);
+        break;
+    case AkonadiBrowserModel::GenericMode:
+    default:
+        break;
+    }
+
+    // Items that were already fetched carry the parts of the previous mode
+    if (scope.payloadParts() != oldParts || scope.fullPayload() != oldFullPayload) {
+        m_stateMaintainer->saveState();
+        mBrowserModel->clearAndReset();
+        m_stateMaintainer->restoreState();
+    }
 }
 
 void BrowserWidget::tagViewContextMenuRequested(const QPoint &pos)
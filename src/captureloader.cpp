@@ -0,0 +1,126 @@
+/*
+    SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "captureloader.h"
+
+#include <KLocalizedString>
+
+#include <QMessageBox>
+#include <QProgressDialog>
+
+CaptureLoader::CaptureLoader(QObject *parent)
+    : QObject(parent)
+{
+    mTimer.setInterval(0);
+    connect(&mTimer, &QTimer::timeout, this, &CaptureLoader::loadBatch);
+}
+
+CaptureLoader::~CaptureLoader() = default;
+
+bool CaptureLoader::open(const QString &fileName)
+{
+    mFile.setFileName(fileName);
+    if (!mFile.open(QIODevice::ReadOnly)) {
+        mErrorString = mFile.errorString();
+        return false;
+    }
+
+    mSize = mFile.size();
+    if (mSize > 0) {
+        mData = reinterpret_cast<const char *>(mFile.map(0, mSize));
+        if (!mData) {
+            mErrorString = mFile.errorString();
+            return false;
+        }
+    }
+    return readHeader();
+}
+
+void CaptureLoader::start()
+{
+    clearModel();
+    mTimer.start();
+}
+
+void CaptureLoader::startWithProgressDialog(QWidget *parent, const QString &labelText)
+{
+    auto dlg = new QProgressDialog(labelText, i18n("Cancel"), 0, 100, parent);
+    dlg->setAttribute(Qt::WA_DeleteOnClose);
+    dlg->setMinimumDuration(500);
+    dlg->setAutoClose(false);
+    dlg->setAutoReset(false);
+    connect(this, &CaptureLoader::progress, dlg, &QProgressDialog::setValue);
+    connect(dlg, &QProgressDialog::canceled, this, &CaptureLoader::cancel);
+    connect(this, &CaptureLoader::finished, dlg, [this, dlg, parent](bool success) {
+        // Closing the dialog emits canceled(), which would hide the failure
+        const bool failed = !success && !mCanceled;
+        dlg->close();
+        if (failed) {
+            QMessageBox::warning(parent, i18n("Error"), failureMessage());
+        }
+        deleteLater();
+    });
+    start();
+}
+
+void CaptureLoader::cancel()
+{
+    mCanceled = true;
+}
+
+QString CaptureLoader::errorString() const
+{
+    return mErrorString;
+}
+
+bool CaptureLoader::isCanceled() const
+{
+    return mCanceled;
+}
+
+void CaptureLoader::setErrorString(const QString &errorString)
+{
+    mErrorString = errorString;
+}
+
+bool CaptureLoader::damaged()
+{
+    mErrorString = i18n("The capture is damaged at offset %1.", mPosition);
+    return false;
+}
+
+void CaptureLoader::loadBatch()
+{
+    if (mCanceled) {
+        finish(false);
+        return;
+    }
+
+    // Whatever was read before an error is kept
+    const bool ok = readBatch();
+    if (!ok || mPosition >= mSize) {
+        finish(ok);
+        return;
+    }
+    const int percent = int(mPosition * 100 / mSize);
+    if (percent != mLastProgress) {
+        mLastProgress = percent;
+        Q_EMIT progress(percent);
+    }
+}
+
+void CaptureLoader::finish(bool success)
+{
+    mTimer.stop();
+    mFile.close();
+    mData = nullptr;
+    if (success) {
+        Q_EMIT progress(100);
+    }
+    Q_EMIT finished(success);
+}
+
+#include "moc_captureloader.cpp"
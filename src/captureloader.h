@@ -0,0 +1,74 @@
+/*
+    SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "libakonadiconsole_export.h"
+
+#include <QFile>
+#include <QObject>
+#include <QTimer>
+
+class QWidget;
+
+/**
+ * Base class for loading a capture file back into a model.
+ *
+ * The file is memory-mapped and subclasses parse it a batch at a time from
+ * the event loop in readBatch(), so even large captures do not have to be read
+ * into memory first and the application stays responsive while they load.
+ */
+class LIBAKONADICONSOLE_EXPORT CaptureLoader : public QObject
+{
+    Q_OBJECT
+public:
+    explicit CaptureLoader(QObject *parent = nullptr);
+    ~CaptureLoader() override;
+
+    /** Maps @p fileName and checks its format. */
+    [[nodiscard]] bool open(const QString &fileName);
+    /** Replaces the content of the model with the capture. */
+    void start();
+    /** Same as start(), with a progress dialog that can cancel the loading. Deletes the loader when done. */
+    void startWithProgressDialog(QWidget *parent, const QString &labelText);
+    void cancel();
+
+    [[nodiscard]] QString errorString() const;
+    [[nodiscard]] bool isCanceled() const;
+
+Q_SIGNALS:
+    void progress(int percent);
+    void finished(bool success);
+
+protected:
+    /** Checks the start of the mapped file and moves mPosition past its header. */
+    [[nodiscard]] virtual bool readHeader() = 0;
+    /** Called by start(), before the first batch is read. */
+    virtual void clearModel() = 0;
+    /** Reads the next batch of records at mPosition, returns false on error. */
+    [[nodiscard]] virtual bool readBatch() = 0;
+    /** Warning shown by startWithProgressDialog() when the capture could not be loaded. */
+    [[nodiscard]] virtual QString failureMessage() const = 0;
+
+    void setErrorString(const QString &errorString);
+    /** Reports the record at mPosition as damaged, always returns false. */
+    bool damaged();
+
+    // The mapped file, nullptr while it is not mapped or empty
+    const char *mData = nullptr;
+    qint64 mSize = 0;
+    qint64 mPosition = 0;
+
+private:
+    void loadBatch();
+    void finish(bool success);
+
+    QFile mFile;
+    QTimer mTimer;
+    QString mErrorString;
+    bool mCanceled = false;
+    int mLastProgress = -1;
+};
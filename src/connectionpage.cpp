@@ -9,13 +9,22 @@
 #include "connectionpage.h"
 using namespace Qt::Literals::StringLiterals;
 
+#include "connectionratemodel.h"
+#include "debugcaptureloader.h"
 #include "debugfiltermodel.h"
 #include "debugmodel.h"
+#include "protocolstatisticsmodel.h"
 
 #include <Libkdepim/KCheckComboBox>
 
+#include <QCheckBox>
 #include <QHeaderView>
 #include <QLabel>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QScrollBar>
+#include <QSortFilterProxyModel>
+#include <QSplitter>
 #include <QTableView>
 
 #include <KLocalizedString>
@@ -25,6 +34,8 @@ using namespace Qt::Literals::StringLiterals;
 #include "tracernotificationinterface.h"
 #include <QStandardItemModel>
 
+#include <algorithm>
+
 Q_DECLARE_METATYPE(DebugModel::Message)
 
 ConnectionPage::ConnectionPage(const QString &identifier, QWidget *parent)
@@ -39,6 +50,15 @@ ConnectionPage::ConnectionPage(const QString &identifier, QWidget *parent)
     h->addWidget(mSenderFilter = new KPIM::KCheckComboBox());
     h->setStretchFactor(mSenderFilter, 2);
 
+    auto groupRequests = new QCheckBox(i18nc("@option:check", "Group Requests and Responses"), this);
+    h->addWidget(groupRequests);
+    auto showStatistics = new QPushButton(i18nc("@action:button", "Command Statistics"), this);
+    showStatistics->setCheckable(true);
+    h->addWidget(showStatistics);
+    auto showRates = new QPushButton(i18nc("@action:button", "Connection Meters"), this);
+    showRates->setCheckable(true);
+    h->addWidget(showRates);
+
     mModel = new DebugModel(this);
     mModel->setSenderFilterModel(qobject_cast<QStandardItemModel *>(mSenderFilter->model()));
 
@@ -46,21 +66,124 @@ ConnectionPage::ConnectionPage(const QString &identifier, QWidget *parent)
     mFilterModel->setSourceModel(mModel);
     mFilterModel->setSenderFilter(mSenderFilter);
 
-    auto mDataView = new QTableView(this);
+    mDataView = new QTableView(this);
     mDataView->setModel(mFilterModel);
     mDataView->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
     mDataView->horizontalHeader()->setStretchLastSection(true);
     mDataView->setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
 
-    layout->addWidget(mDataView);
+    mStatisticsModel = new ProtocolStatisticsModel(mModel, this);
+    auto statisticsProxy = new QSortFilterProxyModel(this);
+    statisticsProxy->setSourceModel(mStatisticsModel);
+    statisticsProxy->setSortRole(ProtocolStatisticsModel::SortRole);
+    auto statisticsView = new QTableView(this);
+    statisticsView->setModel(statisticsProxy);
+    statisticsView->setSortingEnabled(true);
+    statisticsView->sortByColumn(ProtocolStatisticsModel::RequestsColumn, Qt::DescendingOrder);
+    statisticsView->verticalHeader()->hide();
+    statisticsView->hide();
+
+    mRateModel = new ConnectionRateModel(mModel, this);
+    auto rateProxy = new QSortFilterProxyModel(this);
+    rateProxy->setSourceModel(mRateModel);
+    rateProxy->setSortRole(ConnectionRateModel::SortRole);
+    auto rateView = new QTableView(this);
+    rateView->setModel(rateProxy);
+    rateView->setSortingEnabled(true);
+    // The noisiest connections first
+    rateView->sortByColumn(ConnectionRateModel::MessageRateColumn, Qt::DescendingOrder);
+    rateView->verticalHeader()->hide();
+    rateView->hide();
+
+    auto splitter = new QSplitter(Qt::Vertical, this);
+    splitter->addWidget(mDataView);
+    splitter->addWidget(statisticsView);
+    splitter->addWidget(rateView);
+    splitter->setStretchFactor(0, 3);
+    splitter->setStretchFactor(1, 1);
+    splitter->setStretchFactor(2, 1);
+    layout->addWidget(splitter);
+
+    connect(groupRequests, &QCheckBox::toggled, this, [this](bool group) {
+        // Responses keep their order within a request, the proxy sorts stably
+        if (group) {
+            mFilterModel->setSortRole(DebugModel::RequestRole);
+            mFilterModel->sort(0);
+        } else {
+            mFilterModel->sort(-1);
+        }
+    });
+    connect(showStatistics, &QPushButton::toggled, this, [this, statisticsView](bool show) {
+        statisticsView->setVisible(show);
+        mStatisticsModel->setActive(show);
+    });
+    connect(showRates, &QPushButton::toggled, this, [this, rateView](bool show) {
+        rateView->setVisible(show);
+        mRateModel->setActive(show);
+    });
 
     auto iface = new org::freedesktop::Akonadi::TracerNotification(QString(), u"/tracing/notifications"_s, QDBusConnection::sessionBus(), this);
 
     connect(iface, &OrgFreedesktopAkonadiTracerNotificationInterface::connectionDataInput, this, &ConnectionPage::connectionDataInput);
     connect(iface, &OrgFreedesktopAkonadiTracerNotificationInterface::connectionDataOutput, this, &ConnectionPage::connectionDataOutput);
-    connect(mDataView->horizontalHeader(), &QHeaderView::sectionResized, mDataView, &QTableView::resizeRowsToContents);
-    connect(mFilterModel, &QAbstractItemModel::modelReset, mDataView, &QTableView::resizeRowsToContents);
-    connect(mFilterModel, &QAbstractItemModel::layoutChanged, mDataView, &QTableView::resizeRowsToContents);
+
+    // Measuring every row with resizeRowsToContents() does not scale to a busy server,
+    // only the rows scrolled into view are measured and their heights are kept
+    mRowResizeTimer.setSingleShot(true);
+    connect(&mRowResizeTimer, &QTimer::timeout, this, &ConnectionPage::resizeVisibleRows);
+    connect(mModel, &QAbstractItemModel::rowsInserted, this, [this](const QModelIndex &, int first, int last) {
+        mRowHeights.insert(mRowHeights.begin() + first, last - first + 1, 0);
+        scheduleRowResize();
+    });
+    connect(mModel, &QAbstractItemModel::rowsRemoved, this, [this](const QModelIndex &, int first, int last) {
+        mRowHeights.erase(mRowHeights.begin() + first, mRowHeights.begin() + last + 1);
+    });
+    connect(mModel, &QAbstractItemModel::modelReset, this, [this]() {
+        mRowHeights.assign(mModel->rowCount(), 0);
+    });
+    connect(mDataView->horizontalHeader(), &QHeaderView::sectionResized, this, [this]() {
+        // Wrapped messages change their height with the column widths
+        std::fill(mRowHeights.begin(), mRowHeights.end(), 0);
+        scheduleRowResize();
+    });
+    connect(mFilterModel, &QAbstractItemModel::modelReset, this, &ConnectionPage::scheduleRowResize);
+    connect(mFilterModel, &QAbstractItemModel::layoutChanged, this, &ConnectionPage::scheduleRowResize);
+    connect(mFilterModel, &QAbstractItemModel::rowsRemoved, this, &ConnectionPage::scheduleRowResize);
+    connect(mDataView->verticalScrollBar(), &QScrollBar::valueChanged, this, &ConnectionPage::scheduleRowResize);
+}
+
+void ConnectionPage::setMaximumCount(int count)
+{
+    mModel->setMaximumCount(count);
+}
+
+void ConnectionPage::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    scheduleRowResize();
+}
+
+void ConnectionPage::scheduleRowResize()
+{
+    if (!mRowResizeTimer.isActive()) {
+        mRowResizeTimer.start();
+    }
+}
+
+void ConnectionPage::resizeVisibleRows()
+{
+    const int viewportHeight = mDataView->viewport()->height();
+    const int rowCount = mFilterModel->rowCount();
+    // Resizing a row moves the ones after it, so go until the viewport is full
+    for (int row = std::max(mDataView->rowAt(0), 0); row < rowCount && mDataView->rowViewportPosition(row) < viewportHeight; ++row) {
+        int &height = mRowHeights[mFilterModel->mapToSource(mFilterModel->index(row, 0)).row()];
+        if (height == 0) {
+            height = mDataView->sizeHintForRow(row);
+        }
+        if (height > 0 && mDataView->rowHeight(row) != height) {
+            mDataView->setRowHeight(row, height);
+        }
+    }
 }
 
 void ConnectionPage::connectionDataInput(const QString &identifier, const QString &msg)
@@ -82,38 +205,43 @@ void ConnectionPage::showAllConnections(bool show)
     mShowAllConnections = show;
 }
 
-QString ConnectionPage::toHtml(QAbstractItemModel *model) const
-{
-    QString ret;
-    int anz = model->rowCount();
-    for (int row = 0; row < anz; row++) {
-        const auto message = model->data(model->index(row, 0), DebugModel::MessageRole).value<DebugModel::Message>();
-        const auto &sender = model->data(model->index(row, DebugModel::SenderColumn)).toString();
-
-        ret += (message.direction == DebugModel::ClientToServer ? u"<- "_s : u"-> "_s);
-        ret += sender + u" "_s + message.message + u"\n"_s;
-    }
-    return ret;
-}
-
-QString ConnectionPage::toHtmlFiltered() const
+DebugExportJob *ConnectionPage::createExportJob(const QString &fileName, DebugExportJob::Format format, bool filtered, QObject *parent) const
 {
-    return toHtml(mFilterModel);
+    return new DebugExportJob(mModel, filtered ? mFilterModel : nullptr, fileName, format, parent);
 }
 
-QString ConnectionPage::toHtml() const
+void ConnectionPage::loadCapture(const QString &fileName)
 {
-    return toHtml(mModel);
+    auto loader = new DebugCaptureLoader(mModel, this);
+    if (!loader->open(fileName)) {
+        QMessageBox::warning(this, i18n("Error"), i18n("Failed to load debugger capture: %1", loader->errorString()));
+        delete loader;
+        return;
+    }
+    loader->startWithProgressDialog(this, i18n("Loading debugger capture..."));
 }
 
 void ConnectionPage::clear()
 {
     mModel->removeRows(0, mModel->rowCount());
+    mModel->resetStatistics();
 }
 
 void ConnectionPage::clearFiltered()
 {
-    mFilterModel->removeRows(0, mFilterModel->rowCount());
+    // The proxy would remove every contiguous range on its own, which is slow when
+    // the filtered messages are scattered over the whole log
+    QList<int> rows;
+    rows.reserve(mFilterModel->rowCount());
+    for (int row = 0, count = mFilterModel->rowCount(); row < count; ++row) {
+        rows << mFilterModel->mapToSource(mFilterModel->index(row, 0)).row();
+    }
+    std::sort(rows.begin(), rows.end());
+    if (rows.count() == mModel->rowCount()) {
+        mModel->removeRows(0, mModel->rowCount());
+    } else {
+        mModel->removeMessages(rows);
+    }
 }
 
 #include "moc_connectionpage.cpp"
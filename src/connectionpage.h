@@ -8,11 +8,17 @@
 
 #pragma once
 
+#include "debugexportjob.h"
+
+#include <QTimer>
 #include <QWidget>
 
+#include <deque>
+
+class ConnectionRateModel;
 class DebugModel;
 class DebugFilterModel;
-class QAbstractItemModel;
+class ProtocolStatisticsModel;
 class QTableView;
 
 namespace KPIM
@@ -28,23 +34,36 @@ public:
     explicit ConnectionPage(const QString &identifier, QWidget *parent = nullptr);
 
     void showAllConnections(bool);
+    /** Maximum number of messages kept, 0 means unlimited. */
+    void setMaximumCount(int count);
 
-    [[nodiscard]] QString toHtml() const;
-    [[nodiscard]] QString toHtmlFiltered() const;
+    /** Creates a job saving the messages, only the ones shown when @p filtered. */
+    [[nodiscard]] DebugExportJob *createExportJob(const QString &fileName, DebugExportJob::Format format, bool filtered, QObject *parent) const;
+    /** Replays the capture in @p fileName instead of the current messages. */
+    void loadCapture(const QString &fileName);
 
 public Q_SLOTS:
     void clear();
     void clearFiltered();
 
+protected:
+    void resizeEvent(QResizeEvent *event) override;
+
 private:
+    void scheduleRowResize();
+    void resizeVisibleRows();
     void connectionDataInput(const QString &, const QString &);
     void connectionDataOutput(const QString &, const QString &);
-    QString toHtml(QAbstractItemModel *model) const;
 
     DebugModel *mModel = nullptr;
     DebugFilterModel *mFilterModel = nullptr;
+    ProtocolStatisticsModel *mStatisticsModel = nullptr;
+    ConnectionRateModel *mRateModel = nullptr;
     QTableView *mDataView = nullptr;
     KPIM::KCheckComboBox *mSenderFilter = nullptr;
     const QString mIdentifier;
     bool mShowAllConnections = false;
+    // Height of each message of the model, 0 until it was shown
+    std::deque<int> mRowHeights;
+    QTimer mRowResizeTimer;
 };
@@ -0,0 +1,169 @@
+/*
+    SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "connectionratemodel.h"
+
+#include "connectionratemonitor.h"
+#include "debugmodel.h"
+
+#include <KLocalizedString>
+
+#include <QDateTime>
+#include <QLocale>
+
+#include <chrono>
+
+using namespace std::chrono_literals;
+
+ConnectionRateModel::ConnectionRateModel(DebugModel *debugModel, QObject *parent)
+    : QAbstractTableModel(parent)
+    , mDebugModel(debugModel)
+{
+    mRefreshTimer.setInterval(1s);
+    connect(&mRefreshTimer, &QTimer::timeout, this, &ConnectionRateModel::refresh);
+    // Removing a connection moves another one into its id, so every row may change
+    connect(mDebugModel, &DebugModel::connectionsAboutToBeRemoved, this, &ConnectionRateModel::beginResetModel);
+    connect(mDebugModel, &DebugModel::connectionsRemoved, this, [this]() {
+        mCount = mDebugModel->connectionRates().count();
+        endResetModel();
+    });
+}
+
+ConnectionRateModel::~ConnectionRateModel() = default;
+
+void ConnectionRateModel::setActive(bool active)
+{
+    if (active) {
+        refresh();
+        mRefreshTimer.start();
+    } else {
+        mRefreshTimer.stop();
+    }
+}
+
+void ConnectionRateModel::refresh()
+{
+    auto &monitor = mDebugModel->connectionRates();
+    // A replayed capture is shown at its own time
+    if (!mDebugModel->isReplay()) {
+        monitor.advanceTo(QDateTime::currentMSecsSinceEpoch());
+    }
+
+    const int count = monitor.count();
+    if (count != mCount) {
+        beginResetModel();
+        mCount = count;
+        endResetModel();
+    } else if (count > 0) {
+        Q_EMIT dataChanged(index(0, 0), index(count - 1, _ColumnCount - 1));
+    }
+}
+
+int ConnectionRateModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : mCount;
+}
+
+int ConnectionRateModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : _ColumnCount;
+}
+
+QVariant ConnectionRateModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal) {
+        return {};
+    }
+
+    if (role == Qt::ToolTipRole) {
+        switch (section) {
+        case MessageRateColumn:
+        case RequestRateColumn:
+        case ResponseRateColumn:
+        case SentBytesRateColumn:
+        case ReceivedBytesRateColumn:
+            return i18np("Average over the last second", "Average over the last %1 seconds", ConnectionRateMonitor::RateSeconds);
+        case MessageCountColumn:
+        case AverageLatencyColumn:
+            return i18np("Within the last second", "Within the last %1 seconds", ConnectionRateMonitor::WindowSeconds);
+        }
+        return {};
+    }
+    if (role != Qt::DisplayRole) {
+        return {};
+    }
+
+    switch (section) {
+    case ConnectionColumn:
+        return i18n("Connection");
+    case MessageRateColumn:
+        return i18n("Messages/s");
+    case RequestRateColumn:
+        return i18n("Requests/s");
+    case ResponseRateColumn:
+        return i18n("Responses/s");
+    case SentBytesRateColumn:
+        return i18n("Sent/s");
+    case ReceivedBytesRateColumn:
+        return i18n("Received/s");
+    case MessageCountColumn:
+        return i18n("Last Minute");
+    case AverageLatencyColumn:
+        return i18n("Average Latency");
+    }
+    return {};
+}
+
+QVariant ConnectionRateModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= mCount || (role != Qt::DisplayRole && role != SortRole && role != Qt::TextAlignmentRole)) {
+        return {};
+    }
+
+    if (role == Qt::TextAlignmentRole) {
+        return index.column() == ConnectionColumn ? QVariant() : QVariant::fromValue(Qt::AlignRight | Qt::AlignVCenter);
+    }
+
+    const auto &monitor = mDebugModel->connectionRates();
+    const int id = index.row();
+    if (id >= monitor.count()) {
+        return {};
+    }
+    const bool display = role == Qt::DisplayRole;
+    const auto rate = [display](double value) -> QVariant {
+        return display ? QVariant(QString::number(value, 'f', 1)) : QVariant(value);
+    };
+    const auto byteRate = [display](double value) -> QVariant {
+        return display ? QVariant(i18nc("@item data size per second", "%1/s", QLocale().formattedDataSize(qint64(value)))) : QVariant(value);
+    };
+
+    switch (index.column()) {
+    case ConnectionColumn:
+        return mDebugModel->displaySender(monitor.identifier(id));
+    case MessageRateColumn:
+        return rate(monitor.messageRate(id, ConnectionRateMonitor::ClientToServer) + monitor.messageRate(id, ConnectionRateMonitor::ServerToClient));
+    case RequestRateColumn:
+        return rate(monitor.messageRate(id, ConnectionRateMonitor::ClientToServer));
+    case ResponseRateColumn:
+        return rate(monitor.messageRate(id, ConnectionRateMonitor::ServerToClient));
+    case SentBytesRateColumn:
+        return byteRate(monitor.byteRate(id, ConnectionRateMonitor::ClientToServer));
+    case ReceivedBytesRateColumn:
+        return byteRate(monitor.byteRate(id, ConnectionRateMonitor::ServerToClient));
+    case MessageCountColumn:
+        return monitor.messageCount(id, ConnectionRateMonitor::ClientToServer) + monitor.messageCount(id, ConnectionRateMonitor::ServerToClient);
+    case AverageLatencyColumn: {
+        const double latency = monitor.averageLatency(id);
+        if (!display) {
+            return latency;
+        }
+        return latency < 0 ? QString() : i18nc("@item latency in milliseconds", "%1 ms", QString::number(latency, 'f', 1));
+    }
+    }
+    return {};
+}
+
+#include "moc_connectionratemodel.cpp"
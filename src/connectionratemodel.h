@@ -0,0 +1,58 @@
+/*
+    SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "libakonadiconsole_export.h"
+
+#include <QAbstractTableModel>
+#include <QTimer>
+
+class DebugModel;
+
+/**
+ * Table of the message rates, throughput and latency of every connection in a DebugModel.
+ */
+class LIBAKONADICONSOLE_EXPORT ConnectionRateModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    enum Columns {
+        ConnectionColumn,
+        MessageRateColumn,
+        RequestRateColumn,
+        ResponseRateColumn,
+        SentBytesRateColumn,
+        ReceivedBytesRateColumn,
+        MessageCountColumn,
+        AverageLatencyColumn,
+
+        _ColumnCount
+    };
+
+    enum Roles {
+        // Raw value of a column, for sorting
+        SortRole = Qt::UserRole
+    };
+
+    explicit ConnectionRateModel(DebugModel *debugModel, QObject *parent = nullptr);
+    ~ConnectionRateModel() override;
+
+    /** The rates are only updated, once a second, while active. */
+    void setActive(bool active);
+
+    [[nodiscard]] int rowCount(const QModelIndex &parent = {}) const override;
+    [[nodiscard]] int columnCount(const QModelIndex &parent = {}) const override;
+    [[nodiscard]] QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
+    [[nodiscard]] QVariant data(const QModelIndex &index, int role) const override;
+
+private:
+    void refresh();
+
+    DebugModel *const mDebugModel;
+    QTimer mRefreshTimer;
+    int mCount = 0;
+};
@@ -0,0 +1,149 @@
+/*
+    SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "connectionratemonitor.h"
+
+#include <algorithm>
+
+int ConnectionRateMonitor::slot(qint64 second)
+{
+    return int((second % WindowSeconds + WindowSeconds) % WindowSeconds);
+}
+
+ConnectionRateMonitor::Connection *ConnectionRateMonitor::connection(const QString &identifier, qint64 second)
+{
+    mCurrentSecond = std::max(mCurrentSecond, second);
+    if (second <= mCurrentSecond - WindowSeconds) {
+        return nullptr;
+    }
+
+    auto it = mIds.constFind(identifier);
+    if (it == mIds.constEnd()) {
+        it = mIds.insert(identifier, int(mConnections.size()));
+        mConnections.push_back({identifier});
+    }
+
+    auto &connection = mConnections[*it];
+    if (second > connection.second) {
+        for (qint64 s = std::max(connection.second + 1, second - WindowSeconds + 1); s <= second; ++s) {
+            const int slot = ConnectionRateMonitor::slot(s);
+            for (int direction = 0; direction < 2; ++direction) {
+                connection.messages[direction][slot] = 0;
+                connection.bytes[direction][slot] = 0;
+            }
+            connection.roundTrips[slot] = 0;
+            connection.latencies[slot] = 0;
+        }
+        connection.second = second;
+    } else if (second <= connection.second - WindowSeconds) {
+        return nullptr;
+    }
+    return &connection;
+}
+
+void ConnectionRateMonitor::addMessage(qint64 timestamp, const QString &identifier, Direction direction, qint64 size)
+{
+    // Negative seconds would look like nothing was counted yet
+    if (timestamp < 0) {
+        return;
+    }
+    const qint64 second = timestamp / 1000;
+    if (auto connection = this->connection(identifier, second)) {
+        ++connection->messages[direction][slot(second)];
+        connection->bytes[direction][slot(second)] += size;
+    }
+}
+
+void ConnectionRateMonitor::addRoundTrip(qint64 timestamp, const QString &identifier, qint64 latency)
+{
+    if (timestamp < 0) {
+        return;
+    }
+    const qint64 second = timestamp / 1000;
+    if (auto connection = this->connection(identifier, second)) {
+        ++connection->roundTrips[slot(second)];
+        connection->latencies[slot(second)] += latency;
+    }
+}
+
+void ConnectionRateMonitor::advanceTo(qint64 timestamp)
+{
+    mCurrentSecond = std::max(mCurrentSecond, timestamp / 1000);
+}
+
+void ConnectionRateMonitor::remove(const QString &identifier)
+{
+    const auto it = mIds.constFind(identifier);
+    if (it == mIds.constEnd()) {
+        return;
+    }
+    // Move the last connection into the gap
+    const int id = *it;
+    mIds.erase(it);
+    if (id != int(mConnections.size()) - 1) {
+        mConnections[id] = std::move(mConnections.back());
+        mIds[mConnections[id].identifier] = id;
+    }
+    mConnections.pop_back();
+}
+
+void ConnectionRateMonitor::clear()
+{
+    mConnections.clear();
+    mIds.clear();
+    mCurrentSecond = -1;
+}
+
+int ConnectionRateMonitor::count() const
+{
+    return int(mConnections.size());
+}
+
+const QString &ConnectionRateMonitor::identifier(int id) const
+{
+    return mConnections[id].identifier;
+}
+
+template<typename T>
+T ConnectionRateMonitor::sum(const Connection &connection, const Window<T> &window, qint64 first, qint64 last) const
+{
+    // Only the seconds up to the last counted one are still in their slots
+    first = std::max(first, connection.second - WindowSeconds + 1);
+    last = std::min(last, connection.second);
+    T total = 0;
+    for (qint64 s = first; s <= last; ++s) {
+        total += window[slot(s)];
+    }
+    return total;
+}
+
+double ConnectionRateMonitor::messageRate(int id, Direction direction) const
+{
+    const auto &connection = mConnections[id];
+    return double(sum(connection, connection.messages[direction], mCurrentSecond - RateSeconds, mCurrentSecond - 1)) / RateSeconds;
+}
+
+double ConnectionRateMonitor::byteRate(int id, Direction direction) const
+{
+    const auto &connection = mConnections[id];
+    return double(sum(connection, connection.bytes[direction], mCurrentSecond - RateSeconds, mCurrentSecond - 1)) / RateSeconds;
+}
+
+quint64 ConnectionRateMonitor::messageCount(int id, Direction direction) const
+{
+    const auto &connection = mConnections[id];
+    return sum(connection, connection.messages[direction], mCurrentSecond - WindowSeconds + 1, mCurrentSecond);
+}
+
+double ConnectionRateMonitor::averageLatency(int id) const
+{
+    const auto &connection = mConnections[id];
+    const quint32 roundTrips = sum(connection, connection.roundTrips, mCurrentSecond - WindowSeconds + 1, mCurrentSecond);
+    if (roundTrips == 0) {
+        return -1.0;
+    }
+    return double(sum(connection, connection.latencies, mCurrentSecond - WindowSeconds + 1, mCurrentSecond)) / roundTrips;
+}
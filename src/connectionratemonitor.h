@@ -0,0 +1,81 @@
+/*
+    SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "libakonadiconsole_export.h"
+
+#include <QHash>
+#include <QString>
+
+#include <array>
+#include <vector>
+
+/**
+ * Per-second message, byte and latency counters of every connection over the last minute.
+ *
+ * Each connection has a fixed ring of per-second counters for either
+ * direction. A connection only clears the seconds it skipped when its next
+ * message arrives, so counting a message is O(1) however many connections
+ * there are, and idle ones cost nothing.
+ */
+class LIBAKONADICONSOLE_EXPORT ConnectionRateMonitor
+{
+public:
+    enum Direction {
+        ClientToServer,
+        ServerToClient
+    };
+
+    static constexpr int WindowSeconds = 60;
+    // Rates are averaged over this many complete seconds
+    static constexpr int RateSeconds = 5;
+
+    /** Messages before the epoch are ignored. */
+    void addMessage(qint64 timestamp, const QString &identifier, Direction direction, qint64 size);
+    /** A request of the connection got its first response after @p latency milliseconds. Ignored before the epoch as well. */
+    void addRoundTrip(qint64 timestamp, const QString &identifier, qint64 latency);
+    /** Closes the seconds before @p timestamp, so that the rates decay when nothing arrives. */
+    void advanceTo(qint64 timestamp);
+    void remove(const QString &identifier);
+    void clear();
+
+    /** Ids change when a connection is removed. */
+    [[nodiscard]] int count() const;
+    [[nodiscard]] const QString &identifier(int id) const;
+    /** Messages and bytes per second over the last RateSeconds. */
+    [[nodiscard]] double messageRate(int id, Direction direction) const;
+    [[nodiscard]] double byteRate(int id, Direction direction) const;
+    /** Messages within the window. */
+    [[nodiscard]] quint64 messageCount(int id, Direction direction) const;
+    /** Average round trip within the window in milliseconds, -1 when there was none. */
+    [[nodiscard]] double averageLatency(int id) const;
+
+private:
+    template<typename T>
+    using Window = std::array<T, WindowSeconds>;
+
+    struct Connection {
+        QString identifier;
+        std::array<Window<quint32>, 2> messages = {};
+        std::array<Window<quint64>, 2> bytes = {};
+        Window<quint32> roundTrips = {};
+        Window<qint64> latencies = {};
+        // Last second counted, the slots of the seconds after it are stale
+        qint64 second = -1;
+    };
+
+    // Slot of @p second in the windows, also for the seconds before the first one
+    [[nodiscard]] static int slot(qint64 second);
+    // Nullptr when the second is already out of the window
+    Connection *connection(const QString &identifier, qint64 second);
+    template<typename T>
+    [[nodiscard]] T sum(const Connection &connection, const Window<T> &window, qint64 first, qint64 last) const;
+
+    std::vector<Connection> mConnections;
+    QHash<QString, int> mIds;
+    qint64 mCurrentSecond = -1;
+};
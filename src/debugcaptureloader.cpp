@@ -0,0 +1,114 @@
+/*
+    SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "debugcaptureloader.h"
+
+#include "debugexportjob.h"
+#include "debugmodel.h"
+
+#include <KLocalizedString>
+
+#include <QtEndian>
+
+namespace
+{
+// Messages replayed at once, every one of them is inserted into the model on its own
+constexpr int BatchSize = 4096;
+constexpr qint64 CaptureHeaderSize = 8;
+// Records without their strings, including the record type
+constexpr qint64 SenderRecordSize = 1 + 4 + 4;
+constexpr qint64 MessageRecordSize = 1 + 8 + 1 + 4 + 4;
+}
+
+DebugCaptureLoader::DebugCaptureLoader(DebugModel *model, QObject *parent)
+    : CaptureLoader(parent)
+    , mModel(model)
+{
+}
+
+DebugCaptureLoader::~DebugCaptureLoader() = default;
+
+bool DebugCaptureLoader::readHeader()
+{
+    if (mSize < CaptureHeaderSize || qFromLittleEndian<quint32>(mData) != DebugExportJob::CaptureMagic) {
+        setErrorString(i18n("The file is not a debugger capture."));
+        return false;
+    }
+    const auto version = qFromLittleEndian<quint32>(mData + 4);
+    if (version != DebugExportJob::CaptureVersion) {
+        setErrorString(i18n("Unsupported capture version %1.", version));
+        return false;
+    }
+    mPosition = CaptureHeaderSize;
+    return true;
+}
+
+void DebugCaptureLoader::clearModel()
+{
+    mModel->startReplay();
+}
+
+bool DebugCaptureLoader::readBatch()
+{
+    int replayed = 0;
+    bool ok = true;
+    while (ok && replayed < BatchSize && mPosition < mSize) {
+        ok = readRecord(replayed);
+    }
+    return ok;
+}
+
+QString DebugCaptureLoader::failureMessage() const
+{
+    return i18n("Failed to load debugger capture: %1", errorString());
+}
+
+bool DebugCaptureLoader::readRecord(int &replayed)
+{
+    const char *data = mData + mPosition;
+    const qint64 available = mSize - mPosition;
+    switch (quint8(data[0])) {
+    case DebugExportJob::SenderRecord: {
+        if (available < SenderRecordSize) {
+            return damaged();
+        }
+        const auto id = qFromLittleEndian<quint32>(data + 1);
+        const auto size = qFromLittleEndian<quint32>(data + 5);
+        // Every sender takes a record, there cannot be more ids than bytes
+        if (id >= mSize || available - SenderRecordSize < size) {
+            return damaged();
+        }
+        if (id >= quint32(mSenders.count())) {
+            mSenders.resize(id + 1);
+        }
+        mSenders[id] = QString::fromUtf8(data + SenderRecordSize, size);
+        mPosition += SenderRecordSize + size;
+        return true;
+    }
+    case DebugExportJob::MessageRecord: {
+        if (available < MessageRecordSize) {
+            return damaged();
+        }
+        const auto direction = quint8(data[9]);
+        const auto sender = qFromLittleEndian<quint32>(data + 10);
+        const auto size = qFromLittleEndian<quint32>(data + 14);
+        if (direction > DebugModel::ServerToClient || sender >= quint32(mSenders.count()) || available - MessageRecordSize < size) {
+            return damaged();
+        }
+
+        mModel->addMessage(mSenders.at(sender),
+                           static_cast<DebugModel::Direction>(direction),
+                           QString::fromUtf8(data + MessageRecordSize, size),
+                           qFromLittleEndian<qint64>(data + 1));
+        mPosition += MessageRecordSize + size;
+        ++replayed;
+        return true;
+    }
+    }
+    return damaged();
+}
+
+#include "moc_debugcaptureloader.cpp"
@@ -0,0 +1,41 @@
+/*
+    SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "captureloader.h"
+
+#include <QStringList>
+
+class DebugModel;
+
+/**
+ * Replays a capture saved by DebugExportJob into a DebugModel.
+ *
+ * The messages go through DebugModel::addMessage() with their original
+ * timestamps, so they are decoded, paired and metered as if they had just
+ * arrived. The meters then show the last minute of the capture.
+ */
+class LIBAKONADICONSOLE_EXPORT DebugCaptureLoader : public CaptureLoader
+{
+    Q_OBJECT
+public:
+    explicit DebugCaptureLoader(DebugModel *model, QObject *parent = nullptr);
+    ~DebugCaptureLoader() override;
+
+protected:
+    bool readHeader() override;
+    void clearModel() override;
+    bool readBatch() override;
+    QString failureMessage() const override;
+
+private:
+    [[nodiscard]] bool readRecord(int &replayed);
+
+    DebugModel *const mModel;
+    // Senders defined so far by the capture, by id
+    QStringList mSenders;
+};
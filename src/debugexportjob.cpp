@@ -0,0 +1,149 @@
+/*
+    SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "debugexportjob.h"
+
+#include <QAbstractProxyModel>
+#include <QHash>
+#include <QIODevice>
+#include <QStringEncoder>
+#include <QtEndian>
+
+namespace
+{
+// Progress is reported every this many messages
+constexpr int ProgressInterval = 1024;
+// The buffer is written out once it grows past this
+constexpr qsizetype FlushSize = 64 * 1024;
+
+template<typename T>
+void appendLittleEndian(QByteArray &out, T value)
+{
+    const T encoded = qToLittleEndian(value);
+    out.append(reinterpret_cast<const char *>(&encoded), sizeof(T));
+}
+
+// Encodes straight into the buffer instead of through a temporary QByteArray
+qsizetype appendUtf8(QByteArray &out, QStringView str)
+{
+    QStringEncoder encoder(QStringEncoder::Utf8);
+    const qsizetype start = out.size();
+    out.resize(start + encoder.requiredSpace(str.size()));
+    char *end = encoder.appendToBuffer(out.data() + start, str);
+    out.truncate(end - out.constData());
+    return out.size() - start;
+}
+}
+
+DebugExportJob::DebugExportJob(const DebugModel *model, const QAbstractProxyModel *filter, const QString &fileName, Format format, QObject *parent)
+    : ExportJob(fileName, parent)
+    , mFormat(format)
+{
+    QHash<QString, int> senderIds;
+    const auto append = [this, model, &senderIds](int row) {
+        const auto &message = model->messageAt(row);
+        auto it = senderIds.constFind(message.sender);
+        if (it == senderIds.constEnd()) {
+            it = senderIds.insert(message.sender, mSenders.count());
+            mSenders << model->displaySender(message.sender);
+        }
+        mMessages.push_back({message.timestamp, *it, message.direction, message.message});
+    };
+
+    if (filter) {
+        const int count = filter->rowCount();
+        mMessages.reserve(count);
+        for (int row = 0; row < count; ++row) {
+            append(filter->mapToSource(filter->index(row, 0)).row());
+        }
+    } else {
+        const int count = model->rowCount();
+        mMessages.reserve(count);
+        for (int row = 0; row < count; ++row) {
+            append(row);
+        }
+    }
+}
+
+DebugExportJob::~DebugExportJob() = default;
+
+bool DebugExportJob::write(QIODevice *device)
+{
+    mEncodedSenders.reserve(mSenders.count());
+    for (const auto &sender : std::as_const(mSenders)) {
+        mEncodedSenders.push_back(sender.toUtf8());
+    }
+
+    mBuffer.reserve(FlushSize + 4096);
+    if (mFormat == Capture) {
+        appendLittleEndian(mBuffer, CaptureMagic);
+        appendLittleEndian(mBuffer, CaptureVersion);
+        mWrittenSenders.assign(mSenders.count(), false);
+    }
+    const auto flush = [this, device]() {
+        const bool written = device->write(mBuffer) == mBuffer.size();
+        mBuffer.clear();
+        return written;
+    };
+
+    const auto count = qint64(mMessages.size());
+    for (qint64 i = 0; i < count; ++i) {
+        if (i % ProgressInterval == 0) {
+            if (isCanceled()) {
+                return false;
+            }
+            reportProgress(i, count);
+        }
+
+        switch (mFormat) {
+        case Text:
+            appendText(mMessages[i]);
+            break;
+        case Capture:
+            appendCapture(mMessages[i]);
+            break;
+        }
+        if (mBuffer.size() >= FlushSize && !flush()) {
+            return false;
+        }
+    }
+
+    return flush();
+}
+
+void DebugExportJob::appendText(const Message &message)
+{
+    // Same as the format the Debugger always saved
+    mBuffer += message.direction == DebugModel::ClientToServer ? "<- " : "-> ";
+    mBuffer += mEncodedSenders[message.sender];
+    mBuffer += ' ';
+    appendUtf8(mBuffer, message.text);
+    mBuffer += '\n';
+}
+
+void DebugExportJob::appendCapture(const Message &message)
+{
+    if (!mWrittenSenders[message.sender]) {
+        mWrittenSenders[message.sender] = true;
+        const QByteArray &sender = mEncodedSenders[message.sender];
+        mBuffer += char(SenderRecord);
+        appendLittleEndian(mBuffer, quint32(message.sender));
+        appendLittleEndian(mBuffer, quint32(sender.size()));
+        mBuffer += sender;
+    }
+
+    mBuffer += char(MessageRecord);
+    appendLittleEndian(mBuffer, message.timestamp);
+    appendLittleEndian(mBuffer, quint8(message.direction));
+    appendLittleEndian(mBuffer, quint32(message.sender));
+    // The size is only known once the text is encoded
+    const qsizetype sizePosition = mBuffer.size();
+    appendLittleEndian(mBuffer, quint32(0));
+    const auto size = quint32(appendUtf8(mBuffer, message.text));
+    qToLittleEndian(size, mBuffer.data() + sizePosition);
+}
+
+#include "moc_debugexportjob.cpp"
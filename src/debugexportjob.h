@@ -0,0 +1,78 @@
+/*
+    SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "debugmodel.h"
+#include "exportjob.h"
+
+#include <QByteArray>
+#include <QStringList>
+
+#include <vector>
+
+class QAbstractProxyModel;
+
+/**
+ * Writes the protocol messages of a DebugModel to a file.
+ *
+ * The messages are copied when the job is created, either all of them or the
+ * ones shown by a filter, so the Debugger keeps receiving messages while the
+ * file is written. The Text format is one line per message, with its direction,
+ * sender and text.
+ *
+ * The Capture format is a compact binary form for replaying the messages with
+ * DebugCaptureLoader. After the magic and version, the file is a sequence of
+ * records, each starting with its CaptureRecord type:
+ * - SenderRecord: quint32 id, quint32 size, UTF-8 sender
+ * - MessageRecord: qint64 timestamp, quint8 direction, quint32 sender id,
+ *   quint32 size, UTF-8 text
+ * Every sender is defined before its first message, and all numbers are
+ * little endian.
+ */
+class LIBAKONADICONSOLE_EXPORT DebugExportJob : public ExportJob
+{
+    Q_OBJECT
+public:
+    enum Format {
+        Text,
+        Capture
+    };
+    Q_ENUM(Format)
+
+    static constexpr quint32 CaptureMagic = 0x43444b41; // "AKDC"
+    static constexpr quint32 CaptureVersion = 1;
+    enum CaptureRecord : quint8 {
+        SenderRecord,
+        MessageRecord
+    };
+
+    /** Exports the messages shown by @p filter, or all messages of @p model without one. */
+    DebugExportJob(const DebugModel *model, const QAbstractProxyModel *filter, const QString &fileName, Format format, QObject *parent = nullptr);
+    ~DebugExportJob() override;
+
+protected:
+    bool write(QIODevice *device) override;
+
+private:
+    struct Message {
+        qint64 timestamp;
+        int sender;
+        DebugModel::Direction direction;
+        QString text;
+    };
+
+    void appendText(const Message &message);
+    void appendCapture(const Message &message);
+
+    std::vector<Message> mMessages;
+    // As shown in the Sender column, which is also how they were received
+    QStringList mSenders;
+    const Format mFormat;
+    std::vector<QByteArray> mEncodedSenders;
+    std::vector<bool> mWrittenSenders;
+    QByteArray mBuffer;
+};
@@ -52,8 +52,7 @@ void DebugFilterModel::setSenderFilter(KCheckComboBox *senderFilter)
 bool DebugFilterModel::filterAcceptsRow(int source_row, const QModelIndex &) const
 {
     const auto source_idx = sourceModel()->index(source_row, 0);
-    const auto msg = sourceModel()->data(source_idx, DebugModel::MessageRole).value<DebugModel::Message>();
-    return mCheckedSenders.contains(msg.sender);
+    return mCheckedSenders.contains(sourceModel()->data(source_idx, DebugModel::IdentifierRole).toString());
 }
 
 #include "moc_debugfiltermodel.cpp"
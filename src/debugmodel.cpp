@@ -10,12 +10,25 @@ using namespace Qt::Literals::StringLiterals;
 #include <KLocalizedString>
 
 #include <QColor>
+#include <QDateTime>
 #include <QStandardItemModel>
 
+#include <algorithm>
+
 #ifndef COMPILE_WITH_UNITY_CMAKE_SUPPORT
 Q_DECLARE_METATYPE(DebugModel::Message)
 #endif
 
+namespace
+{
+// The buffer grows from this size up to the maximum count
+constexpr int InitialCapacity = 1024;
+// Share of the maximum count dropped at once when the buffer is full
+constexpr int DropDivisor = 16;
+// Pending requests are pruned once there are more than this
+constexpr int MaximumPendingRequests = 10'000;
+}
+
 DebugModel::DebugModel(QObject *parent)
     : QAbstractItemModel(parent)
 {
@@ -60,47 +73,263 @@ QString DebugModel::cacheString(const QString &str, QMap<QString, QString> &cach
 
 void DebugModel::addMessage(const QString &sender, DebugModel::Direction direction, const QString &message)
 {
-    beginInsertRows({}, mMessages.count(), mMessages.count());
-    mMessages.push_back({cacheString(sender, mSenderCache, mSenderFilterModel), direction, message});
+    mReplay = false;
+    addMessage(sender, direction, message, QDateTime::currentMSecsSinceEpoch());
+}
+
+void DebugModel::addMessage(const QString &sender, Direction direction, const QString &message, qint64 timestamp)
+{
+    if (mMaximumCount > 0 && mCount >= mMaximumCount) {
+        dropOldest(std::max(mMaximumCount / DropDivisor, 1));
+    }
+    reserveSlot();
+
+    const QString identifier = cacheString(sender, mSenderCache, mSenderFilterModel);
+    ++mSenderCounts[identifier];
+    Message msg{identifier, direction, message, timestamp, mNextSerial++, ProtocolDecoder::decode(message)};
+    mConnectionRates.addMessage(timestamp,
+                                identifier,
+                                direction == ClientToServer ? ConnectionRateMonitor::ClientToServer : ConnectionRateMonitor::ServerToClient,
+                                msg.protocol.size);
+    pairMessage(msg);
+
+    beginInsertRows({}, mCount, mCount);
+    mMessages[(mFirst + mCount) % mMessages.size()] = std::move(msg);
+    ++mCount;
     endInsertRows();
 }
 
+void DebugModel::pairMessage(Message &message)
+{
+    message.requestSerial = message.serial;
+    const auto &protocol = message.protocol;
+    if (message.direction == ClientToServer) {
+        mStatistics.addRequest(protocol.command, protocol.size);
+        if (protocol.tag >= 0) {
+            mPendingRequests.insert({message.sender, protocol.tag}, {message.serial, message.timestamp, false});
+            if (mPendingRequests.size() > MaximumPendingRequests) {
+                prunePendingRequests();
+            }
+        }
+        return;
+    }
+
+    // A request can have many responses, the first one completes the round trip
+    qint64 roundTrip = -1;
+    const auto it = protocol.tag >= 0 ? mPendingRequests.find({message.sender, protocol.tag}) : mPendingRequests.end();
+    if (it != mPendingRequests.end()) {
+        message.requestSerial = it->serial;
+        message.latency = message.timestamp - it->timestamp;
+        if (!it->answered) {
+            it->answered = true;
+            roundTrip = message.latency;
+            mConnectionRates.addRoundTrip(message.timestamp, message.sender, roundTrip);
+            const int row = rowOfSerial(it->serial);
+            if (row >= 0) {
+                this->message(row).latency = roundTrip;
+                const QModelIndex latencyIndex = index(row, LatencyColumn);
+                Q_EMIT dataChanged(latencyIndex, latencyIndex);
+            }
+        }
+    }
+    mStatistics.addResponse(protocol.command, protocol.size, roundTrip);
+}
+
+int DebugModel::rowOfSerial(qint64 serial) const
+{
+    // Serials increase with the rows
+    int first = 0;
+    int last = mCount;
+    while (first < last) {
+        const int middle = first + (last - first) / 2;
+        if (message(middle).serial < serial) {
+            first = middle + 1;
+        } else {
+            last = middle;
+        }
+    }
+    return first < mCount && message(first).serial == serial ? first : -1;
+}
+
+void DebugModel::prunePendingRequests()
+{
+    // Forget the requests that were dropped and those older than the last messages, leaving
+    // room for as many new ones before the next pruning. Later responses to them are not paired.
+    const qint64 firstSerial = std::max(mCount > 0 ? message(0).serial : mNextSerial, mNextSerial - MaximumPendingRequests / 2);
+    for (auto it = mPendingRequests.begin(); it != mPendingRequests.end();) {
+        if (it->serial < firstSerial) {
+            it = mPendingRequests.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+const ProtocolStatistics &DebugModel::statistics() const
+{
+    return mStatistics;
+}
+
+void DebugModel::resetStatistics()
+{
+    mStatistics.clear();
+}
+
+ConnectionRateMonitor &DebugModel::connectionRates()
+{
+    return mConnectionRates;
+}
+
+void DebugModel::startReplay()
+{
+    removeRows(0, mCount);
+    mStatistics.clear();
+    // The rows took the meters of their connections along, only the clock of the live messages is left
+    Q_EMIT connectionsAboutToBeRemoved();
+    mConnectionRates.clear();
+    Q_EMIT connectionsRemoved();
+    mReplay = true;
+}
+
+bool DebugModel::isReplay() const
+{
+    return mReplay;
+}
+
+int DebugModel::maximumCount() const
+{
+    return mMaximumCount;
+}
+
+void DebugModel::setMaximumCount(int count)
+{
+    mMaximumCount = std::max(count, 0);
+    if (mMaximumCount > 0 && mCount > mMaximumCount) {
+        dropOldest(mCount - mMaximumCount);
+    }
+}
+
+void DebugModel::dropOldest(int count)
+{
+    count = std::min(count, mCount);
+    if (count <= 0) {
+        return;
+    }
+    beginRemoveRows({}, 0, count - 1);
+    QSet<QString> unusedSenders;
+    for (int i = 0; i < count; ++i) {
+        auto &message = mMessages[(mFirst + i) % mMessages.size()];
+        releaseSender(message.sender, unusedSenders);
+        message = {};
+    }
+    mFirst = (mFirst + count) % mMessages.size();
+    mCount -= count;
+    removeSenders(unusedSenders);
+    endRemoveRows();
+}
+
+void DebugModel::reserveSlot()
+{
+    if (mCount < mMessages.size()) {
+        return;
+    }
+    // Only grows while below the maximum count, and only then the messages move
+    linearize();
+    int capacity = std::max<int>(mMessages.size() * 2, InitialCapacity);
+    if (mMaximumCount > 0) {
+        capacity = std::min(capacity, mMaximumCount);
+    }
+    mMessages.resize(std::max<int>(capacity, mCount + 1));
+}
+
+void DebugModel::linearize()
+{
+    if (mFirst != 0) {
+        std::rotate(mMessages.begin(), mMessages.begin() + mFirst, mMessages.end());
+        mFirst = 0;
+    }
+}
+
 bool DebugModel::removeRows(int row, int count, const QModelIndex &parent)
 {
-    if (parent.isValid()) {
+    if (parent.isValid() || row < 0 || count <= 0 || row + count > mCount) {
         return false;
     }
 
     beginRemoveRows(parent, row, row + count - 1);
+    QSet<QString> unusedSenders;
+    for (int i = row; i < row + count; ++i) {
+        releaseSender(message(i).sender, unusedSenders);
+    }
+    linearize();
     mMessages.remove(row, count);
+    mCount -= count;
+    if (mCount == 0) {
+        // Nothing that arrives next belongs to the requests that are gone
+        mPendingRequests.clear();
+    }
+    removeSenders(unusedSenders);
+    endRemoveRows();
+    return true;
+}
 
-    QList<QString> toDelete;
+void DebugModel::removeMessages(const QList<int> &rows)
+{
+    if (rows.isEmpty()) {
+        return;
+    }
 
-    // find elements that needs to be deleted.
-    for (const auto &identifier : mSenderCache.keys()) {
-        bool found = false;
-        for (const auto &msg : std::as_const(mMessages)) {
-            if (msg.sender == identifier) {
-                found = true;
-                break;
+    beginResetModel();
+    linearize();
+    QSet<QString> unusedSenders;
+    int next = 0;
+    int kept = 0;
+    for (int row = 0; row < mCount; ++row) {
+        if (next < rows.count() && rows.at(next) == row) {
+            releaseSender(mMessages.at(row).sender, unusedSenders);
+            ++next;
+        } else {
+            if (kept != row) {
+                mMessages[kept] = std::move(mMessages[row]);
             }
-        }
-        if (!found) {
-            toDelete.push_back(identifier);
+            ++kept;
         }
     }
+    mMessages.resize(kept);
+    mCount = kept;
+    removeSenders(unusedSenders);
+    endResetModel();
+}
 
-    // Update senderCache and senderFilterModel
-    for (const auto &i : toDelete) {
-        const auto &item = mSenderFilterModel->findItems(displaySender(i));
-        if (!item.isEmpty()) {
-            const auto &index = item.first()->index();
-            mSenderFilterModel->removeRows(index.row(), 1);
+void DebugModel::releaseSender(const QString &identifier, QSet<QString> &unusedSenders)
+{
+    auto it = mSenderCounts.find(identifier);
+    if (it != mSenderCounts.end() && --*it == 0) {
+        unusedSenders.insert(identifier);
+    }
+}
+
+void DebugModel::removeSenders(const QSet<QString> &identifiers)
+{
+    if (identifiers.isEmpty()) {
+        return;
+    }
+
+    Q_EMIT connectionsAboutToBeRemoved();
+    for (const auto &identifier : identifiers) {
+        mSenderCounts.remove(identifier);
+        mSenderCache.remove(identifier);
+        mConnectionRates.remove(identifier);
+    }
+    Q_EMIT connectionsRemoved();
+    if (mSenderFilterModel) {
+        // One pass over the filter items, instead of looking each sender up
+        for (int row = mSenderFilterModel->rowCount() - 1; row >= 0; --row) {
+            if (identifiers.contains(mSenderFilterModel->item(row)->data(IdentifierRole).toString())) {
+                mSenderFilterModel->removeRow(row);
+            }
         }
-        mSenderCache.remove(i);
     }
-    endRemoveRows();
-    return true;
 }
 
 void DebugModel::setSenderFilterModel(QStandardItemModel *senderFilterModel)
@@ -110,7 +339,7 @@ void DebugModel::setSenderFilterModel(QStandardItemModel *senderFilterModel)
 
 int DebugModel::rowCount(const QModelIndex &parent) const
 {
-    return parent.isValid() ? 0 : mMessages.count();
+    return parent.isValid() ? 0 : mCount;
 }
 
 int DebugModel::columnCount(const QModelIndex &) const
@@ -120,7 +349,7 @@ int DebugModel::columnCount(const QModelIndex &) const
 
 QModelIndex DebugModel::index(int row, int column, const QModelIndex &parent) const
 {
-    if (parent.isValid() || row < 0 || row >= mMessages.count() || column < 0 || column >= _ColumnCount) {
+    if (parent.isValid() || row < 0 || row >= mCount || column < 0 || column >= _ColumnCount) {
         return {};
     }
 
@@ -143,6 +372,14 @@ QVariant DebugModel::headerData(int section, Qt::Orientation orientation, int ro
         return i18n("Sender");
     case DirectionColumn:
         return i18n("Direction");
+    case TagColumn:
+        return i18n("Tag");
+    case CommandColumn:
+        return i18n("Command");
+    case SizeColumn:
+        return i18n("Size");
+    case LatencyColumn:
+        return i18n("Latency");
     case MessageColumn:
         return i18n("Message");
     }
@@ -151,11 +388,11 @@ QVariant DebugModel::headerData(int section, Qt::Orientation orientation, int ro
 
 QVariant DebugModel::data(const QModelIndex &index, int role) const
 {
-    if (!index.isValid() || index.row() >= mMessages.count() || index.column() >= _ColumnCount) {
+    if (!index.isValid() || index.row() >= mCount || index.column() >= _ColumnCount) {
         return {};
     }
 
-    const auto message = mMessages.at(index.row());
+    const auto &message = this->message(index.row());
     if (role == Qt::DisplayRole) {
         switch (index.column()) {
         case SenderColumn:
@@ -168,9 +405,24 @@ QVariant DebugModel::data(const QModelIndex &index, int role) const
                 return u"->"_s;
             }
             return {};
+        case TagColumn:
+            return message.protocol.tag >= 0 ? QVariant(message.protocol.tag) : QVariant();
+        case CommandColumn:
+            return message.protocol.command;
+        case SizeColumn:
+            return message.protocol.size;
+        case LatencyColumn:
+            return message.latency >= 0 ? i18nc("latency in milliseconds", "%1 ms", message.latency) : QString();
         case MessageColumn:
             return message.message;
         }
+    } else if (role == Qt::TextAlignmentRole) {
+        switch (index.column()) {
+        case TagColumn:
+        case SizeColumn:
+        case LatencyColumn:
+            return QVariant::fromValue(Qt::AlignRight | Qt::AlignVCenter);
+        }
     } else if (role == Qt::ToolTipRole) {
         switch (index.column()) {
         case MessageColumn:
@@ -186,6 +438,8 @@ QVariant DebugModel::data(const QModelIndex &index, int role) const
         return QVariant::fromValue(message);
     } else if (role == IdentifierRole) {
         return message.sender;
+    } else if (role == RequestRole) {
+        return message.requestSerial;
     }
 
     return {};
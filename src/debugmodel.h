@@ -6,12 +6,30 @@
 
 #pragma once
 
+#include "connectionratemonitor.h"
+#include "libakonadiconsole_export.h"
+#include "protocoldecoder.h"
+#include "protocolstatistics.h"
+
 #include <QAbstractItemModel>
+#include <QHash>
 #include <QMap>
+#include <QSet>
 
 class QStandardItemModel;
 
-class DebugModel : public QAbstractItemModel
+/**
+ * The protocol messages exchanged between the Akonadi server and its clients.
+ *
+ * Messages are kept in a ring buffer with a maximum size, once it is full the
+ * oldest messages are dropped in chunks so that adding a message stays O(1).
+ *
+ * Every message is decoded once when it arrives. Requests are paired with the
+ * responses carrying the same tag on the same connection, which gives their
+ * round-trip latency and the per-command statistics(). The throughput and
+ * latency of every connection are metered by connectionRates().
+ */
+class LIBAKONADICONSOLE_EXPORT DebugModel : public QAbstractItemModel
 {
     Q_OBJECT
 public:
@@ -24,28 +42,72 @@ public:
         QString sender;
         Direction direction;
         QString message;
+        // Milliseconds since the epoch, when the message was received
+        qint64 timestamp = 0;
+        // Increases with every message, unlike the row
+        qint64 serial = 0;
+        ProtocolMessage protocol;
+        // Serial of the request this message belongs to, its own one for requests and unpaired messages
+        qint64 requestSerial = -1;
+        // Milliseconds from the request to this response, or to the first response of this request, -1 when unknown
+        qint64 latency = -1;
     };
 
     enum Roles {
         MessageRole = Qt::UserRole,
-        IdentifierRole
+        IdentifierRole,
+        // Sorting by it groups every request with its responses
+        RequestRole
     };
 
     enum Columns {
         DirectionColumn,
         SenderColumn,
+        TagColumn,
+        CommandColumn,
+        SizeColumn,
+        LatencyColumn,
         MessageColumn,
 
         _ColumnCount
     };
 
+    static constexpr int DefaultMaximumCount = 200'000;
+
     explicit DebugModel(QObject *parent = nullptr);
     ~DebugModel() override;
 
     void addMessage(const QString &sender, Direction direction, const QString &message);
+    /** Same as addMessage(), for messages received at @p timestamp. */
+    void addMessage(const QString &sender, Direction direction, const QString &message, qint64 timestamp);
+
+    /** Maximum number of messages kept, 0 means unlimited. */
+    [[nodiscard]] int maximumCount() const;
+    void setMaximumCount(int count);
 
     void setSenderFilterModel(QStandardItemModel *senderFilterModel);
 
+    [[nodiscard]] const Message &messageAt(int row) const
+    {
+        return message(row);
+    }
+
+    [[nodiscard]] const ProtocolStatistics &statistics() const;
+    void resetStatistics();
+    /** Meters of the connections that still have messages. */
+    [[nodiscard]] ConnectionRateMonitor &connectionRates();
+
+    /**
+     * Removes all messages, statistics and meters before a capture is replayed.
+     * Until the next live message the meters keep the time of the replayed
+     * messages, instead of following the clock.
+     */
+    void startReplay();
+    [[nodiscard]] bool isReplay() const;
+
+    /** Name of the connection with @p identifier, as in the Sender column. */
+    [[nodiscard]] QString displaySender(const QString &identifier) const;
+
     int rowCount(const QModelIndex &parent = {}) const override;
     int columnCount(const QModelIndex &parent = {}) const override;
 
@@ -56,12 +118,54 @@ public:
     QVariant data(const QModelIndex &index, int role) const override;
 
     bool removeRows(int row, int count, const QModelIndex &parent = QModelIndex()) override;
+    /** Removes the messages at the sorted @p rows at once, with a model reset. */
+    void removeMessages(const QList<int> &rows);
+
+Q_SIGNALS:
+    /** Emitted around removing the meters of connections without messages, the ids of the others change. */
+    void connectionsAboutToBeRemoved();
+    void connectionsRemoved();
 
 private:
+    [[nodiscard]] const Message &message(int row) const
+    {
+        return mMessages[(mFirst + row) % mMessages.size()];
+    }
+    [[nodiscard]] Message &message(int row)
+    {
+        return mMessages[(mFirst + row) % mMessages.size()];
+    }
+    void dropOldest(int count);
+    void reserveSlot();
+    void linearize();
+    // Counts a message of the sender as gone, adds the sender to unusedSenders at the last one
+    void releaseSender(const QString &identifier, QSet<QString> &unusedSenders);
+    void removeSenders(const QSet<QString> &identifiers);
+    void pairMessage(Message &message);
+    [[nodiscard]] int rowOfSerial(qint64 serial) const;
+    void prunePendingRequests();
+
     QString cacheString(const QString &str, QMap<QString, QString> &cache, QStandardItemModel *model = nullptr);
-    QString displaySender(const QString &identifier) const;
 
+    // Ring buffer, the oldest message is at mFirst
     QList<Message> mMessages;
+    int mFirst = 0;
+    int mCount = 0;
+    int mMaximumCount = DefaultMaximumCount;
     QStandardItemModel *mSenderFilterModel = nullptr;
     QMap<QString, QString> mSenderCache;
+    // Number of messages of each sender
+    QHash<QString, int> mSenderCounts;
+
+    struct PendingRequest {
+        qint64 serial;
+        qint64 timestamp;
+        bool answered;
+    };
+    // Requests by connection and tag, until a new request reuses the tag or they get old
+    QHash<QPair<QString, qint64>, PendingRequest> mPendingRequests;
+    qint64 mNextSerial = 0;
+    ProtocolStatistics mStatistics;
+    ConnectionRateMonitor mConnectionRates;
+    bool mReplay = false;
 };
@@ -10,20 +10,33 @@
 using namespace Qt::Literals::StringLiterals;
 
 #include "connectionpage.h"
+#include "debugmodel.h"
+#include "tracereventdelegate.h"
 #include "tracernotificationinterface.h"
 
 #include <Akonadi/ControlGui>
 
 #include <Akonadi/ServerManager>
 #include <KLocalizedString>
-#include <KTextEdit>
 
 #include <QCheckBox>
+#include <QDateTime>
 #include <QFileDialog>
+#include <QHeaderView>
+#include <QLabel>
 #include <QPushButton>
+#include <QScrollBar>
+#include <QSpinBox>
 #include <QSplitter>
+#include <QTreeView>
 #include <QVBoxLayout>
 
+#include <KConfigGroup>
+#include <KSharedConfig>
+
+#include <chrono>
+
+using namespace std::chrono_literals;
 using org::freedesktop::Akonadi::DebugInterface;
 
 DebugWidget::DebugWidget(QWidget *parent)
@@ -37,10 +50,10 @@ DebugWidget::DebugWidget(QWidget *parent)
         service += u'.' + Akonadi::ServerManager::instanceIdentifier();
     }
     mDebugInterface = new DebugInterface(service, u"/debug"_s, QDBusConnection::sessionBus(), this);
-    auto cb = new QCheckBox(i18nc("@option:check", "Enable debugger"), this);
-    cb->setChecked(mDebugInterface->isValid() && mDebugInterface->tracer().value() == "dbus"_L1);
-    connect(cb, &QCheckBox::toggled, this, &DebugWidget::enableDebugger);
-    layout->addWidget(cb);
+    mEnableCheck = new QCheckBox(i18nc("@option:check", "Enable debugger"), this);
+    mEnableCheck->setChecked(mDebugInterface->isValid() && mDebugInterface->tracer().value() == "dbus"_L1);
+    connect(mEnableCheck, &QCheckBox::toggled, this, &DebugWidget::enableDebugger);
+    layout->addWidget(mEnableCheck);
 
     auto splitter = new QSplitter(Qt::Vertical, this);
     splitter->setObjectName("debugSplitter"_L1);
@@ -49,8 +62,19 @@ DebugWidget::DebugWidget(QWidget *parent)
     mConnectionPage = new ConnectionPage(i18n("All"), splitter);
     mConnectionPage->showAllConnections(true);
 
-    mGeneralView = new KTextEdit(splitter);
-    mGeneralView->setReadOnly(true);
+    mEventModel = new TracerEventModel(this);
+    mGeneralView = new QTreeView(splitter);
+    mGeneralView->setModel(mEventModel);
+    mGeneralView->setItemDelegate(new TracerEventDelegate(mGeneralView));
+    mGeneralView->setRootIsDecorated(false);
+    // Only the rows in view are laid out, however many events there are
+    mGeneralView->setUniformRowHeights(true);
+    mGeneralView->setAllColumnsShowFocus(true);
+    mGeneralView->setTextElideMode(Qt::ElideMiddle);
+
+    mFlushTimer.setInterval(16ms);
+    mFlushTimer.setSingleShot(true);
+    connect(&mFlushTimer, &QTimer::timeout, this, &DebugWidget::flushEvents);
 
     auto iface = new org::freedesktop::Akonadi::TracerNotification(QString(), u"/tracing/notifications"_s, QDBusConnection::sessionBus(), this);
 
@@ -66,72 +90,125 @@ DebugWidget::DebugWidget(QWidget *parent)
     auto clearAllButton = new QPushButton(i18nc("@action:button", "Clear All Messages"), this);
     auto saveRichtextButton = new QPushButton(i18nc("@action:button", "Save Filtered Messages ..."), this);
     auto saveRichtextEverythingButton = new QPushButton(i18nc("@action:button", "Save All Messages ..."), this);
+    auto loadCaptureButton = new QPushButton(i18nc("@action:button", "Load Capture..."), this);
 
     buttonLayout->addWidget(clearFilteredButton);
     buttonLayout->addWidget(clearAllButton);
     buttonLayout->addWidget(clearGeneralButton);
     buttonLayout->addWidget(saveRichtextButton);
     buttonLayout->addWidget(saveRichtextEverythingButton);
+    buttonLayout->addWidget(loadCaptureButton);
+    buttonLayout->addStretch(1);
+
+    buttonLayout->addWidget(new QLabel(i18nc("@label:spinbox", "Keep at most:"), this));
+    mMaximumCountSpin = new QSpinBox(this);
+    mMaximumCountSpin->setRange(0, 100'000'000);
+    mMaximumCountSpin->setSingleStep(100'000);
+    mMaximumCountSpin->setSuffix(i18nc("@label:spinbox suffix", " messages"));
+    mMaximumCountSpin->setSpecialValueText(i18nc("@label:spinbox no limit of messages", "Unlimited"));
+    buttonLayout->addWidget(mMaximumCountSpin);
+    connect(mMaximumCountSpin, &QSpinBox::valueChanged, mConnectionPage, &ConnectionPage::setMaximumCount);
 
     connect(clearFilteredButton, &QPushButton::clicked, mConnectionPage, &ConnectionPage::clearFiltered);
     connect(clearAllButton, &QPushButton::clicked, mConnectionPage, &ConnectionPage::clear);
-    connect(clearGeneralButton, &QPushButton::clicked, mGeneralView, &KTextEdit::clear);
-    connect(saveRichtextButton, &QPushButton::clicked, this, &DebugWidget::saveRichText);
-    connect(saveRichtextEverythingButton, &QPushButton::clicked, this, &DebugWidget::saveEverythingRichText);
+    connect(clearGeneralButton, &QPushButton::clicked, this, &DebugWidget::clearEvents);
+    connect(saveRichtextButton, &QPushButton::clicked, this, [this]() {
+        saveMessages(true);
+    });
+    connect(saveRichtextEverythingButton, &QPushButton::clicked, this, [this]() {
+        saveMessages(false);
+    });
+    connect(loadCaptureButton, &QPushButton::clicked, this, &DebugWidget::loadCapture);
+
+    KConfigGroup config(KSharedConfig::openConfig(), u"Debugger"_s);
+    mMaximumCountSpin->setValue(config.readEntry("maximumCount", DebugModel::DefaultMaximumCount));
+    mConnectionPage->setMaximumCount(mMaximumCountSpin->value());
 
     Akonadi::ControlGui::widgetNeedsAkonadi(this);
 }
 
+DebugWidget::~DebugWidget()
+{
+    KConfigGroup config(KSharedConfig::openConfig(), u"Debugger"_s);
+    config.writeEntry("maximumCount", mMaximumCountSpin->value());
+}
+
 void DebugWidget::signalEmitted(const QString &signalName, const QString &msg)
 {
-    mGeneralView->append(u"<font color=\"green\">%1 ( %2 )</font>"_s.arg(signalName, msg));
+    addEvent(TracerEventModel::Signal, signalName, msg);
 }
 
 void DebugWidget::warningEmitted(const QString &componentName, const QString &msg)
 {
-    mGeneralView->append(u"<font color=\"blue\">%1: %2</font>"_s.arg(componentName, msg));
+    addEvent(TracerEventModel::Warning, componentName, msg);
 }
 
 void DebugWidget::errorEmitted(const QString &componentName, const QString &msg)
 {
-    mGeneralView->append(u"<font color=\"red\">%1: %2</font>"_s.arg(componentName, msg));
+    addEvent(TracerEventModel::Error, componentName, msg);
 }
 
-void DebugWidget::enableDebugger(bool enable)
+void DebugWidget::addEvent(TracerEventModel::Severity severity, const QString &component, const QString &message)
 {
-    mDebugInterface->setTracer(enable ? u"dbus"_s : u"null"_s);
+    mPendingEvents.push_back({QDateTime::currentMSecsSinceEpoch(), severity, component, message});
+    if (!mFlushTimer.isActive()) {
+        mFlushTimer.start();
+    }
 }
 
-void DebugWidget::saveRichText()
+void DebugWidget::flushEvents()
 {
-    const QString fileName = QFileDialog::getSaveFileName(this);
-    if (fileName.isEmpty()) {
-        return;
+    // Follow the new events, unless scrolled away from them
+    const QScrollBar *scrollBar = mGeneralView->verticalScrollBar();
+    const bool atBottom = scrollBar->value() == scrollBar->maximum();
+    mEventModel->addEvents(mPendingEvents);
+    mPendingEvents.clear();
+    if (atBottom) {
+        mGeneralView->scrollToBottom();
     }
+}
 
-    QFile file(fileName);
-    if (!file.open(QIODevice::WriteOnly)) {
-        return;
-    }
+void DebugWidget::clearEvents()
+{
+    mFlushTimer.stop();
+    mPendingEvents.clear();
+    mEventModel->clear();
+}
 
-    file.write(mConnectionPage->toHtmlFiltered().toUtf8());
-    file.close();
+void DebugWidget::enableDebugger(bool enable)
+{
+    mDebugInterface->setTracer(enable ? u"dbus"_s : u"null"_s);
 }
 
-void DebugWidget::saveEverythingRichText()
+void DebugWidget::saveMessages(bool filtered)
 {
-    const QString fileName = QFileDialog::getSaveFileName(this);
+    const QString textFilter = i18n("Text Files (*.txt)");
+    const QString captureFilter = i18n("Debugger Captures (*.akdebug)");
+    QString selectedFilter = textFilter;
+    const QString fileName =
+        QFileDialog::getSaveFileName(this, i18n("Save to File..."), QString(), u"%1;;%2"_s.arg(textFilter, captureFilter), &selectedFilter);
     if (fileName.isEmpty()) {
         return;
     }
 
-    QFile file(fileName);
-    if (!file.open(QIODevice::WriteOnly)) {
+    const auto format = selectedFilter == captureFilter ? DebugExportJob::Capture : DebugExportJob::Text;
+    auto job = mConnectionPage->createExportJob(fileName, format, filtered, this);
+    job->startWithProgressDialog(this, i18n("Saving debugger messages..."));
+}
+
+void DebugWidget::loadCapture()
+{
+    const QString fileName = QFileDialog::getOpenFileName(this,
+                                                          i18n("Load Capture"),
+                                                          QString(),
+                                                          u"%1;;%2"_s.arg(i18n("Debugger Captures (*.akdebug)"), i18n("All Files (*)")));
+    if (fileName.isEmpty()) {
         return;
     }
 
-    file.write(mConnectionPage->toHtml().toUtf8());
-    file.close();
+    // Live messages would mix with the replayed ones
+    mEnableCheck->setChecked(false);
+    mConnectionPage->loadCapture(fileName);
 }
 
 #include "moc_debugwidget.cpp"
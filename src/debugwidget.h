@@ -9,10 +9,15 @@
 #pragma once
 
 #include "debuginterface.h"
+#include "tracereventmodel.h"
 
+#include <QList>
+#include <QTimer>
 #include <QWidget>
 
-class KTextEdit;
+class QCheckBox;
+class QSpinBox;
+class QTreeView;
 
 class ConnectionPage;
 
@@ -22,17 +27,27 @@ class DebugWidget : public QWidget
 
 public:
     explicit DebugWidget(QWidget *parent = nullptr);
+    ~DebugWidget() override;
 
 private:
     void signalEmitted(const QString &, const QString &);
     void warningEmitted(const QString &, const QString &);
     void errorEmitted(const QString &, const QString &);
+    void addEvent(TracerEventModel::Severity severity, const QString &component, const QString &message);
+    void flushEvents();
+    void clearEvents();
 
     void enableDebugger(bool enable);
 
-    void saveRichText();
-    void saveEverythingRichText();
-    KTextEdit *mGeneralView = nullptr;
+    void saveMessages(bool filtered);
+    void loadCapture();
+    TracerEventModel *mEventModel = nullptr;
+    QTreeView *mGeneralView = nullptr;
+    // Events are inserted in batches, a busy tracer sends many of them at once
+    QList<TracerEventModel::Event> mPendingEvents;
+    QTimer mFlushTimer;
     ConnectionPage *mConnectionPage = nullptr;
+    QSpinBox *mMaximumCountSpin = nullptr;
+    QCheckBox *mEnableCheck = nullptr;
     org::freedesktop::Akonadi::DebugInterface *mDebugInterface = nullptr;
 };
@@ -0,0 +1,125 @@
+/*
+ * SPDX-FileCopyrightText: 2026 akonadiconsole authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ */
+
+#include "exportjob.h"
+
+#include <KLocalizedString>
+
+#include <QMessageBox>
+#include <QProgressDialog>
+#include <QSaveFile>
+#include <QThread>
+
+ExportJob::ExportJob(const QString &fileName, QObject *parent)
+    : QObject(parent)
+    , mFileName(fileName)
+{
+}
+
+ExportJob::~ExportJob()
+{
+    if (mThread) {
+        cancel();
+        mThread->wait();
+        delete mThread;
+    }
+}
+
+void ExportJob::start()
+{
+    Q_ASSERT(!mThread);
+    mThread = QThread::create([this]() {
+        run();
+    });
+    connect(mThread, &QThread::finished, this, [this]() {
+        mThread->deleteLater();
+        mThread = nullptr;
+        Q_EMIT finished(mSuccess);
+    });
+    mThread->start(QThread::LowPriority);
+}
+
+void ExportJob::startWithProgressDialog(QWidget *parent, const QString &labelText)
+{
+    auto dlg = new QProgressDialog(labelText, i18n("Cancel"), 0, 100, parent);
+    dlg->setAttribute(Qt::WA_DeleteOnClose);
+    dlg->setMinimumDuration(500);
+    dlg->setAutoClose(false);
+    dlg->setAutoReset(false);
+    connect(this, &ExportJob::progress, dlg, &QProgressDialog::setValue);
+    connect(dlg, &QProgressDialog::canceled, this, &ExportJob::cancel);
+    connect(this, &ExportJob::finished, dlg, [this, dlg, parent](bool success) {
+        // Closing the dialog emits canceled(), which would hide the failure
+        const bool failed = !success && !isCanceled();
+        dlg->close();
+        if (failed) {
+            QMessageBox::warning(parent, i18n("Error"), i18n("Failed to save file: %1", errorString()));
+        }
+        deleteLater();
+    });
+    start();
+}
+
+void ExportJob::cancel()
+{
+    mCanceled = true;
+}
+
+QString ExportJob::fileName() const
+{
+    return mFileName;
+}
+
+QString ExportJob::errorString() const
+{
+    return mErrorString;
+}
+
+bool ExportJob::isCanceled() const
+{
+    return mCanceled;
+}
+
+void ExportJob::setErrorString(const QString &errorString)
+{
+    mErrorString = errorString;
+}
+
+void ExportJob::reportProgress(qint64 done, qint64 total)
+{
+    const int percent = total > 0 ? static_cast<int>(done * 100 / total) : 100;
+    if (percent != mLastProgress) {
+        mLastProgress = percent;
+        Q_EMIT progress(percent);
+    }
+}
+
+void ExportJob::run()
+{
+    QSaveFile file(mFileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        mErrorString = file.errorString();
+        return;
+    }
+
+    if (!write(&file) || isCanceled()) {
+        if (mErrorString.isEmpty() && !isCanceled()) {
+            mErrorString = file.errorString();
+        }
+        file.cancelWriting();
+        return;
+    }
+
+    if (!file.commit()) {
+        mErrorString = file.errorString();
+        return;
+    }
+    reportProgress(1, 1);
+    mSuccess = true;
+}
+
+#include "moc_exportjob.cpp"
@@ -0,0 +1,65 @@
+/*
+ * SPDX-FileCopyrightText: 2026 akonadiconsole authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ */
+
+#pragma once
+
+#include "libakonadiconsole_export.h"
+
+#include <QObject>
+#include <QString>
+
+#include <atomic>
+
+class QIODevice;
+class QThread;
+class QWidget;
+
+/**
+ * Base class for writing a snapshot of a model to a file on a worker thread.
+ *
+ * Subclasses take a snapshot of the data they export when they are created and
+ * implement write(), which runs on the worker thread and must not touch any
+ * model. The file is only replaced once the export has succeeded.
+ */
+class LIBAKONADICONSOLE_EXPORT ExportJob : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ExportJob(const QString &fileName, QObject *parent = nullptr);
+    ~ExportJob() override;
+
+    void start();
+    /** Starts the job and shows its progress in a dialog that allows to cancel it. */
+    void startWithProgressDialog(QWidget *parent, const QString &labelText);
+    void cancel();
+
+    [[nodiscard]] QString fileName() const;
+    [[nodiscard]] QString errorString() const;
+    [[nodiscard]] bool isCanceled() const;
+
+Q_SIGNALS:
+    void progress(int percent);
+    void finished(bool success);
+
+protected:
+    /** Called on the worker thread, returns false on failure or cancellation. */
+    virtual bool write(QIODevice *device) = 0;
+
+    void setErrorString(const QString &errorString);
+    /** Thread-safe, only emits progress() when the percentage changes. */
+    void reportProgress(qint64 done, qint64 total);
+
+private:
+    void run();
+
+    const QString mFileName;
+    QString mErrorString;
+    QThread *mThread = nullptr;
+    std::atomic_bool mCanceled{false};
+    bool mSuccess = false;
+    int mLastProgress = -1;
+};
@@ -0,0 +1,369 @@
+/*
+    SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "logcaptureloader.h"
+using namespace Qt::Literals::StringLiterals;
+
+#include <KLocalizedString>
+
+#include <QtEndian>
+
+#include <charconv>
+#include <cstring>
+
+namespace
+{
+// Messages parsed and added to the model at once
+constexpr int BatchSize = 16384;
+constexpr qint64 CaptureHeaderSize = 8;
+// Records without their strings, including the record type
+constexpr qint64 StringRecordSize = 1 + 1 + 4 + 4;
+constexpr qint64 MessageRecordSize = 1 + 8 + 8 + 1 + 4 * 4 + 4 + 4;
+
+bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+/**
+ * Parses one flat JSON object, as written by LogExportJob, straight from the
+ * mapped file. Keys that are not a message field are skipped.
+ */
+class JsonLineParser
+{
+public:
+    explicit JsonLineParser(QByteArrayView line)
+        : mPos(line.data())
+        , mEnd(line.data() + line.size())
+    {
+    }
+
+    bool parse(LoggingModel::Message &message)
+    {
+        if (!consume('{')) {
+            return false;
+        }
+        if (consume('}')) {
+            return atEnd();
+        }
+        do {
+            QByteArrayView key;
+            if (!readKey(key) || !consume(':')) {
+                return false;
+            }
+            skipSpaces();
+
+            bool ok = true;
+            qint64 number = 0;
+            if (key == "timestamp") {
+                ok = readNumber(message.timestamp);
+            } else if (key == "app") {
+                ok = readString(message.app);
+            } else if (key == "pid") {
+                ok = readNumber(message.pid);
+            } else if (key == "type") {
+                ok = readNumber(number) && number >= QtDebugMsg && number <= QtInfoMsg;
+                message.type = static_cast<QtMsgType>(number);
+            } else if (key == "category") {
+                ok = readString(message.category);
+            } else if (key == "file") {
+                ok = readString(message.file);
+            } else if (key == "function") {
+                ok = readString(message.function);
+            } else if (key == "line") {
+                ok = readNumber(number);
+                message.line = int(number);
+            } else if (key == "message") {
+                ok = readString(message.message);
+            } else {
+                ok = skipValue();
+            }
+            if (!ok) {
+                return false;
+            }
+        } while (consume(','));
+        return consume('}') && atEnd();
+    }
+
+private:
+    void skipSpaces()
+    {
+        while (mPos < mEnd && isSpace(*mPos)) {
+            ++mPos;
+        }
+    }
+
+    bool consume(char c)
+    {
+        skipSpaces();
+        if (mPos < mEnd && *mPos == c) {
+            ++mPos;
+            return true;
+        }
+        return false;
+    }
+
+    bool atEnd()
+    {
+        skipSpaces();
+        return mPos == mEnd;
+    }
+
+    // Keys are known to have no escapes
+    bool readKey(QByteArrayView &key)
+    {
+        if (!consume('"')) {
+            return false;
+        }
+        const char *start = mPos;
+        const auto end = static_cast<const char *>(std::memchr(mPos, '"', mEnd - mPos));
+        if (!end) {
+            return false;
+        }
+        mPos = end + 1;
+        key = QByteArrayView(start, end - start);
+        return true;
+    }
+
+    bool readNumber(qint64 &value)
+    {
+        const auto result = std::from_chars(mPos, mEnd, value);
+        if (result.ec != std::errc()) {
+            return false;
+        }
+        mPos = result.ptr;
+        return true;
+    }
+
+    bool readString(QString &str)
+    {
+        if (mPos == mEnd || *mPos != '"') {
+            return false;
+        }
+        ++mPos;
+        str.clear();
+        const char *start = mPos;
+        while (mPos < mEnd) {
+            const char c = *mPos;
+            if (c == '"') {
+                str += QString::fromUtf8(start, mPos - start);
+                ++mPos;
+                return true;
+            }
+            if (c != '\\') {
+                ++mPos;
+                continue;
+            }
+
+            // Decode the plain characters before the escape at once
+            str += QString::fromUtf8(start, mPos - start);
+            if (mEnd - mPos < 2) {
+                return false;
+            }
+            const char escaped = mPos[1];
+            mPos += 2;
+            switch (escaped) {
+            case '"':
+            case '\\':
+            case '/':
+                str += QLatin1Char(escaped);
+                break;
+            case 'b':
+                str += u'\b';
+                break;
+            case 'f':
+                str += u'\f';
+                break;
+            case 'n':
+                str += u'\n';
+                break;
+            case 'r':
+                str += u'\r';
+                break;
+            case 't':
+                str += u'\t';
+                break;
+            case 'u': {
+                // Surrogate pairs come as two escapes, each is one UTF-16 code unit
+                unsigned int unit = 0;
+                if (mEnd - mPos < 4 || std::from_chars(mPos, mPos + 4, unit, 16).ptr != mPos + 4) {
+                    return false;
+                }
+                str += QChar(char16_t(unit));
+                mPos += 4;
+                break;
+            }
+            default:
+                return false;
+            }
+            start = mPos;
+        }
+        return false;
+    }
+
+    // Only the scalar values a flat object can have
+    bool skipValue()
+    {
+        if (mPos < mEnd && *mPos == '"') {
+            QString str;
+            return readString(str);
+        }
+        const char *start = mPos;
+        while (mPos < mEnd && *mPos != ',' && *mPos != '}' && !isSpace(*mPos)) {
+            if (*mPos == '{' || *mPos == '[') {
+                return false;
+            }
+            ++mPos;
+        }
+        return mPos != start;
+    }
+
+    const char *mPos;
+    const char *const mEnd;
+};
+}
+
+LogCaptureLoader::LogCaptureLoader(LoggingModel *model, QObject *parent)
+    : CaptureLoader(parent)
+    , mModel(model)
+{
+}
+
+LogCaptureLoader::~LogCaptureLoader() = default;
+
+bool LogCaptureLoader::readHeader()
+{
+    if (mSize == 0) {
+        return true;
+    }
+
+    if (mSize >= CaptureHeaderSize && qFromLittleEndian<quint32>(mData) == LogExportJob::CaptureMagic) {
+        const auto version = qFromLittleEndian<quint32>(mData + 4);
+        if (version != LogExportJob::CaptureVersion) {
+            setErrorString(i18n("Unsupported capture version %1.", version));
+            return false;
+        }
+        mCapture = true;
+        mPosition = CaptureHeaderSize;
+        return true;
+    }
+
+    if (mSize >= 2 && quint8(mData[0]) == 0x1f && quint8(mData[1]) == 0x8b) {
+        setErrorString(i18n("Compressed captures have to be decompressed before loading them."));
+        return false;
+    }
+    const char *first = mData;
+    while (first < mData + mSize && isSpace(*first)) {
+        ++first;
+    }
+    if (first < mData + mSize && *first != '{') {
+        setErrorString(i18n("The file is not a log capture."));
+        return false;
+    }
+    return true;
+}
+
+void LogCaptureLoader::clearModel()
+{
+    mModel->clear();
+}
+
+bool LogCaptureLoader::readBatch()
+{
+    QList<LoggingModel::Message> messages;
+    messages.reserve(BatchSize);
+    bool ok = true;
+    while (ok && messages.count() < BatchSize && mPosition < mSize) {
+        ok = mCapture ? readCaptureRecord(messages) : readJsonLine(messages);
+    }
+    mModel->addMessages(messages);
+    return ok;
+}
+
+QString LogCaptureLoader::failureMessage() const
+{
+    return i18n("Failed to load log capture: %1", errorString());
+}
+
+bool LogCaptureLoader::readCaptureRecord(QList<LoggingModel::Message> &messages)
+{
+    const char *data = mData + mPosition;
+    const qint64 available = mSize - mPosition;
+    switch (quint8(data[0])) {
+    case LogExportJob::StringRecord: {
+        if (available < StringRecordSize) {
+            return damaged();
+        }
+        const auto table = quint8(data[1]);
+        const auto id = qFromLittleEndian<quint32>(data + 2);
+        const auto size = qFromLittleEndian<quint32>(data + 6);
+        // Every string takes a record, there cannot be more ids than bytes
+        if (table >= LogExportJob::_CaptureTableCount || id >= mSize || available - StringRecordSize < size) {
+            return damaged();
+        }
+        auto &strings = mStrings[table];
+        if (id >= quint32(strings.count())) {
+            strings.resize(id + 1);
+        }
+        strings[id] = QString::fromUtf8(data + StringRecordSize, size);
+        mPosition += StringRecordSize + size;
+        return true;
+    }
+    case LogExportJob::MessageRecord: {
+        if (available < MessageRecordSize) {
+            return damaged();
+        }
+        const auto type = quint8(data[17]);
+        quint32 ids[LogExportJob::_CaptureTableCount];
+        for (int table = 0; table < LogExportJob::_CaptureTableCount; ++table) {
+            ids[table] = qFromLittleEndian<quint32>(data + 18 + table * 4);
+            if (ids[table] >= quint32(mStrings[table].count())) {
+                return damaged();
+            }
+        }
+        const auto size = qFromLittleEndian<quint32>(data + 38);
+        if (type > QtInfoMsg || available - MessageRecordSize < size) {
+            return damaged();
+        }
+
+        messages.push_back({qFromLittleEndian<qint64>(data + 1),
+                            mStrings[LogExportJob::AppTable].at(ids[LogExportJob::AppTable]),
+                            qFromLittleEndian<qint64>(data + 9),
+                            mStrings[LogExportJob::CategoryTable].at(ids[LogExportJob::CategoryTable]),
+                            mStrings[LogExportJob::FileTable].at(ids[LogExportJob::FileTable]),
+                            mStrings[LogExportJob::FunctionTable].at(ids[LogExportJob::FunctionTable]),
+                            QString::fromUtf8(data + MessageRecordSize, size),
+                            static_cast<QtMsgType>(type),
+                            qFromLittleEndian<qint32>(data + 34)});
+        mPosition += MessageRecordSize + size;
+        return true;
+    }
+    }
+    return damaged();
+}
+
+bool LogCaptureLoader::readJsonLine(QList<LoggingModel::Message> &messages)
+{
+    const char *start = mData + mPosition;
+    const auto newline = static_cast<const char *>(std::memchr(start, '\n', mSize - mPosition));
+    const char *end = newline ? newline : mData + mSize;
+    mPosition = end - mData + (newline ? 1 : 0);
+    ++mLineNumber;
+
+    const QByteArrayView line(start, end - start);
+    if (line.trimmed().isEmpty()) {
+        return true;
+    }
+    LoggingModel::Message message{0, QString(), 0, QString(), QString(), QString(), QString(), QtDebugMsg, 0};
+    if (!JsonLineParser(line).parse(message)) {
+        setErrorString(i18n("Line %1: invalid log message", mLineNumber));
+        return false;
+    }
+    messages.push_back(message);
+    return true;
+}
+
+#include "moc_logcaptureloader.cpp"
@@ -0,0 +1,42 @@
+/*
+    SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "captureloader.h"
+#include "logexportjob.h"
+#include "loggingmodel.h"
+
+#include <array>
+
+/**
+ * Loads a log capture saved by LogExportJob back into a LoggingModel.
+ *
+ * Both the Capture and the JsonLines format can be loaded.
+ */
+class LIBAKONADICONSOLE_EXPORT LogCaptureLoader : public CaptureLoader
+{
+    Q_OBJECT
+public:
+    explicit LogCaptureLoader(LoggingModel *model, QObject *parent = nullptr);
+    ~LogCaptureLoader() override;
+
+protected:
+    bool readHeader() override;
+    void clearModel() override;
+    bool readBatch() override;
+    QString failureMessage() const override;
+
+private:
+    [[nodiscard]] bool readCaptureRecord(QList<LoggingModel::Message> &messages);
+    [[nodiscard]] bool readJsonLine(QList<LoggingModel::Message> &messages);
+
+    LoggingModel *const mModel;
+    bool mCapture = false;
+    int mLineNumber = 0;
+    // Strings defined so far by the capture, by table and id
+    std::array<QList<QString>, LogExportJob::_CaptureTableCount> mStrings;
+};
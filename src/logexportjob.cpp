@@ -0,0 +1,303 @@
+/*
+    SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "logexportjob.h"
+using namespace Qt::Literals::StringLiterals;
+
+#include "loggingfiltermodel.h"
+#include "loggingmodel.h"
+
+#include <KCompressionDevice>
+
+#include <QDate>
+#include <QIODevice>
+#include <QtEndian>
+
+#include <charconv>
+
+namespace
+{
+// Progress is reported every this many rows
+constexpr int ProgressInterval = 1024;
+// The buffer is written out once it grows past this
+constexpr qsizetype FlushSize = 64 * 1024;
+constexpr qint64 MSecsPerDay = 24 * 3600 * 1000;
+
+void appendNumber(QByteArray &out, qint64 value)
+{
+    char digits[24];
+    const auto result = std::to_chars(std::begin(digits), std::end(digits), value);
+    out.append(digits, result.ptr - digits);
+}
+
+void appendDigits(QByteArray &out, int value, int width)
+{
+    char digits[4];
+    for (int i = width - 1; i >= 0; --i) {
+        digits[i] = char('0' + value % 10);
+        value /= 10;
+    }
+    out.append(digits, width);
+}
+
+template<typename T>
+void appendLittleEndian(QByteArray &out, T value)
+{
+    const T encoded = qToLittleEndian(value);
+    out.append(reinterpret_cast<const char *>(&encoded), sizeof(T));
+}
+
+void appendJsonString(QByteArray &out, QByteArrayView utf8)
+{
+    static constexpr char hex[] = "0123456789abcdef";
+    out += '"';
+    qsizetype start = 0;
+    for (qsizetype i = 0; i < utf8.size(); ++i) {
+        const auto c = uchar(utf8[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+        // Copy the plain characters before this one at once
+        out.append(utf8.data() + start, i - start);
+        start = i + 1;
+        switch (c) {
+        case '"':
+            out += "\\\"";
+            break;
+        case '\\':
+            out += "\\\\";
+            break;
+        case '\n':
+            out += "\\n";
+            break;
+        case '\r':
+            out += "\\r";
+            break;
+        case '\t':
+            out += "\\t";
+            break;
+        default:
+            out += "\\u00";
+            out += hex[c >> 4];
+            out += hex[c & 0xf];
+            break;
+        }
+    }
+    out.append(utf8.data() + start, utf8.size() - start);
+    out += '"';
+}
+
+std::vector<QByteArray> encodeStrings(const LogMessageStore::StringTable &table, bool json)
+{
+    std::vector<QByteArray> encoded;
+    encoded.reserve(table.count());
+    for (int id = 0; id < table.count(); ++id) {
+        const QByteArray utf8 = table.at(id).toUtf8();
+        if (json) {
+            QByteArray str;
+            appendJsonString(str, utf8);
+            encoded.push_back(str);
+        } else {
+            encoded.push_back(utf8);
+        }
+    }
+    return encoded;
+}
+}
+
+LogExportJob::LogExportJob(const LoggingFilterModel *filter, const QString &fileName, Format format, QObject *parent)
+    : ExportJob(fileName, parent)
+    , mStore(static_cast<const LoggingModel *>(filter->sourceModel())->store().snapshot())
+    , mFormat(format)
+{
+    const int count = filter->rowCount();
+    mRows.reserve(count);
+    for (int row = 0; row < count; ++row) {
+        mRows.push_back(filter->mapToSource(filter->index(row, 0)).row());
+    }
+}
+
+LogExportJob::~LogExportJob() = default;
+
+bool LogExportJob::write(QIODevice *device)
+{
+    if (mFormat != CompressedJsonLines) {
+        return writeMessages(device);
+    }
+
+    KCompressionDevice compressed(device, false, KCompressionDevice::GZip);
+    if (!compressed.open(QIODevice::WriteOnly)) {
+        setErrorString(compressed.errorString());
+        return false;
+    }
+    const bool written = writeMessages(&compressed);
+    compressed.close();
+    return written;
+}
+
+bool LogExportJob::writeMessages(QIODevice *device)
+{
+    const bool json = mFormat == JsonLines || mFormat == CompressedJsonLines;
+    mApps = encodeStrings(mStore.apps(), json);
+    mCategories = encodeStrings(mStore.categories(), json);
+    mFiles = encodeStrings(mStore.files(), json);
+    mFunctions = encodeStrings(mStore.functions(), json);
+
+    mBuffer.reserve(FlushSize + 4096);
+    if (mFormat == Capture) {
+        appendLittleEndian(mBuffer, CaptureMagic);
+        appendLittleEndian(mBuffer, CaptureVersion);
+        mWrittenStrings[AppTable].assign(mApps.size(), false);
+        mWrittenStrings[CategoryTable].assign(mCategories.size(), false);
+        mWrittenStrings[FileTable].assign(mFiles.size(), false);
+        mWrittenStrings[FunctionTable].assign(mFunctions.size(), false);
+    }
+    const auto flush = [this, device]() {
+        const bool written = device->write(mBuffer) == mBuffer.size();
+        mBuffer.clear();
+        return written;
+    };
+
+    const auto count = qint64(mRows.size());
+    for (qint64 i = 0; i < count; ++i) {
+        if (i % ProgressInterval == 0) {
+            if (isCanceled()) {
+                return false;
+            }
+            reportProgress(i, count);
+        }
+
+        switch (mFormat) {
+        case Text:
+            appendText(mRows[i]);
+            break;
+        case JsonLines:
+        case CompressedJsonLines:
+            appendJson(mRows[i]);
+            break;
+        case Capture:
+            appendCapture(mRows[i]);
+            break;
+        }
+        if (mBuffer.size() >= FlushSize && !flush()) {
+            return false;
+        }
+    }
+
+    return flush();
+}
+
+void LogExportJob::appendText(int row)
+{
+    // Same as the format the Logging tab always saved
+    mBuffer += '[';
+    appendTimestamp(mStore.timestamp(row));
+    mBuffer += "] ";
+    mBuffer += mApps[mStore.appId(row)];
+    mBuffer += ' ';
+    if (const auto &category = mCategories[mStore.categoryId(row)]; !category.isEmpty()) {
+        mBuffer += category;
+        mBuffer += ' ';
+    }
+    if (const auto &function = mFunctions[mStore.functionId(row)]; !function.isEmpty()) {
+        mBuffer += function;
+        mBuffer += ": ";
+    }
+    mBuffer.append(mStore.textUtf8(row));
+    mBuffer += '\n';
+}
+
+void LogExportJob::appendJson(int row)
+{
+    // Same fields as the messages received over D-Bus
+    mBuffer += "{\"timestamp\":";
+    appendNumber(mBuffer, mStore.timestamp(row));
+    mBuffer += ",\"app\":";
+    mBuffer += mApps[mStore.appId(row)];
+    mBuffer += ",\"pid\":";
+    appendNumber(mBuffer, mStore.pid(row));
+    mBuffer += ",\"type\":";
+    appendNumber(mBuffer, mStore.type(row));
+    mBuffer += ",\"category\":";
+    mBuffer += mCategories[mStore.categoryId(row)];
+    mBuffer += ",\"file\":";
+    mBuffer += mFiles[mStore.fileId(row)];
+    mBuffer += ",\"function\":";
+    mBuffer += mFunctions[mStore.functionId(row)];
+    mBuffer += ",\"line\":";
+    appendNumber(mBuffer, mStore.line(row));
+    mBuffer += ",\"message\":";
+    appendJsonString(mBuffer, mStore.textUtf8(row));
+    mBuffer += "}\n";
+}
+
+void LogExportJob::appendCapture(int row)
+{
+    const int appId = mStore.appId(row);
+    const int categoryId = mStore.categoryId(row);
+    const int fileId = mStore.fileId(row);
+    const int functionId = mStore.functionId(row);
+    appendCaptureString(AppTable, appId);
+    appendCaptureString(CategoryTable, categoryId);
+    appendCaptureString(FileTable, fileId);
+    appendCaptureString(FunctionTable, functionId);
+
+    const QByteArrayView text = mStore.textUtf8(row);
+    mBuffer += char(MessageRecord);
+    appendLittleEndian(mBuffer, mStore.timestamp(row));
+    appendLittleEndian(mBuffer, mStore.pid(row));
+    appendLittleEndian(mBuffer, quint8(mStore.type(row)));
+    appendLittleEndian(mBuffer, quint32(appId));
+    appendLittleEndian(mBuffer, quint32(categoryId));
+    appendLittleEndian(mBuffer, quint32(fileId));
+    appendLittleEndian(mBuffer, quint32(functionId));
+    appendLittleEndian(mBuffer, qint32(mStore.line(row)));
+    appendLittleEndian(mBuffer, quint32(text.size()));
+    mBuffer.append(text);
+}
+
+void LogExportJob::appendCaptureString(CaptureTable table, int id)
+{
+    auto &written = mWrittenStrings[table];
+    if (written[id]) {
+        return;
+    }
+    written[id] = true;
+
+    const std::vector<QByteArray> *strings[] = {&mApps, &mCategories, &mFiles, &mFunctions};
+    const QByteArray &str = (*strings[table])[id];
+    mBuffer += char(StringRecord);
+    appendLittleEndian(mBuffer, quint8(table));
+    appendLittleEndian(mBuffer, quint32(id));
+    appendLittleEndian(mBuffer, quint32(str.size()));
+    mBuffer += str;
+}
+
+void LogExportJob::appendTimestamp(qint64 msecs)
+{
+    // ISO 8601 in UTC with milliseconds, the date only changes once a day
+    qint64 day = msecs / MSecsPerDay;
+    if (msecs % MSecsPerDay < 0) {
+        --day;
+    }
+    if (day != mDay || mDayText.isEmpty()) {
+        mDay = day;
+        mDayText = QDate(1970, 1, 1).addDays(day).toString(Qt::ISODate).toLatin1() + 'T';
+    }
+
+    const int time = int(msecs - day * MSecsPerDay);
+    mBuffer += mDayText;
+    appendDigits(mBuffer, time / 3'600'000, 2);
+    mBuffer += ':';
+    appendDigits(mBuffer, time / 60'000 % 60, 2);
+    mBuffer += ':';
+    appendDigits(mBuffer, time / 1000 % 60, 2);
+    mBuffer += '.';
+    appendDigits(mBuffer, time % 1000, 3);
+    mBuffer += 'Z';
+}
+
+#include "moc_logexportjob.cpp"
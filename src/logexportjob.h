@@ -0,0 +1,92 @@
+/*
+    SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "exportjob.h"
+#include "logmessagestore.h"
+
+#include <QByteArray>
+
+#include <array>
+#include <vector>
+
+class LoggingFilterModel;
+
+/**
+ * Writes the log messages shown by a LoggingFilterModel to a file.
+ *
+ * The messages are read straight from a snapshot of the LogMessageStore, so
+ * the Logging tab keeps receiving messages while the file is written. The
+ * JsonLines format keeps every field of a message, CompressedJsonLines is the
+ * same compressed with gzip.
+ *
+ * The Capture format is a compact binary form for loading the messages back
+ * with LogCaptureLoader. After the magic and version, the file is a sequence
+ * of records, each starting with its CaptureRecord type:
+ * - StringRecord: CaptureTable table, quint32 id, quint32 size, UTF-8 string
+ * - MessageRecord: qint64 timestamp, qint64 pid, quint8 type, quint32 app,
+ *   category, file and function ids, qint32 line, quint32 size, UTF-8 text
+ * Every string is defined before the first message using it, and all
+ * numbers are little endian.
+ */
+class LIBAKONADICONSOLE_EXPORT LogExportJob : public ExportJob
+{
+    Q_OBJECT
+public:
+    enum Format {
+        Text,
+        JsonLines,
+        CompressedJsonLines,
+        Capture
+    };
+    Q_ENUM(Format)
+
+    static constexpr quint32 CaptureMagic = 0x434c4b41; // "AKLC"
+    static constexpr quint32 CaptureVersion = 1;
+    enum CaptureRecord : quint8 {
+        StringRecord,
+        MessageRecord
+    };
+    enum CaptureTable : quint8 {
+        AppTable,
+        CategoryTable,
+        FileTable,
+        FunctionTable,
+
+        _CaptureTableCount
+    };
+
+    LogExportJob(const LoggingFilterModel *filter, const QString &fileName, Format format, QObject *parent = nullptr);
+    ~LogExportJob() override;
+
+protected:
+    bool write(QIODevice *device) override;
+
+private:
+    bool writeMessages(QIODevice *device);
+    void appendText(int row);
+    void appendJson(int row);
+    void appendCapture(int row);
+    void appendCaptureString(CaptureTable table, int id);
+    void appendTimestamp(qint64 msecs);
+
+    const LogMessageStore mStore;
+    // Rows of the store accepted by the filter, in the order shown
+    std::vector<int> mRows;
+    const Format mFormat;
+    // Encoded strings of the interned ids, JSON strings include the quotes
+    std::vector<QByteArray> mApps;
+    std::vector<QByteArray> mCategories;
+    std::vector<QByteArray> mFiles;
+    std::vector<QByteArray> mFunctions;
+    // Strings already defined in the Capture format
+    std::array<std::vector<bool>, _CaptureTableCount> mWrittenStrings;
+    QByteArray mBuffer;
+    // Date part of the last written timestamp
+    qint64 mDay = -1;
+    QByteArray mDayText;
+};
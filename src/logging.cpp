@@ -7,21 +7,32 @@
 #include "logging.h"
 using namespace Qt::Literals::StringLiterals;
 
+#include "logcaptureloader.h"
+#include "logexportjob.h"
 #include "loggeradaptor.h"
 #include "loggingfiltermodel.h"
+#include "logginghighlightdelegate.h"
 #include "loggingmodel.h"
+#include "logratemodel.h"
 
 #include <KLocalizedString>
 
 #include <QCheckBox>
+#include <QDBusArgument>
 #include <QDBusConnection>
+#include <QDBusMetaType>
 #include <QFileDialog>
 #include <QHBoxLayout>
 #include <QHeaderView>
 #include <QLabel>
+#include <QLineEdit>
 #include <QMessageBox>
 #include <QPushButton>
+#include <QScrollBar>
+#include <QSpinBox>
+#include <QSplitter>
 #include <QStandardItemModel>
+#include <QTableView>
 #include <QTreeView>
 
 #include <Libkdepim/KCheckComboBox>
@@ -29,6 +40,8 @@ using namespace Qt::Literals::StringLiterals;
 #include <KConfigGroup>
 #include <KSharedConfig>
 
+#include <chrono>
+
 #ifndef COMPILE_WITH_UNITY_CMAKE_SUPPORT
 Q_DECLARE_METATYPE(LoggingModel::Message)
 #endif
@@ -36,6 +49,25 @@ Q_DECLARE_METATYPE(LoggingModel::Message)
 #define DBUS_INTERFACE u"org.kde.akonadiconsole.logger"_s
 
 using namespace KPIM;
+using namespace std::chrono_literals;
+
+QDBusArgument &operator<<(QDBusArgument &arg, const LoggerMessage &message)
+{
+    arg.beginStructure();
+    arg << message.timestamp << message.app << message.pid << message.type << message.category << message.file << message.function << message.line
+        << message.version << message.message;
+    arg.endStructure();
+    return arg;
+}
+
+const QDBusArgument &operator>>(const QDBusArgument &arg, LoggerMessage &message)
+{
+    arg.beginStructure();
+    arg >> message.timestamp >> message.app >> message.pid >> message.type >> message.category >> message.file >> message.function >> message.line
+        >> message.version >> message.message;
+    arg.endStructure();
+    return arg;
+}
 
 Logging::Logging(QWidget *parent)
     : QWidget(parent)
@@ -66,23 +98,47 @@ Logging::Logging(QWidget *parent)
     h->addWidget(new QLabel(i18nc("@label:textbox", "Categories:")));
     h->addWidget(mCategoryFilter = new KCheckComboBox());
     h->setStretchFactor(mCategoryFilter, 2);
+    mSearchEdit = new QLineEdit(this);
+    mSearchEdit->setPlaceholderText(i18nc("@info:placeholder", "Search messages..."));
+    mSearchEdit->setClearButtonEnabled(true);
+    h->addWidget(mSearchEdit);
+    h->setStretchFactor(mSearchEdit, 3);
 
     mModel = new LoggingModel(this);
 
-    auto filterModel = new LoggingFilterModel(this);
-    filterModel->setAppFilter(mAppFilter);
-    filterModel->setCategoryFilter(mCategoryFilter);
-    filterModel->setTypeFilter(mTypeFilter);
-    filterModel->setSourceModel(mModel);
+    mFilterModel = new LoggingFilterModel(this);
+    mFilterModel->setAppFilter(mAppFilter);
+    mFilterModel->setCategoryFilter(mCategoryFilter);
+    mFilterModel->setTypeFilter(mTypeFilter);
+    mFilterModel->setSourceModel(mModel);
+    connect(mSearchEdit, &QLineEdit::textChanged, mFilterModel, &LoggingFilterModel::setSearchText);
 
     for (int i = 0; i < mTypeFilter->count(); ++i) {
         mTypeFilter->setItemCheckState(i, Qt::Checked);
     }
 
+    auto splitter = new QSplitter(Qt::Vertical, this);
+    l->addWidget(splitter);
     mView = new QTreeView;
     mView->setRootIsDecorated(false);
-    l->addWidget(mView);
-    mView->setModel(filterModel);
+    splitter->addWidget(mView);
+
+    auto rateModel = new LogRateModel(mModel, this);
+    auto rateView = new QTableView(splitter);
+    rateView->setModel(rateModel);
+    rateView->verticalHeader()->hide();
+    rateView->setShowGrid(false);
+    rateView->setSelectionMode(QAbstractItemView::NoSelection);
+    // Narrow cells for the seconds, a minute of them fits next to the names
+    rateView->horizontalHeader()->setMinimumSectionSize(4);
+    rateView->horizontalHeader()->setDefaultSectionSize(8);
+    for (int column = 0; column < LogRateModel::FirstSecondColumn; ++column) {
+        rateView->horizontalHeader()->setSectionResizeMode(column, QHeaderView::ResizeToContents);
+    }
+    rateView->hide();
+    splitter->addWidget(rateView);
+    mView->setModel(mFilterModel);
+    mView->setItemDelegate(new LoggingHighlightDelegate(mFilterModel, mView));
     mModel->setAppFilterModel(qobject_cast<QStandardItemModel *>(mAppFilter->model()));
     mModel->setCategoryFilterModel(qobject_cast<QStandardItemModel *>(mCategoryFilter->model()));
 
@@ -92,19 +148,75 @@ Logging::Logging(QWidget *parent)
     auto btn = new QPushButton(i18nc("@action:button", "Save to File..."), this);
     connect(btn, &QPushButton::clicked, this, &Logging::saveToFile);
     h->addWidget(btn);
+    btn = new QPushButton(i18nc("@action:button", "Load Capture..."), this);
+    connect(btn, &QPushButton::clicked, this, &Logging::loadCapture);
+    h->addWidget(btn);
+    btn = new QPushButton(i18nc("@action:button", "Clear"), this);
+    connect(btn, &QPushButton::clicked, mModel, &LoggingModel::clear);
+    h->addWidget(btn);
+    btn = new QPushButton(i18nc("@action:button", "Message Rates"), this);
+    btn->setCheckable(true);
+    connect(btn, &QPushButton::toggled, this, [rateView, rateModel](bool show) {
+        rateView->setVisible(show);
+        rateModel->setActive(show);
+    });
+    h->addWidget(btn);
     h->addStretch(1);
 
+    h->addWidget(new QLabel(i18nc("@label:spinbox", "Keep at most:"), this));
+    mMaximumCountSpin = new QSpinBox(this);
+    mMaximumCountSpin->setRange(0, 100'000'000);
+    mMaximumCountSpin->setSingleStep(100'000);
+    mMaximumCountSpin->setSuffix(i18nc("@label:spinbox suffix", " messages"));
+    mMaximumCountSpin->setSpecialValueText(i18nc("@label:spinbox no limit of messages", "Unlimited"));
+    h->addWidget(mMaximumCountSpin);
+    mSpillCheckbox = new QCheckBox(i18nc("@option:check", "Move older messages to disk"), this);
+    h->addWidget(mSpillCheckbox);
+    mSpilledLabel = new QLabel(this);
+    h->addWidget(mSpilledLabel);
+    mLoadSpilledButton = new QPushButton(i18nc("@action:button", "Load Older"), this);
+    connect(mLoadSpilledButton, &QPushButton::clicked, this, &Logging::loadSpilled);
+    h->addWidget(mLoadSpilledButton);
+    spilledCountChanged(0);
+
+    connect(mModel, &LoggingModel::spilledCountChanged, this, &Logging::spilledCountChanged);
+    connect(mMaximumCountSpin, &QSpinBox::valueChanged, mModel, &LoggingModel::setMaximumCount);
+    connect(mSpillCheckbox, &QCheckBox::toggled, mModel, &LoggingModel::setSpillToDisk);
+    // Page spilled messages in when scrolling past the oldest one in memory, and let them
+    // go again once back at the newest messages
+    connect(mView->verticalScrollBar(), &QScrollBar::valueChanged, this, [this](int value) {
+        const auto scrollBar = mView->verticalScrollBar();
+        if (scrollBar->minimum() == scrollBar->maximum()) {
+            return;
+        }
+        if (value == scrollBar->minimum() && mModel->spilledCount() > 0) {
+            loadSpilled();
+        } else if (value == scrollBar->maximum()) {
+            mModel->unloadSpilled();
+        }
+    });
+
+    mFlushTimer.setInterval(16ms);
+    mFlushTimer.setSingleShot(true);
+    connect(&mFlushTimer, &QTimer::timeout, this, &Logging::flushMessages);
+
+    qDBusRegisterMetaType<LoggerMessage>();
+    qDBusRegisterMetaType<QList<LoggerMessage>>();
     new LoggerAdaptor(this);
     QDBusConnection::sessionBus().registerObject(DBUS_PATH, this, QDBusConnection::ExportAdaptors);
 
     KConfigGroup config(KSharedConfig::openConfig(), u"Logging"_s);
     mView->header()->restoreState(config.readEntry<QByteArray>("view", QByteArray()));
+    mMaximumCountSpin->setValue(config.readEntry("maximumCount", 0));
+    mSpillCheckbox->setChecked(config.readEntry("spillToDisk", false));
 }
 
 Logging::~Logging()
 {
     KConfigGroup config(KSharedConfig::openConfig(), u"Logging"_s);
     config.writeEntry("view", mView->header()->saveState());
+    config.writeEntry("maximumCount", mMaximumCountSpin->value());
+    config.writeEntry("spillToDisk", mSpillCheckbox->isChecked());
 }
 
 bool Logging::enabled() const
@@ -123,34 +235,104 @@ void Logging::message(qint64 timestamp,
                       int /*version*/,
                       const QString &msg)
 {
-    mModel->addMessage(timestamp, app, pid, static_cast<QtMsgType>(type), category, file, function, line, msg);
+    mPendingMessages.push_back({timestamp, app, pid, category, file, function, msg, static_cast<QtMsgType>(type), line});
+    if (!mFlushTimer.isActive()) {
+        mFlushTimer.start();
+    }
+}
+
+void Logging::messages(const QList<LoggerMessage> &messages)
+{
+    mPendingMessages.reserve(mPendingMessages.size() + messages.size());
+    for (const auto &msg : messages) {
+        mPendingMessages.push_back(
+            {msg.timestamp, msg.app, msg.pid, msg.category, msg.file, msg.function, msg.message, static_cast<QtMsgType>(msg.type), msg.line});
+    }
+    if (!mFlushTimer.isActive()) {
+        mFlushTimer.start();
+    }
+}
+
+void Logging::flushMessages()
+{
+    mModel->addMessages(mPendingMessages);
+    mPendingMessages.clear();
+}
+
+void Logging::spilledCountChanged(qint64 count)
+{
+    mSpilledLabel->setText(i18np("1 older message on disk", "%1 older messages on disk", count));
+    mSpilledLabel->setVisible(count > 0);
+    mLoadSpilledButton->setVisible(count > 0);
+}
+
+void Logging::loadSpilled()
+{
+    if (mLoadingSpilled) {
+        return;
+    }
+    mLoadingSpilled = true;
+    // Keep the row at the top of the view where it is
+    const QPersistentModelIndex topIndex = mView->indexAt(QPoint(0, 0));
+    mModel->loadSpilled();
+    if (topIndex.isValid()) {
+        mView->scrollTo(topIndex, QAbstractItemView::PositionAtTop);
+    }
+    mLoadingSpilled = false;
 }
 
 void Logging::saveToFile()
 {
-    const auto filename = QFileDialog::getSaveFileName(this, i18n("Save to File..."));
-    if (filename.isEmpty()) {
+    const QString textFilter = i18n("Text Files (*.txt)");
+    const QString jsonFilter = i18n("JSON Lines Files (*.jsonl)");
+    const QString compressedFilter = i18n("Compressed JSON Lines Files (*.jsonl.gz)");
+    const QString captureFilter = i18n("Log Captures (*.aklog)");
+    QString selectedFilter = textFilter;
+    const QString fileName = QFileDialog::getSaveFileName(this,
+                                                          i18n("Save to File..."),
+                                                          QString(),
+                                                          u"%1;;%2;;%3;;%4"_s.arg(textFilter, jsonFilter, compressedFilter, captureFilter),
+                                                          &selectedFilter);
+    if (fileName.isEmpty()) {
         return;
     }
 
-    QFile file(filename);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
-        QMessageBox::warning(this, i18n("Error"), i18n("Failed to open file: %1", file.errorString()));
+    LogExportJob::Format format = LogExportJob::Text;
+    if (selectedFilter == jsonFilter) {
+        format = LogExportJob::JsonLines;
+    } else if (selectedFilter == compressedFilter) {
+        format = LogExportJob::CompressedJsonLines;
+    } else if (selectedFilter == captureFilter) {
+        format = LogExportJob::Capture;
+    }
+
+    // Saves what the view shows, with the current filter applied
+    auto job = new LogExportJob(mFilterModel, fileName, format, this);
+    job->startWithProgressDialog(this, i18n("Saving log messages..."));
+}
+
+void Logging::loadCapture()
+{
+    const QString fileName = QFileDialog::getOpenFileName(this,
+                                                          i18n("Load Capture"),
+                                                          QString(),
+                                                          u"%1;;%2"_s.arg(i18n("Log Captures (*.aklog *.jsonl)"), i18n("All Files (*)")));
+    if (fileName.isEmpty()) {
         return;
     }
 
-    QTextStream stream(&file);
-    for (int row = 0, cnt = mModel->rowCount(); row < cnt; ++row) {
-        const auto msg = mModel->data(mModel->index(row, 0), LoggingModel::MessageRole).value<LoggingModel::Message>();
-        stream << "[" << QDateTime::fromMSecsSinceEpoch(msg.timestamp, QTimeZone::UTC).toString(Qt::ISODateWithMs) << "] " << msg.app << " ";
-        if (!msg.category.isEmpty()) {
-            stream << msg.category << " ";
-        }
-        if (!msg.function.isEmpty()) {
-            stream << msg.function << ": ";
-        }
-        stream << msg.message << "\n";
+    auto loader = new LogCaptureLoader(mModel, this);
+    if (!loader->open(fileName)) {
+        QMessageBox::warning(this, i18n("Error"), i18n("Failed to load log capture: %1", loader->errorString()));
+        delete loader;
+        return;
     }
+
+    // Keep live messages out of the loaded ones
+    mEnabledCheckbox->setChecked(false);
+    mFlushTimer.stop();
+    mPendingMessages.clear();
+    loader->startWithProgressDialog(this, i18n("Loading log capture..."));
 }
 
 #include "moc_logging.cpp"
@@ -6,16 +6,44 @@
 
 #pragma once
 
+#include "loggingmodel.h"
+
+#include <QTimer>
 #include <QWidget>
 
 class QCheckBox;
+class QDBusArgument;
+class QLabel;
+class QLineEdit;
+class QPushButton;
+class QSpinBox;
 class QTreeView;
-class LoggingModel;
+class LoggingFilterModel;
 namespace KPIM
 {
 class KCheckComboBox;
 }
 
+/** A message as passed to the batched messages() D-Bus method. */
+struct LoggerMessage {
+    qint64 timestamp;
+    QString app;
+    qint64 pid;
+    int type;
+    QString category;
+    QString file;
+    QString function;
+    int line;
+    int version;
+    QString message;
+};
+
+Q_DECLARE_METATYPE(LoggerMessage)
+Q_DECLARE_METATYPE(QList<LoggerMessage>)
+
+QDBusArgument &operator<<(QDBusArgument &arg, const LoggerMessage &message);
+const QDBusArgument &operator>>(const QDBusArgument &arg, LoggerMessage &message);
+
 class Logging : public QWidget
 {
     Q_OBJECT
@@ -38,16 +66,33 @@ public:
                              int line,
                              int version,
                              const QString &msg);
+    /** Same as message(), for many messages in a single D-Bus call. */
+    Q_INVOKABLE void messages(const QList<LoggerMessage> &messages);
 
 Q_SIGNALS:
     void enabledChanged(bool enabled);
 
 private:
     void saveToFile();
+    void loadCapture();
+    void spilledCountChanged(qint64 count);
+    void loadSpilled();
+    void flushMessages();
+
     QCheckBox *mEnabledCheckbox = nullptr;
     KPIM::KCheckComboBox *mAppFilter = nullptr;
     KPIM::KCheckComboBox *mTypeFilter = nullptr;
     KPIM::KCheckComboBox *mCategoryFilter = nullptr;
     QTreeView *mView = nullptr;
+    QLineEdit *mSearchEdit = nullptr;
     LoggingModel *mModel = nullptr;
+    LoggingFilterModel *mFilterModel = nullptr;
+    QSpinBox *mMaximumCountSpin = nullptr;
+    QCheckBox *mSpillCheckbox = nullptr;
+    QLabel *mSpilledLabel = nullptr;
+    QPushButton *mLoadSpilledButton = nullptr;
+    bool mLoadingSpilled = false;
+    // Received messages are added to the model once per frame
+    QList<LoggingModel::Message> mPendingMessages;
+    QTimer mFlushTimer;
 };
@@ -7,42 +7,83 @@
 #include "loggingfiltermodel.h"
 #include "akonadiconsole_debug.h"
 #include "loggingmodel.h"
+#include "logsearchindex.h"
 
 #include <Libkdepim/KCheckComboBox>
-#ifndef COMPILE_WITH_UNITY_CMAKE_SUPPORT
-Q_DECLARE_METATYPE(LoggingModel::Message)
-#endif
+
+#include <algorithm>
 #include <chrono>
 
 using namespace std::chrono_literals;
 using namespace KPIM;
 
+namespace
+{
+bool isChecked(QBitArray &checked, int id, const QStringList &names, const LogMessageStore::StringTable &table)
+{
+    if (id >= checked.size()) {
+        const int oldSize = checked.size();
+        checked.resize(table.count());
+        for (int i = oldSize; i < table.count(); ++i) {
+            checked.setBit(i, names.contains(table.at(i)));
+        }
+    }
+    return checked.testBit(id);
+}
+
+QBitArray checkedIds(const QStringList &names, const LogMessageStore::StringTable &table)
+{
+    QBitArray checked(table.count());
+    for (const auto &name : names) {
+        const int id = table.indexOf(name);
+        if (id >= 0) {
+            checked.setBit(id);
+        }
+    }
+    return checked;
+}
+}
+
 LoggingFilterModel::LoggingFilterModel(QObject *parent)
     : QSortFilterProxyModel(parent)
 {
     mInvalidateTimer.setInterval(50ms);
     mInvalidateTimer.setSingleShot(true);
-    connect(&mInvalidateTimer, &QTimer::timeout, this, &LoggingFilterModel::invalidate);
+    // Only the rows are filtered, there is no need to sort the model again
+    connect(&mInvalidateTimer, &QTimer::timeout, this, &LoggingFilterModel::invalidateRowsFilter);
 }
 
 LoggingFilterModel::~LoggingFilterModel() = default;
 
+void LoggingFilterModel::setSourceModel(QAbstractItemModel *sourceModel)
+{
+    if (mLoggingModel) {
+        mLoggingModel->searchIndex()->disconnect(this);
+    }
+    mLoggingModel = qobject_cast<LoggingModel *>(sourceModel);
+    Q_ASSERT(!sourceModel || mLoggingModel);
+    mSearchTokens.clear();
+    if (mLoggingModel) {
+        connect(mLoggingModel->searchIndex(), &LogSearchIndex::searchFinished, this, &LoggingFilterModel::searchFinished);
+        connect(mLoggingModel->searchIndex(), &LogSearchIndex::matchesAdded, this, &LoggingFilterModel::matchesAdded);
+        // The results shrink with the retention of the model, like the index itself
+        connect(mLoggingModel->searchIndex(), &LogSearchIndex::dropMessages, this, &LoggingFilterModel::dropSearchResults);
+        connect(mLoggingModel->searchIndex(), &LogSearchIndex::clearIndex, this, [this]() {
+            mSearchResults.clear();
+        });
+        mCheckedApps = checkedIds(mCheckedAppNames, mLoggingModel->store().apps());
+        mCheckedCategories = checkedIds(mCheckedCategoryNames, mLoggingModel->store().categories());
+    }
+    QSortFilterProxyModel::setSourceModel(sourceModel);
+}
+
 void LoggingFilterModel::setAppFilter(KCheckComboBox *appFilter)
 {
     if (mAppFilter) {
         mAppFilter->disconnect(this);
     }
     mAppFilter = appFilter;
-    connect(mAppFilter, &KCheckComboBox::checkedItemsChanged, this, [this](const QStringList &items) {
-        mCheckedApps.clear();
-        mCheckedApps.reserve(items.count());
-        for (const auto &item : items) {
-            mCheckedApps.insert(item);
-        }
-        if (!mInvalidateTimer.isActive()) {
-            mInvalidateTimer.start();
-        }
-    });
+    connect(mAppFilter, &KCheckComboBox::checkedItemsChanged, this, &LoggingFilterModel::setCheckedApps);
 }
 
 void LoggingFilterModel::setTypeFilter(KCheckComboBox *typeFilter)
@@ -51,15 +92,14 @@ void LoggingFilterModel::setTypeFilter(KCheckComboBox *typeFilter)
         mTypeFilter->disconnect(this);
     }
     mTypeFilter = typeFilter;
-    connect(mTypeFilter, &KCheckComboBox::checkedItemsChanged, this, [this](const QStringList &items) {
-        mCheckedTypes.clear();
-        mCheckedTypes.reserve(items.count());
-        for (const auto &item : mTypeFilter->checkedItems(Qt::UserRole)) {
-            mCheckedTypes.insert(static_cast<QtMsgType>(item.toInt()));
-        }
-        if (!mInvalidateTimer.isActive()) {
-            mInvalidateTimer.start();
+    connect(mTypeFilter, &KCheckComboBox::checkedItemsChanged, this, [this]() {
+        QList<QtMsgType> types;
+        const auto items = mTypeFilter->checkedItems(Qt::UserRole);
+        types.reserve(items.count());
+        for (const auto &item : items) {
+            types << static_cast<QtMsgType>(item.toInt());
         }
+        setCheckedTypes(types);
     });
 }
 
@@ -69,23 +109,119 @@ void LoggingFilterModel::setCategoryFilter(KCheckComboBox *categoryFilter)
         mCategoryFilter->disconnect(this);
     }
     mCategoryFilter = categoryFilter;
-    connect(mCategoryFilter, &KCheckComboBox::checkedItemsChanged, this, [this](const QStringList &items) {
-        mCheckedCategories.clear();
-        mCheckedCategories.reserve(items.count());
-        for (const auto &item : items) {
-            mCheckedCategories.insert(item);
-        }
-        if (!mInvalidateTimer.isActive()) {
-            mInvalidateTimer.start();
+    connect(mCategoryFilter, &KCheckComboBox::checkedItemsChanged, this, &LoggingFilterModel::setCheckedCategories);
+}
+
+void LoggingFilterModel::setCheckedApps(const QStringList &apps)
+{
+    mCheckedAppNames = apps;
+    if (mLoggingModel) {
+        mCheckedApps = checkedIds(apps, mLoggingModel->store().apps());
+    }
+    scheduleInvalidate();
+}
+
+void LoggingFilterModel::setCheckedCategories(const QStringList &categories)
+{
+    mCheckedCategoryNames = categories;
+    if (mLoggingModel) {
+        mCheckedCategories = checkedIds(categories, mLoggingModel->store().categories());
+    }
+    scheduleInvalidate();
+}
+
+void LoggingFilterModel::setCheckedTypes(const QList<QtMsgType> &types)
+{
+    mCheckedTypes = 0;
+    for (const auto type : types) {
+        mCheckedTypes |= 1U << type;
+    }
+    scheduleInvalidate();
+}
+
+void LoggingFilterModel::setSearchText(const QString &text)
+{
+    mPendingSearchTokens = LogSearchIndex::tokenize(text);
+    if (mPendingSearchTokens.isEmpty() || !mLoggingModel) {
+        // Forget about any search still running
+        ++mSearchGeneration;
+        if (!mSearchTokens.isEmpty()) {
+            mSearchTokens.clear();
+            mSearchResults.clear();
+            scheduleInvalidate();
         }
-    });
+        return;
+    }
+    // The current search stays applied until the index answers
+    mSearchGeneration = mLoggingModel->searchIndex()->search(text);
+}
+
+QStringList LoggingFilterModel::searchTokens() const
+{
+    return mSearchTokens;
+}
+
+int LoggingFilterModel::searchResultCount() const
+{
+    return mSearchResults.count();
+}
+
+void LoggingFilterModel::searchFinished(quint64 generation, const QList<qint64> &serials, qint64 indexedUpTo)
+{
+    if (generation != mSearchGeneration) {
+        return;
+    }
+    mSearchTokens = mPendingSearchTokens;
+    mSearchResults = serials;
+    mSearchIndexedUpTo = indexedUpTo;
+    mInvalidateTimer.stop();
+    invalidateRowsFilter();
+}
+
+void LoggingFilterModel::matchesAdded(quint64 generation, const QList<qint64> &serials, qint64 indexedUpTo)
+{
+    if (generation != mSearchGeneration || mSearchTokens.isEmpty()) {
+        return;
+    }
+    // New messages were already matched directly, so the rows are fine as they are
+    const bool newer = serials.first() > mSearchIndexedUpTo;
+    mSearchResults += serials;
+    mSearchIndexedUpTo = std::max(mSearchIndexedUpTo, indexedUpTo);
+    if (!newer) {
+        // Restored older messages, which were hidden when they were inserted
+        std::sort(mSearchResults.begin(), mSearchResults.end());
+        scheduleInvalidate();
+    }
+}
+
+void LoggingFilterModel::dropSearchResults(qint64 serial)
+{
+    mSearchResults.erase(mSearchResults.begin(), std::lower_bound(mSearchResults.begin(), mSearchResults.end(), serial));
+}
+
+void LoggingFilterModel::scheduleInvalidate()
+{
+    if (!mInvalidateTimer.isActive()) {
+        mInvalidateTimer.start();
+    }
 }
 
 bool LoggingFilterModel::filterAcceptsRow(int source_row, const QModelIndex &) const
 {
-    const auto source_idx = sourceModel()->index(source_row, 0);
-    const auto msg = sourceModel()->data(source_idx, LoggingModel::MessageRole).value<LoggingModel::Message>();
-    return mCheckedApps.contains(msg.app) && mCheckedCategories.contains(msg.category) && mCheckedTypes.contains(msg.type);
+    const auto &store = mLoggingModel->store();
+    if (!(mCheckedTypes & (1U << store.type(source_row))) || !isChecked(mCheckedApps, store.appId(source_row), mCheckedAppNames, store.apps())
+        || !isChecked(mCheckedCategories, store.categoryId(source_row), mCheckedCategoryNames, store.categories())) {
+        return false;
+    }
+
+    if (mSearchTokens.isEmpty()) {
+        return true;
+    }
+    const qint64 serial = store.serial(source_row);
+    if (serial > mSearchIndexedUpTo) {
+        return LogSearchIndex::matches(store.text(source_row), mSearchTokens);
+    }
+    return std::binary_search(mSearchResults.cbegin(), mSearchResults.cend(), serial);
 }
 
 #include "moc_loggingfiltermodel.cpp"
@@ -6,35 +6,70 @@
 
 #pragma once
 
-#include <QSet>
+#include "libakonadiconsole_export.h"
+
+#include <QBitArray>
 #include <QSortFilterProxyModel>
 #include <QTimer>
 
+class LoggingModel;
 namespace KPIM
 {
 class KCheckComboBox;
 }
 
-class LoggingFilterModel : public QSortFilterProxyModel
+class LIBAKONADICONSOLE_EXPORT LoggingFilterModel : public QSortFilterProxyModel
 {
     Q_OBJECT
 public:
     explicit LoggingFilterModel(QObject *parent = nullptr);
     ~LoggingFilterModel() override;
 
+    void setSourceModel(QAbstractItemModel *sourceModel) override;
+
     void setAppFilter(KPIM::KCheckComboBox *appFilter);
     void setCategoryFilter(KPIM::KCheckComboBox *categoryFilter);
     void setTypeFilter(KPIM::KCheckComboBox *typeFilter);
 
+    void setCheckedApps(const QStringList &apps);
+    void setCheckedCategories(const QStringList &categories);
+    void setCheckedTypes(const QList<QtMsgType> &types);
+
+    /** Only shows the messages with words starting with each word of @p text. */
+    void setSearchText(const QString &text);
+    /** The words of the search the filter currently applies, lowercase. */
+    [[nodiscard]] QStringList searchTokens() const;
+    /** Number of indexed messages matching the search, only the retained ones are remembered. */
+    [[nodiscard]] int searchResultCount() const;
+
 protected:
     bool filterAcceptsRow(int source_row, const QModelIndex &source_parent) const override;
 
 private:
+    void scheduleInvalidate();
+    void searchFinished(quint64 generation, const QList<qint64> &serials, qint64 indexedUpTo);
+    void matchesAdded(quint64 generation, const QList<qint64> &serials, qint64 indexedUpTo);
+    void dropSearchResults(qint64 serial);
+
+    LoggingModel *mLoggingModel = nullptr;
     KPIM::KCheckComboBox *mAppFilter = nullptr;
-    QSet<QString> mCheckedApps;
+    QStringList mCheckedAppNames;
+    // Membership by the ids interned by the LoggingModel store, extended
+    // from the names above when a row with a new id is filtered
+    mutable QBitArray mCheckedApps;
     KPIM::KCheckComboBox *mCategoryFilter = nullptr;
-    QSet<QString> mCheckedCategories;
+    QStringList mCheckedCategoryNames;
+    mutable QBitArray mCheckedCategories;
     KPIM::KCheckComboBox *mTypeFilter = nullptr;
-    QSet<QtMsgType> mCheckedTypes;
+    // One bit per QtMsgType
+    quint32 mCheckedTypes = 0;
+    // The search waiting for its result and the one being applied
+    quint64 mSearchGeneration = 0;
+    QStringList mPendingSearchTokens;
+    QStringList mSearchTokens;
+    // Sorted serials of the matching messages, newer messages are not indexed
+    // yet and are matched directly
+    QList<qint64> mSearchResults;
+    qint64 mSearchIndexedUpTo = -1;
     QTimer mInvalidateTimer;
 };
@@ -0,0 +1,101 @@
+/*
+    SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "logginghighlightdelegate.h"
+
+#include "loggingfiltermodel.h"
+#include "loggingmodel.h"
+
+#include <QApplication>
+#include <QPainter>
+#include <QTextLayout>
+#include <QtMath>
+
+#include <algorithm>
+
+LoggingHighlightDelegate::LoggingHighlightDelegate(const LoggingFilterModel *filterModel, QObject *parent)
+    : QStyledItemDelegate(parent)
+    , mFilterModel(filterModel)
+{
+}
+
+LoggingHighlightDelegate::~LoggingHighlightDelegate() = default;
+
+void LoggingHighlightDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    QStyledItemDelegate::paint(painter, option, index);
+
+    const QStringList tokens = mFilterModel->searchTokens();
+    if (tokens.isEmpty() || index.column() != LoggingModel::MessageColumn) {
+        return;
+    }
+
+    QStyleOptionViewItem opt = option;
+    initStyleOption(&opt, index);
+    const QWidget *widget = opt.widget;
+    const QStyle *style = widget ? widget->style() : QApplication::style();
+    QRect textRect = style->subElementRect(QStyle::SE_ItemViewItemText, &opt, widget);
+    const int margin = style->pixelMetric(QStyle::PM_FocusFrameHMargin, nullptr, widget) + 1;
+    textRect.adjust(margin, 0, -margin, 0);
+
+    QColor highlight = opt.palette.color(QPalette::Highlight);
+    highlight.setAlpha(80);
+
+    // Lay out what the style actually paints: the first line, elided to the rect
+    QString text = opt.text.section(u'\n', 0, 0);
+    text = opt.fontMetrics.elidedText(text, opt.textElideMode, textRect.width());
+    QTextLayout layout(text, opt.font);
+    QTextOption textOption(opt.displayAlignment);
+    textOption.setTextDirection(opt.direction);
+    textOption.setWrapMode(QTextOption::NoWrap);
+    layout.setTextOption(textOption);
+    layout.beginLayout();
+    QTextLine line = layout.createLine();
+    if (!line.isValid()) {
+        layout.endLayout();
+        return;
+    }
+    line.setLineWidth(textRect.width());
+    layout.endLayout();
+    const QRect lineRect =
+        QStyle::alignedRect(opt.direction, opt.displayAlignment, QSize(qCeil(line.naturalTextWidth()), textRect.height()), textRect);
+    const bool leftToRight = opt.direction == Qt::LeftToRight;
+
+    painter->save();
+    painter->setClipRect(textRect);
+    // Walk the words the same way LogSearchIndex splits them, and mark the matching prefixes
+    qsizetype start = -1;
+    for (qsizetype i = 0; i <= text.size(); ++i) {
+        if (i < text.size() && text[i].isLetterOrNumber()) {
+            if (start < 0) {
+                start = i;
+            }
+            continue;
+        }
+        if (start < 0) {
+            continue;
+        }
+        const QStringView word = QStringView(text).mid(start, i - start);
+        qsizetype length = 0;
+        for (const auto &token : tokens) {
+            if (word.startsWith(token, Qt::CaseInsensitive)) {
+                length = std::max(length, token.size());
+            }
+        }
+        if (length > 0) {
+            const int from = lineRect.left() + qRound(line.cursorToX(int(start)));
+            if (leftToRight && from > textRect.right()) {
+                break;
+            }
+            const int to = lineRect.left() + qRound(line.cursorToX(int(start + length)));
+            painter->fillRect(QRect(QPoint(std::min(from, to), textRect.top()), QPoint(std::max(from, to) - 1, textRect.bottom())), highlight);
+        }
+        start = -1;
+    }
+    painter->restore();
+}
+
+#include "moc_logginghighlightdelegate.cpp"
@@ -0,0 +1,27 @@
+/*
+    SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QStyledItemDelegate>
+
+class LoggingFilterModel;
+
+/**
+ * Highlights the words matching the search of a LoggingFilterModel in the message column.
+ */
+class LoggingHighlightDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+public:
+    explicit LoggingHighlightDelegate(const LoggingFilterModel *filterModel, QObject *parent = nullptr);
+    ~LoggingHighlightDelegate() override;
+
+    void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+
+private:
+    const LoggingFilterModel *const mFilterModel;
+};
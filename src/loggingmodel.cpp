@@ -7,6 +7,8 @@
 #include "loggingmodel.h"
 using namespace Qt::Literals::StringLiterals;
 
+#include "logsearchindex.h"
+
 #include <KLocalizedString>
 
 #include <QDateTime>
@@ -17,24 +19,32 @@ Q_DECLARE_METATYPE(LoggingModel::Message)
 
 LoggingModel::LoggingModel(QObject *parent)
     : QAbstractItemModel(parent)
+    , mSearchIndex(new LogSearchIndex(this))
 {
+    mTypeNames[QtDebugMsg] = i18n("Debug");
+    mTypeNames[QtInfoMsg] = i18n("Info");
+    mTypeNames[QtWarningMsg] = i18n("Warning");
+    mTypeNames[QtCriticalMsg] = i18n("Critical");
+    mTypeNames[QtFatalMsg] = i18n("Fatal");
 }
 
 LoggingModel::~LoggingModel() = default;
 
-QString LoggingModel::cacheString(const QString &str, QSet<QString> &cache, QStandardItemModel *model)
+void LoggingModel::addFilterItems(QStandardItemModel *model, const LogMessageStore::StringTable &table, int first)
 {
-    auto it = cache.constFind(str);
-    if (it == cache.constEnd()) {
-        if (model) {
-            auto item = new QStandardItem(str);
-            item->setCheckState(Qt::Checked);
-            model->appendRow(item);
-        }
-        cache.insert(str);
-        return str;
+    if (!model || first >= table.count()) {
+        return;
+    }
+
+    QList<QStandardItem *> items;
+    items.reserve(table.count() - first);
+    for (int id = first; id < table.count(); ++id) {
+        auto item = new QStandardItem(table.at(id));
+        item->setCheckState(Qt::Checked);
+        items << item;
     }
-    return *it;
+    // One insertion, so that the combo box and the filter only update once
+    model->invisibleRootItem()->appendRows(items);
 }
 
 void LoggingModel::addMessage(qint64 timestamp,
@@ -47,19 +57,140 @@ void LoggingModel::addMessage(qint64 timestamp,
                               int line,
                               const QString &message)
 {
-    beginInsertRows({}, mMessages.count(), mMessages.count());
-    mMessages.push_back({timestamp,
-                         cacheString(app, mAppCache, mAppFilterModel),
-                         pid,
-                         cacheString(category, mCategoryCache, mCategoryFilterModel),
-                         cacheString(file, mFileCache),
-                         cacheString(function, mFunctionCache),
-                         message,
-                         type,
-                         line});
+    addMessages({{timestamp, app, pid, category, file, function, message, type, line}});
+}
+
+void LoggingModel::addMessages(const QList<Message> &messages)
+{
+    if (messages.isEmpty()) {
+        return;
+    }
+
+    dropExcessMessages(messages.count());
+
+    const int appCount = mStore.apps().count();
+    const int categoryCount = mStore.categories().count();
+
+    const int first = mStore.count();
+    beginInsertRows({}, first, first + messages.count() - 1);
+    for (const auto &msg : messages) {
+        const int row = mStore.append(msg.timestamp, msg.app, msg.pid, msg.type, msg.category, msg.file, msg.function, msg.line, msg.message);
+        mSearchIndex->addMessage(mStore.serial(row), msg.message);
+        mRateMonitor.addMessage(msg.timestamp, mStore.appId(row), mStore.categoryId(row));
+    }
+    // New programs and categories must be checked in the filters before the rows are filtered
+    addFilterItems(mAppFilterModel, mStore.apps(), appCount);
+    addFilterItems(mCategoryFilterModel, mStore.categories(), categoryCount);
+    for (int id = mFileNames.count(); id < mStore.files().count(); ++id) {
+        const auto &file = mStore.files().at(id);
+        mFileNames << file.mid(file.lastIndexOf(QDir::separator()) + 1, -1);
+    }
     endInsertRows();
 }
 
+void LoggingModel::clear()
+{
+    const qint64 spilled = mStore.spilledCount();
+    beginResetModel();
+    mStore.clear();
+    mSearchIndex->clear();
+    mRateMonitor.clear();
+    endResetModel();
+    if (spilled > 0) {
+        Q_EMIT spilledCountChanged(0);
+    }
+}
+
+void LoggingModel::setMaximumCount(int count)
+{
+    mStore.setCapacity(count);
+    dropExcessMessages(0);
+}
+
+void LoggingModel::setSpillToDisk(bool spill)
+{
+    const qint64 spilled = mStore.spilledCount();
+    mStore.setSpillEnabled(spill);
+    if (mStore.spilledCount() != spilled) {
+        Q_EMIT spilledCountChanged(mStore.spilledCount());
+    }
+}
+
+qint64 LoggingModel::spilledCount() const
+{
+    return mStore.spilledCount();
+}
+
+bool LoggingModel::loadSpilled()
+{
+    // The history is paged in, never more of it than the retention allows
+    if (!mStore.canRestoreBlock()) {
+        return false;
+    }
+    const bool read = mStore.readSpilledBlock();
+    if (read) {
+        beginInsertRows({}, 0, LogMessageStore::BlockSize - 1);
+        mStore.restoreSpilledBlock();
+        for (int row = 0; row < LogMessageStore::BlockSize; ++row) {
+            mSearchIndex->addMessage(mStore.serial(row), mStore.text(row));
+        }
+        endInsertRows();
+    }
+    // Unreadable segments are dropped as well
+    Q_EMIT spilledCountChanged(mStore.spilledCount());
+    return read;
+}
+
+void LoggingModel::unloadSpilled()
+{
+    mStore.releaseRestoredBlocks();
+    dropExcessMessages(0);
+}
+
+void LoggingModel::dropExcessMessages(int incoming)
+{
+    const int blocks = mStore.excessBlocks(incoming);
+    if (blocks == 0) {
+        return;
+    }
+
+    beginRemoveRows({}, 0, blocks * LogMessageStore::BlockSize - 1);
+    mStore.dropFrontBlocks(blocks);
+    mSearchIndex->dropBefore(mStore.firstSerial());
+    endRemoveRows();
+    if (mStore.isSpillEnabled()) {
+        Q_EMIT spilledCountChanged(mStore.spilledCount());
+    }
+}
+
+const LogMessageStore &LoggingModel::store() const
+{
+    return mStore;
+}
+
+LogSearchIndex *LoggingModel::searchIndex() const
+{
+    return mSearchIndex;
+}
+
+LogRateMonitor &LoggingModel::rateMonitor()
+{
+    return mRateMonitor;
+}
+
+LoggingModel::Message LoggingModel::message(int row) const
+{
+    return {mStore.timestamp(row),
+            mStore.apps().at(mStore.appId(row)),
+            mStore.pid(row),
+            mStore.categories().at(mStore.categoryId(row)),
+            mStore.files().at(mStore.fileId(row)),
+            mStore.functions().at(mStore.functionId(row)),
+            mStore.text(row),
+            mStore.type(row),
+            mStore.line(row)};
+}
+
 void LoggingModel::setAppFilterModel(QStandardItemModel *appFilterModel)
 {
     mAppFilterModel = appFilterModel;
@@ -72,7 +203,7 @@ void LoggingModel::setCategoryFilterModel(QStandardItemModel *categoryFilterMode
 
 int LoggingModel::rowCount(const QModelIndex &parent) const
 {
-    return parent.isValid() ? 0 : mMessages.count();
+    return parent.isValid() ? 0 : mStore.count();
 }
 
 int LoggingModel::columnCount(const QModelIndex &) const
@@ -82,7 +213,7 @@ int LoggingModel::columnCount(const QModelIndex &) const
 
 QModelIndex LoggingModel::index(int row, int column, const QModelIndex &parent) const
 {
-    if (parent.isValid() || row < 0 || row >= mMessages.count() || column < 0 || column >= _ColumnCount) {
+    if (parent.isValid() || row < 0 || row >= mStore.count() || column < 0 || column >= _ColumnCount) {
         return {};
     }
 
@@ -121,66 +252,62 @@ QVariant LoggingModel::headerData(int section, Qt::Orientation orientation, int
 
 QVariant LoggingModel::data(const QModelIndex &index, int role) const
 {
-    if (!index.isValid() || index.row() >= mMessages.count() || index.column() >= _ColumnCount) {
+    if (!index.isValid() || index.row() >= mStore.count() || index.column() >= _ColumnCount) {
         return {};
     }
 
-    const auto message = mMessages.at(index.row());
+    // Only look up the column that is asked for, a view asks for many roles per cell
+    const int row = index.row();
     if (role == Qt::DisplayRole) {
         switch (index.column()) {
         case TimeColumn:
-            return QDateTime::fromMSecsSinceEpoch(message.timestamp).toString(Qt::ISODateWithMs);
+            return QDateTime::fromMSecsSinceEpoch(mStore.timestamp(row)).toString(Qt::ISODateWithMs);
         case AppColumn:
-            return u"%1(%2)"_s.arg(message.app, QString::number(message.pid));
-        case TypeColumn:
-            switch (message.type) {
-            case QtDebugMsg:
-                return i18n("Debug");
-            case QtInfoMsg:
-                return i18n("Info");
-            case QtWarningMsg:
-                return i18n("Warning");
-            case QtCriticalMsg:
-                return i18n("Critical");
-            case QtFatalMsg:
-                return i18n("Fatal");
-            }
-            return {};
+            return u"%1(%2)"_s.arg(mStore.apps().at(mStore.appId(row)), QString::number(mStore.pid(row)));
+        case TypeColumn: {
+            const auto type = mStore.type(row);
+            return type <= QtInfoMsg ? mTypeNames[type] : QVariant();
+        }
         case CategoryColumn:
-            return message.category;
-        case FileColumn:
-            if (!message.file.isEmpty()) {
-                const auto file = message.file.mid(message.file.lastIndexOf(QDir::separator()) + 1, -1);
-                if (message.line > 0) {
-                    return i18n("%1:%2", file, QString::number(message.line));
+            return mStore.categories().at(mStore.categoryId(row));
+        case FileColumn: {
+            const auto &file = mFileNames.at(mStore.fileId(row));
+            if (!file.isEmpty()) {
+                const int line = mStore.line(row);
+                if (line > 0) {
+                    return i18n("%1:%2", file, QString::number(line));
                 } else {
                     return file;
                 }
             }
             return {};
+        }
         case FunctionColumn:
-            return message.function;
+            return mStore.functions().at(mStore.functionId(row));
         case MessageColumn:
-            return message.message;
+            return mStore.text(row);
         }
     } else if (role == Qt::ToolTipRole) {
         switch (index.column()) {
-        case FileColumn:
-            if (!message.file.isEmpty()) {
-                if (message.line > 0) {
-                    return i18n("%1:%2", message.file, QString::number(message.line));
+        case FileColumn: {
+            const auto &file = mStore.files().at(mStore.fileId(row));
+            if (!file.isEmpty()) {
+                const int line = mStore.line(row);
+                if (line > 0) {
+                    return i18n("%1:%2", file, QString::number(line));
                 } else {
-                    return message.file;
+                    return file;
                 }
             }
             return {};
+        }
         case FunctionColumn:
-            return message.function;
+            return mStore.functions().at(mStore.functionId(row));
         case MessageColumn:
-            return message.message;
+            return mStore.text(row);
         }
     } else if (role == MessageRole) {
-        return QVariant::fromValue(message);
+        return QVariant::fromValue(message(row));
     }
 
     return {};
@@ -6,12 +6,16 @@
 
 #pragma once
 
+#include "libakonadiconsole_export.h"
+#include "logmessagestore.h"
+#include "logratemonitor.h"
+
 #include <QAbstractItemModel>
-#include <QSet>
 
+class LogSearchIndex;
 class QStandardItemModel;
 
-class LoggingModel : public QAbstractItemModel
+class LIBAKONADICONSOLE_EXPORT LoggingModel : public QAbstractItemModel
 {
     Q_OBJECT
 public:
@@ -55,10 +59,34 @@ public:
                     const QString &function,
                     int line,
                     const QString &message);
+    /** Appends @p messages with a single row insertion. */
+    void addMessages(const QList<Message> &messages);
+
+    void clear();
+
+    /** Maximum number of messages kept in memory, 0 means unlimited. */
+    void setMaximumCount(int count);
+    /** Whether messages over the maximum are moved to disk instead of being dropped. */
+    void setSpillToDisk(bool spill);
+    [[nodiscard]] qint64 spilledCount() const;
+    /**
+     * Moves the newest block of spilled messages back in front of the messages in memory.
+     * Returns false when nothing was spilled or memory already holds twice the maximum count.
+     */
+    bool loadSpilled();
+    /** Lets the retention move the messages restored by loadSpilled() back to disk. */
+    void unloadSpilled();
 
     void setAppFilterModel(QStandardItemModel *appFilterModel);
     void setCategoryFilterModel(QStandardItemModel *categoryFilterModel);
 
+    /** Direct access to the messages, for code that walks the whole log. */
+    [[nodiscard]] const LogMessageStore &store() const;
+    /** Index of the messages in the store, it follows the retention of the model. */
+    [[nodiscard]] LogSearchIndex *searchIndex() const;
+    /** Message rates of the programs and categories, fed by every added message. */
+    [[nodiscard]] LogRateMonitor &rateMonitor();
+
     int rowCount(const QModelIndex &parent = {}) const override;
     int columnCount(const QModelIndex &parent = {}) const override;
 
@@ -68,14 +96,20 @@ public:
     QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
     QVariant data(const QModelIndex &index, int role) const override;
 
-private:
-    static QString cacheString(const QString &str, QSet<QString> &cache, QStandardItemModel *model = nullptr);
+Q_SIGNALS:
+    void spilledCountChanged(qint64 count);
 
-    QList<Message> mMessages;
+private:
+    void dropExcessMessages(int incoming);
+    static void addFilterItems(QStandardItemModel *model, const LogMessageStore::StringTable &table, int first);
+    [[nodiscard]] Message message(int row) const;
+
+    LogMessageStore mStore;
+    LogSearchIndex *const mSearchIndex;
+    LogRateMonitor mRateMonitor;
+    // File names without the path, by file id
+    QList<QString> mFileNames;
+    QString mTypeNames[QtInfoMsg + 1];
     QStandardItemModel *mAppFilterModel = nullptr;
-    QSet<QString> mAppCache;
     QStandardItemModel *mCategoryFilterModel = nullptr;
-    QSet<QString> mCategoryCache;
-    QSet<QString> mFileCache;
-    QSet<QString> mFunctionCache;
 };
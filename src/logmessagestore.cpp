@@ -0,0 +1,310 @@
+/*
+    SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "logmessagestore.h"
+using namespace Qt::Literals::StringLiterals;
+
+#include "akonadiconsole_debug.h"
+
+#include <QFile>
+#include <QStringEncoder>
+#include <QTemporaryDir>
+
+#include <algorithm>
+
+namespace
+{
+constexpr quint32 SegmentMagic = 0x414b4c53; // "AKLS"
+constexpr quint32 SegmentVersion = 1;
+
+template<typename T, std::size_t N>
+bool writeArray(QIODevice &device, const std::array<T, N> &array)
+{
+    const auto size = qint64(sizeof(T) * N);
+    return device.write(reinterpret_cast<const char *>(array.data()), size) == size;
+}
+
+template<typename T, std::size_t N>
+bool readArray(QIODevice &device, std::array<T, N> &array)
+{
+    const auto size = qint64(sizeof(T) * N);
+    return device.read(reinterpret_cast<char *>(array.data()), size) == size;
+}
+}
+
+int LogMessageStore::StringTable::intern(const QString &str)
+{
+    auto it = mIds.constFind(str);
+    if (it != mIds.constEnd()) {
+        return *it;
+    }
+    const int id = mStrings.count();
+    mStrings << str;
+    mIds.insert(str, id);
+    return id;
+}
+
+int LogMessageStore::StringTable::indexOf(const QString &str) const
+{
+    return mIds.value(str, -1);
+}
+
+void LogMessageStore::StringTable::clear()
+{
+    mStrings.clear();
+    mIds.clear();
+}
+
+LogMessageStore::LogMessageStore() = default;
+
+LogMessageStore::LogMessageStore(LogMessageStore &&other) noexcept = default;
+
+LogMessageStore &LogMessageStore::operator=(LogMessageStore &&other) noexcept = default;
+
+LogMessageStore::~LogMessageStore() = default;
+
+LogMessageStore LogMessageStore::snapshot() const
+{
+    LogMessageStore snapshot;
+    snapshot.mBlocks = mBlocks;
+    if (mCount % BlockSize != 0) {
+        snapshot.mBlocks.back() = std::make_shared<Block>(*mBlocks.back());
+    }
+    snapshot.mCount = mCount;
+    snapshot.mFirstSerial = mFirstSerial;
+    snapshot.mApps = mApps;
+    snapshot.mCategories = mCategories;
+    snapshot.mFiles = mFiles;
+    snapshot.mFunctions = mFunctions;
+    return snapshot;
+}
+
+int LogMessageStore::append(qint64 timestamp,
+                            const QString &app,
+                            qint64 pid,
+                            QtMsgType type,
+                            const QString &category,
+                            const QString &file,
+                            const QString &function,
+                            int line,
+                            const QString &message)
+{
+    const int row = mCount;
+    const int pos = row % BlockSize;
+    if (pos == 0) {
+        mBlocks.push_back(std::make_shared<Block>());
+    }
+
+    auto &block = *mBlocks.back();
+    block.timestamps[pos] = timestamp;
+    block.pids[pos] = pid;
+    block.apps[pos] = mApps.intern(app);
+    block.categories[pos] = mCategories.intern(category);
+    block.files[pos] = mFiles.intern(file);
+    block.functions[pos] = mFunctions.intern(function);
+    block.lines[pos] = line;
+    block.types[pos] = static_cast<quint8>(type);
+
+    // Encode straight into the arena instead of through a temporary QByteArray
+    QStringEncoder encoder(QStringEncoder::Utf8);
+    const qsizetype start = block.arena.size();
+    block.arena.resize(start + encoder.requiredSpace(message.size()));
+    char *end = encoder.appendToBuffer(block.arena.data() + start, message);
+    block.arena.truncate(end - block.arena.constData());
+    block.textEnds[pos] = block.arena.size();
+
+    ++mCount;
+    return row;
+}
+
+void LogMessageStore::clear()
+{
+    // Snapshots share the blocks, but the segment files belong to the store that spilled them
+    for (const auto &block : mBlocks) {
+        if (mSpillDir && !block->spillFile.isEmpty()) {
+            QFile::remove(block->spillFile);
+        }
+    }
+    mBlocks.clear();
+    // Serials are never reused, start at the next block
+    mFirstSerial += (qint64(mCount) + BlockSize - 1) / BlockSize * BlockSize;
+    mCount = 0;
+    for (const auto &fileName : std::as_const(mSpilled)) {
+        QFile::remove(fileName);
+    }
+    mSpilled.clear();
+    mReadBlock.reset();
+    mRestoredBlocks = 0;
+}
+
+QByteArrayView LogMessageStore::textUtf8(int row) const
+{
+    const auto &block = this->block(row);
+    const int pos = row % BlockSize;
+    const quint32 start = pos == 0 ? 0 : block.textEnds[pos - 1];
+    return QByteArrayView(block.arena.constData() + start, block.textEnds[pos] - start);
+}
+
+int LogMessageStore::capacity() const
+{
+    return mCapacity;
+}
+
+void LogMessageStore::setCapacity(int capacity)
+{
+    mCapacity = std::max(capacity, 0);
+}
+
+int LogMessageStore::excessBlocks(int incoming) const
+{
+    if (mCapacity == 0) {
+        return 0;
+    }
+    // Restored messages may take as much room again as the capacity, past
+    // that the oldest of them go back to disk
+    const qint64 limit = mRestoredBlocks > 0 ? 2 * qint64(mCapacity) : mCapacity;
+    const qint64 excess = qint64(mCount) + incoming - limit;
+    if (excess <= 0) {
+        return 0;
+    }
+    // Only full blocks can go, the last one is still being filled
+    return std::min<int>((excess + BlockSize - 1) / BlockSize, mCount / BlockSize);
+}
+
+void LogMessageStore::dropFrontBlocks(int count)
+{
+    for (int i = 0; i < count && !mBlocks.empty(); ++i) {
+        auto &block = *mBlocks.front();
+        if (mSpillDir) {
+            if (block.spillFile.isEmpty()) {
+                const QString fileName = mSpillDir->filePath(u"segment-%1"_s.arg(mSpillSerial++));
+                if (writeBlock(block, fileName)) {
+                    block.spillFile = fileName;
+                } else {
+                    qCWarning(AKONADICONSOLE_LOG) << "Failed to spill log messages to" << fileName;
+                    QFile::remove(fileName);
+                }
+            }
+            if (!block.spillFile.isEmpty()) {
+                mSpilled << block.spillFile;
+            }
+        }
+        mBlocks.pop_front();
+        mCount -= BlockSize;
+        mFirstSerial += BlockSize;
+        if (mRestoredBlocks > 0) {
+            --mRestoredBlocks;
+        }
+    }
+}
+
+bool LogMessageStore::isSpillEnabled() const
+{
+    return mSpillDir != nullptr;
+}
+
+void LogMessageStore::setSpillEnabled(bool enabled)
+{
+    if (enabled == isSpillEnabled()) {
+        return;
+    }
+
+    if (enabled) {
+        mSpillDir = std::make_unique<QTemporaryDir>();
+        if (!mSpillDir->isValid()) {
+            qCWarning(AKONADICONSOLE_LOG) << "Failed to create a directory for spilled log messages:" << mSpillDir->errorString();
+            mSpillDir.reset();
+        }
+    } else {
+        // Removes all the segments along with the directory
+        mSpillDir.reset();
+        mSpilled.clear();
+        mReadBlock.reset();
+        for (auto &block : mBlocks) {
+            block->spillFile.clear();
+        }
+    }
+}
+
+qint64 LogMessageStore::spilledCount() const
+{
+    return qint64(mSpilled.count()) * BlockSize;
+}
+
+bool LogMessageStore::readSpilledBlock()
+{
+    while (!mSpilled.isEmpty()) {
+        const QString fileName = mSpilled.takeLast();
+        mReadBlock = readBlock(fileName);
+        if (mReadBlock) {
+            mReadBlock->spillFile = fileName;
+            return true;
+        }
+        qCWarning(AKONADICONSOLE_LOG) << "Failed to read spilled log messages from" << fileName;
+        QFile::remove(fileName);
+    }
+    return false;
+}
+
+void LogMessageStore::restoreSpilledBlock()
+{
+    Q_ASSERT(mReadBlock);
+    mBlocks.push_front(std::move(mReadBlock));
+    mCount += BlockSize;
+    mFirstSerial -= BlockSize;
+    ++mRestoredBlocks;
+}
+
+bool LogMessageStore::canRestoreBlock() const
+{
+    // Same limit as excessBlocks(), a restored block must not push out another one
+    return mCapacity == 0 || qint64(mCount) + BlockSize <= 2 * qint64(mCapacity);
+}
+
+void LogMessageStore::releaseRestoredBlocks()
+{
+    mRestoredBlocks = 0;
+}
+
+bool LogMessageStore::writeBlock(const Block &block, const QString &fileName) const
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    const quint32 header[] = {SegmentMagic, SegmentVersion, BlockSize, quint32(block.arena.size())};
+    return file.write(reinterpret_cast<const char *>(header), sizeof(header)) == sizeof(header) && writeArray(file, block.timestamps)
+        && writeArray(file, block.pids) && writeArray(file, block.apps) && writeArray(file, block.categories) && writeArray(file, block.files)
+        && writeArray(file, block.functions) && writeArray(file, block.lines) && writeArray(file, block.textEnds) && writeArray(file, block.types)
+        && file.write(block.arena) == block.arena.size();
+}
+
+std::unique_ptr<LogMessageStore::Block> LogMessageStore::readBlock(const QString &fileName) const
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return {};
+    }
+
+    quint32 header[4];
+    if (file.read(reinterpret_cast<char *>(header), sizeof(header)) != sizeof(header) || header[0] != SegmentMagic || header[1] != SegmentVersion
+        || header[2] != BlockSize) {
+        return {};
+    }
+
+    auto block = std::make_unique<Block>();
+    if (!readArray(file, block->timestamps) || !readArray(file, block->pids) || !readArray(file, block->apps) || !readArray(file, block->categories)
+        || !readArray(file, block->files) || !readArray(file, block->functions) || !readArray(file, block->lines) || !readArray(file, block->textEnds)
+        || !readArray(file, block->types)) {
+        return {};
+    }
+    block->arena = file.read(header[3]);
+    if (block->arena.size() != qsizetype(header[3])) {
+        return {};
+    }
+    return block;
+}
@@ -0,0 +1,228 @@
+/*
+    SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "libakonadiconsole_export.h"
+
+#include <QByteArrayView>
+#include <QHash>
+#include <QList>
+#include <QString>
+
+#include <array>
+#include <deque>
+#include <memory>
+
+class QTemporaryDir;
+
+/**
+ * Column-oriented storage of the log messages received by the Logging tab.
+ *
+ * Programs, categories, files and functions repeat over and over, so they are
+ * interned and every message only stores their ids. Message texts are kept as
+ * UTF-8 in one arena per block of messages and are only decoded when shown.
+ *
+ * The store can be capped, in which case the oldest blocks are dropped, or
+ * spilled to segment files in a temporary directory from where they can be
+ * read back later. Interned strings are never dropped, so the ids stored in
+ * spilled segments stay valid.
+ */
+class LIBAKONADICONSOLE_EXPORT LogMessageStore
+{
+public:
+    /** Maps each distinct string to a small, stable id. */
+    class LIBAKONADICONSOLE_EXPORT StringTable
+    {
+    public:
+        int intern(const QString &str);
+        [[nodiscard]] int indexOf(const QString &str) const;
+        [[nodiscard]] const QString &at(int id) const
+        {
+            return mStrings.at(id);
+        }
+        [[nodiscard]] int count() const
+        {
+            return mStrings.count();
+        }
+        void clear();
+
+    private:
+        QList<QString> mStrings;
+        QHash<QString, int> mIds;
+    };
+
+    static constexpr int BlockSize = 4096;
+
+    LogMessageStore();
+    LogMessageStore(LogMessageStore &&other) noexcept;
+    LogMessageStore &operator=(LogMessageStore &&other) noexcept;
+    ~LogMessageStore();
+
+    /**
+     * A read-only copy of the messages in memory that can be read from another
+     * thread while this store keeps changing. Full blocks never change, so they
+     * are shared and only the block being filled is copied.
+     */
+    [[nodiscard]] LogMessageStore snapshot() const;
+
+    /** Appends a message and returns its row. */
+    int append(qint64 timestamp,
+               const QString &app,
+               qint64 pid,
+               QtMsgType type,
+               const QString &category,
+               const QString &file,
+               const QString &function,
+               int line,
+               const QString &message);
+    /** Drops all messages, the interned strings are kept. */
+    void clear();
+
+    /** Maximum number of messages kept in memory, 0 means unlimited. */
+    [[nodiscard]] int capacity() const;
+    void setCapacity(int capacity);
+
+    /** Number of oldest blocks that have to go so that @p incoming more messages fit. */
+    [[nodiscard]] int excessBlocks(int incoming) const;
+    /** Drops the oldest blocks, writing them to disk first when spilling is enabled. */
+    void dropFrontBlocks(int count);
+
+    [[nodiscard]] bool isSpillEnabled() const;
+    void setSpillEnabled(bool enabled);
+    /** Number of messages that were dropped to disk and can be read back. */
+    [[nodiscard]] qint64 spilledCount() const;
+    /**
+     * Reads the newest spilled block back, restoreSpilledBlock() then puts it in
+     * front of the messages in memory.
+     */
+    [[nodiscard]] bool readSpilledBlock();
+    void restoreSpilledBlock();
+    /** Whether one more block can be restored without going past twice the capacity. */
+    [[nodiscard]] bool canRestoreBlock() const;
+    /**
+     * While there are restored blocks the store may grow to twice its capacity
+     * before they are dropped again, this lets the next excessBlocks() move
+     * them back to disk right away.
+     */
+    void releaseRestoredBlocks();
+
+    [[nodiscard]] int count() const
+    {
+        return mCount;
+    }
+
+    /**
+     * Every message gets a serial number that does not change when older
+     * messages are dropped or restored, unlike its row.
+     */
+    [[nodiscard]] qint64 serial(int row) const
+    {
+        return mFirstSerial + row;
+    }
+    [[nodiscard]] qint64 firstSerial() const
+    {
+        return mFirstSerial;
+    }
+
+    [[nodiscard]] qint64 timestamp(int row) const
+    {
+        return block(row).timestamps[row % BlockSize];
+    }
+    [[nodiscard]] qint64 pid(int row) const
+    {
+        return block(row).pids[row % BlockSize];
+    }
+    [[nodiscard]] QtMsgType type(int row) const
+    {
+        return static_cast<QtMsgType>(block(row).types[row % BlockSize]);
+    }
+    [[nodiscard]] int appId(int row) const
+    {
+        return block(row).apps[row % BlockSize];
+    }
+    [[nodiscard]] int categoryId(int row) const
+    {
+        return block(row).categories[row % BlockSize];
+    }
+    [[nodiscard]] int fileId(int row) const
+    {
+        return block(row).files[row % BlockSize];
+    }
+    [[nodiscard]] int functionId(int row) const
+    {
+        return block(row).functions[row % BlockSize];
+    }
+    [[nodiscard]] int line(int row) const
+    {
+        return block(row).lines[row % BlockSize];
+    }
+
+    /** The message text as stored, without decoding it. */
+    [[nodiscard]] QByteArrayView textUtf8(int row) const;
+    [[nodiscard]] QString text(int row) const
+    {
+        return QString::fromUtf8(textUtf8(row));
+    }
+
+    [[nodiscard]] const StringTable &apps() const
+    {
+        return mApps;
+    }
+    [[nodiscard]] const StringTable &categories() const
+    {
+        return mCategories;
+    }
+    [[nodiscard]] const StringTable &files() const
+    {
+        return mFiles;
+    }
+    [[nodiscard]] const StringTable &functions() const
+    {
+        return mFunctions;
+    }
+
+private:
+    struct Block {
+        std::array<qint64, BlockSize> timestamps;
+        std::array<qint64, BlockSize> pids;
+        std::array<quint32, BlockSize> apps;
+        std::array<quint32, BlockSize> categories;
+        std::array<quint32, BlockSize> files;
+        std::array<quint32, BlockSize> functions;
+        std::array<qint32, BlockSize> lines;
+        // Where the text of each message ends in the arena
+        std::array<quint32, BlockSize> textEnds;
+        std::array<quint8, BlockSize> types;
+        QByteArray arena;
+        // Set when the block was already written to disk once
+        QString spillFile;
+    };
+
+    [[nodiscard]] bool writeBlock(const Block &block, const QString &fileName) const;
+    [[nodiscard]] std::unique_ptr<Block> readBlock(const QString &fileName) const;
+
+    [[nodiscard]] const Block &block(int row) const
+    {
+        return *mBlocks[row / BlockSize];
+    }
+
+    std::deque<std::shared_ptr<Block>> mBlocks;
+    int mCount = 0;
+    // Always the first serial of a block
+    qint64 mFirstSerial = 0;
+    int mCapacity = 0;
+    std::unique_ptr<QTemporaryDir> mSpillDir;
+    // Segment files of the dropped blocks, oldest first
+    QList<QString> mSpilled;
+    int mSpillSerial = 0;
+    std::unique_ptr<Block> mReadBlock;
+    int mRestoredBlocks = 0;
+    StringTable mApps;
+    StringTable mCategories;
+    StringTable mFiles;
+    StringTable mFunctions;
+};
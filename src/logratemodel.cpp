@@ -0,0 +1,151 @@
+/*
+    SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "logratemodel.h"
+
+#include "loggingmodel.h"
+#include "logratemonitor.h"
+
+#include <KColorScheme>
+#include <KLocalizedString>
+
+#include <QColor>
+#include <QDateTime>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+using namespace std::chrono_literals;
+
+LogRateModel::LogRateModel(LoggingModel *loggingModel, QObject *parent)
+    : QAbstractTableModel(parent)
+    , mLoggingModel(loggingModel)
+{
+    mRefreshTimer.setInterval(1s);
+    connect(&mRefreshTimer, &QTimer::timeout, this, &LogRateModel::refresh);
+    connect(mLoggingModel, &QAbstractItemModel::modelReset, this, &LogRateModel::refresh);
+}
+
+LogRateModel::~LogRateModel() = default;
+
+void LogRateModel::setActive(bool active)
+{
+    if (active) {
+        refresh();
+        mRefreshTimer.start();
+    } else {
+        mRefreshTimer.stop();
+    }
+}
+
+void LogRateModel::refresh()
+{
+    auto &monitor = mLoggingModel->rateMonitor();
+    monitor.advanceTo(QDateTime::currentMSecsSinceEpoch());
+
+    const int appCount = monitor.seriesCount(LogRateMonitor::App);
+    const int categoryCount = monitor.seriesCount(LogRateMonitor::Category);
+    if (appCount != mAppCount || categoryCount != mCategoryCount) {
+        beginResetModel();
+        mAppCount = appCount;
+        mCategoryCount = categoryCount;
+        mMaximumCount = monitor.maximumCount();
+        endResetModel();
+    } else if (appCount + categoryCount > 0) {
+        mMaximumCount = monitor.maximumCount();
+        Q_EMIT dataChanged(index(0, 0), index(rowCount() - 1, columnCount() - 1));
+    }
+}
+
+int LogRateModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : mAppCount + mCategoryCount;
+}
+
+int LogRateModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : FirstSecondColumn + LogRateMonitor::WindowSeconds;
+}
+
+QVariant LogRateModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return {};
+    }
+
+    switch (section) {
+    case KindColumn:
+        return i18n("Kind");
+    case NameColumn:
+        return i18n("Name");
+    case RateColumn:
+        return i18n("Messages/s");
+    case BaselineColumn:
+        return i18n("Baseline");
+    }
+    // Label every ten seconds, the columns are too narrow for more
+    const int secondsAgo = columnCount() - 1 - section;
+    if (secondsAgo % 10 == 0) {
+        return secondsAgo == 0 ? i18nc("@title:column current second", "now") : i18nc("@title:column seconds ago", "-%1s", secondsAgo);
+    }
+    return {};
+}
+
+QVariant LogRateModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= rowCount()) {
+        return {};
+    }
+
+    const auto &monitor = mLoggingModel->rateMonitor();
+    const auto &store = mLoggingModel->store();
+    const bool isApp = index.row() < mAppCount;
+    const auto kind = isApp ? LogRateMonitor::App : LogRateMonitor::Category;
+    const int id = isApp ? index.row() : index.row() - mAppCount;
+
+    if (index.column() >= FirstSecondColumn) {
+        const int secondsAgo = columnCount() - 1 - index.column();
+        const quint32 count = monitor.count(kind, id, secondsAgo);
+        if (role == Qt::BackgroundRole && count > 0) {
+            // Logarithmic, so that quiet series are still visible next to a flood
+            const double intensity = std::log1p(count) / std::log1p(std::max(mMaximumCount, 1U));
+            return QColor::fromHsvF((1.0 - intensity) / 6.0, 0.3 + 0.7 * intensity, 1.0);
+        } else if (role == Qt::ToolTipRole) {
+            return i18ncp("@info:tooltip", "%1 message %2 seconds ago", "%1 messages %2 seconds ago", count, secondsAgo);
+        }
+        return {};
+    }
+
+    const bool bursting = monitor.isBursting(kind, id);
+    switch (role) {
+    case Qt::DisplayRole:
+        switch (index.column()) {
+        case KindColumn:
+            return isApp ? i18n("Program") : i18n("Category");
+        case NameColumn:
+            return isApp ? store.apps().at(id) : store.categories().at(id);
+        case RateColumn:
+            return monitor.count(kind, id, 1);
+        case BaselineColumn:
+            return QString::number(monitor.baseline(kind, id), 'f', 1);
+        }
+        break;
+    case Qt::BackgroundRole:
+        if (bursting) {
+            return KColorScheme(QPalette::Normal).background(KColorScheme::NegativeBackground).color();
+        }
+        break;
+    case Qt::ToolTipRole:
+        if (bursting) {
+            return i18n("Logging far more than its baseline of %1 messages per second", QString::number(monitor.baseline(kind, id), 'f', 1));
+        }
+        break;
+    }
+    return {};
+}
+
+#include "moc_logratemodel.cpp"
@@ -0,0 +1,49 @@
+/*
+    SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QAbstractTableModel>
+#include <QTimer>
+
+class LoggingModel;
+
+/**
+ * Heatmap of the message rates of every program and category, one column per second.
+ */
+class LogRateModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    enum Columns {
+        KindColumn,
+        NameColumn,
+        RateColumn,
+        BaselineColumn,
+        // The last column is the current second
+        FirstSecondColumn
+    };
+
+    explicit LogRateModel(LoggingModel *loggingModel, QObject *parent = nullptr);
+    ~LogRateModel() override;
+
+    /** The heatmap is only updated, once a second, while active. */
+    void setActive(bool active);
+
+    [[nodiscard]] int rowCount(const QModelIndex &parent = {}) const override;
+    [[nodiscard]] int columnCount(const QModelIndex &parent = {}) const override;
+    [[nodiscard]] QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
+    [[nodiscard]] QVariant data(const QModelIndex &index, int role) const override;
+
+private:
+    void refresh();
+
+    LoggingModel *const mLoggingModel;
+    QTimer mRefreshTimer;
+    int mAppCount = 0;
+    int mCategoryCount = 0;
+    quint32 mMaximumCount = 0;
+};
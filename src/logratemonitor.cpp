@@ -0,0 +1,130 @@
+/*
+    SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "logratemonitor.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+// Weight of the last second in the baseline, about the last 20 seconds count
+constexpr double BaselineWeight = 0.05;
+}
+
+int LogRateMonitor::slot(qint64 second)
+{
+    return int((second % WindowSeconds + WindowSeconds) % WindowSeconds);
+}
+
+void LogRateMonitor::addMessage(qint64 timestamp, int appId, int categoryId)
+{
+    // Negative seconds would look like no message arrived yet
+    if (timestamp < 0) {
+        return;
+    }
+    const qint64 second = timestamp / 1000;
+    if (second > mCurrentSecond) {
+        advanceTo(timestamp);
+    } else if (second <= mCurrentSecond - WindowSeconds) {
+        return;
+    }
+    addToSeries(App, appId, second);
+    addToSeries(Category, categoryId, second);
+}
+
+void LogRateMonitor::addToSeries(Kind kind, int id, qint64 second)
+{
+    auto &series = mSeries[kind];
+    if (id >= int(series.size())) {
+        series.resize(id + 1);
+    }
+
+    auto &s = series[id];
+    const quint32 count = ++s.counts[slot(second)];
+    if (second == mCurrentSecond && s.age >= WarmUpSeconds && count > MinimumBurstRate && count > BurstFactor * s.baseline) {
+        s.burstUntil = mCurrentSecond + BurstHoldSeconds;
+    }
+}
+
+void LogRateMonitor::advanceTo(qint64 timestamp)
+{
+    if (timestamp < 0) {
+        return;
+    }
+    const qint64 second = timestamp / 1000;
+    if (mCurrentSecond < 0) {
+        mCurrentSecond = second;
+        return;
+    }
+    if (second <= mCurrentSecond) {
+        return;
+    }
+
+    for (auto &series : mSeries) {
+        for (auto &s : series) {
+            closeSeconds(s, second);
+        }
+    }
+    mCurrentSecond = second;
+}
+
+void LogRateMonitor::closeSeconds(Series &series, qint64 second) const
+{
+    // Only the current second has messages, the ones after it were idle
+    const qint64 idle = second - mCurrentSecond - 1;
+    series.baseline += BaselineWeight * (series.counts[slot(mCurrentSecond)] - series.baseline);
+    if (idle > 0) {
+        series.baseline *= std::pow(1.0 - BaselineWeight, double(idle));
+    }
+    series.age = int(std::min<qint64>(series.age + idle + 1, WarmUpSeconds));
+
+    for (qint64 s = mCurrentSecond + 1; s <= second && s <= mCurrentSecond + WindowSeconds; ++s) {
+        series.counts[slot(s)] = 0;
+    }
+}
+
+void LogRateMonitor::clear()
+{
+    for (auto &series : mSeries) {
+        series.clear();
+    }
+    mCurrentSecond = -1;
+}
+
+int LogRateMonitor::seriesCount(Kind kind) const
+{
+    return int(mSeries[kind].size());
+}
+
+quint32 LogRateMonitor::count(Kind kind, int id, int secondsAgo) const
+{
+    if (secondsAgo < 0 || secondsAgo >= WindowSeconds || mCurrentSecond < 0) {
+        return 0;
+    }
+    return mSeries[kind][id].counts[slot(mCurrentSecond - secondsAgo)];
+}
+
+double LogRateMonitor::baseline(Kind kind, int id) const
+{
+    return mSeries[kind][id].baseline;
+}
+
+bool LogRateMonitor::isBursting(Kind kind, int id) const
+{
+    return mSeries[kind][id].burstUntil >= mCurrentSecond;
+}
+
+quint32 LogRateMonitor::maximumCount() const
+{
+    quint32 maximum = 0;
+    for (const auto &series : mSeries) {
+        for (const auto &s : series) {
+            maximum = std::max(maximum, *std::max_element(s.counts.cbegin(), s.counts.cend()));
+        }
+    }
+    return maximum;
+}
@@ -0,0 +1,70 @@
+/*
+    SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "libakonadiconsole_export.h"
+
+#include <QtGlobal>
+
+#include <array>
+#include <vector>
+
+/**
+ * Per-second message counts of every program and category over the last minute.
+ *
+ * Each series keeps a ring of per-second counters and an exponential moving
+ * average of its rate. A series bursts when its count within the current
+ * second is well above that baseline. Counting a message is O(1), closing a
+ * second touches every series once.
+ */
+class LIBAKONADICONSOLE_EXPORT LogRateMonitor
+{
+public:
+    enum Kind {
+        App,
+        Category
+    };
+
+    static constexpr int WindowSeconds = 60;
+    // A series bursts when it exceeds both
+    static constexpr quint32 MinimumBurstRate = 50;
+    static constexpr double BurstFactor = 5.0;
+    // Seconds a series needs to establish its baseline, and for how long a burst is reported
+    static constexpr int WarmUpSeconds = 10;
+    static constexpr int BurstHoldSeconds = 10;
+
+    /** @p appId and @p categoryId are the ids interned by the LogMessageStore. Messages before the epoch are ignored. */
+    void addMessage(qint64 timestamp, int appId, int categoryId);
+    /** Closes the seconds before @p timestamp, so that the rates decay when nothing is logged. */
+    void advanceTo(qint64 timestamp);
+    void clear();
+
+    [[nodiscard]] int seriesCount(Kind kind) const;
+    /** Messages of a series within the second @p secondsAgo before the current one. */
+    [[nodiscard]] quint32 count(Kind kind, int id, int secondsAgo) const;
+    /** Average messages per second of a series. */
+    [[nodiscard]] double baseline(Kind kind, int id) const;
+    [[nodiscard]] bool isBursting(Kind kind, int id) const;
+    /** The highest count of any series within the window. */
+    [[nodiscard]] quint32 maximumCount() const;
+
+private:
+    struct Series {
+        std::array<quint32, WindowSeconds> counts = {};
+        double baseline = 0.0;
+        int age = 0;
+        qint64 burstUntil = -1;
+    };
+
+    // Slot of @p second in the rings, also for the seconds before the first one
+    [[nodiscard]] static int slot(qint64 second);
+    void addToSeries(Kind kind, int id, qint64 second);
+    void closeSeconds(Series &series, qint64 second) const;
+
+    std::array<std::vector<Series>, 2> mSeries;
+    qint64 mCurrentSecond = -1;
+};
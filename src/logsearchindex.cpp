@@ -0,0 +1,237 @@
+/*
+    SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "logsearchindex.h"
+using namespace Qt::Literals::StringLiterals;
+
+#include "logmessagestore.h"
+
+#include <QMap>
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+// Single characters would only bloat the index, long words are mostly hashes and encoded data
+constexpr int MinTokenLength = 2;
+constexpr int MaxTokenLength = 32;
+
+bool isPrefixOfAny(const QString &token, const QStringList &words)
+{
+    return std::any_of(words.cbegin(), words.cend(), [&token](const QString &word) {
+        return word.startsWith(token);
+    });
+}
+}
+
+class LogSearchWorker : public QObject
+{
+    Q_OBJECT
+public:
+    void index(const QList<qint64> &serials, const QStringList &texts)
+    {
+        QList<qint64> matches;
+        for (int i = 0; i < serials.count(); ++i) {
+            const qint64 serial = serials.at(i);
+            auto &words = mBlocks[serial / LogMessageStore::BlockSize];
+            const auto position = quint16(serial % LogMessageStore::BlockSize);
+            QStringList tokens = LogSearchIndex::tokenize(texts.at(i));
+            std::sort(tokens.begin(), tokens.end());
+            tokens.erase(std::unique(tokens.begin(), tokens.end()), tokens.end());
+            for (const auto &token : std::as_const(tokens)) {
+                words[token].append(position);
+            }
+
+            if (!mTokens.isEmpty() && std::all_of(mTokens.cbegin(), mTokens.cend(), [&tokens](const QString &token) {
+                    return isPrefixOfAny(token, tokens);
+                })) {
+                matches << serial;
+            }
+            mIndexedUpTo = std::max(mIndexedUpTo, serial);
+        }
+
+        if (!matches.isEmpty()) {
+            std::sort(matches.begin(), matches.end());
+            Q_EMIT matchesAdded(mGeneration, matches, mIndexedUpTo);
+        }
+    }
+
+    void drop(qint64 serial)
+    {
+        const qint64 block = serial / LogMessageStore::BlockSize;
+        mBlocks.erase(mBlocks.begin(), mBlocks.lower_bound(block));
+    }
+
+    void clear()
+    {
+        mBlocks.clear();
+    }
+
+    void search(quint64 generation, const QStringList &tokens)
+    {
+        mGeneration = generation;
+        mTokens = tokens;
+
+        QList<qint64> result;
+        if (!tokens.isEmpty()) {
+            for (const auto &[block, words] : mBlocks) {
+                QList<quint16> positions;
+                for (int i = 0; i < tokens.count(); ++i) {
+                    const QList<quint16> tokenPositions = lookup(words, tokens.at(i));
+                    if (i == 0) {
+                        positions = tokenPositions;
+                    } else {
+                        QList<quint16> intersection;
+                        std::set_intersection(positions.cbegin(),
+                                              positions.cend(),
+                                              tokenPositions.cbegin(),
+                                              tokenPositions.cend(),
+                                              std::back_inserter(intersection));
+                        positions = intersection;
+                    }
+                    if (positions.isEmpty()) {
+                        break;
+                    }
+                }
+                for (const auto position : std::as_const(positions)) {
+                    result << block * LogMessageStore::BlockSize + position;
+                }
+            }
+        }
+        Q_EMIT searchFinished(generation, result, mIndexedUpTo);
+    }
+
+Q_SIGNALS:
+    void searchFinished(quint64 generation, const QList<qint64> &serials, qint64 indexedUpTo);
+    void matchesAdded(quint64 generation, const QList<qint64> &serials, qint64 indexedUpTo);
+
+private:
+    using Words = QMap<QString, QList<quint16>>;
+
+    // Sorted positions of the messages with a word starting with token
+    static QList<quint16> lookup(const Words &words, const QString &token)
+    {
+        QList<quint16> positions;
+        int keys = 0;
+        for (auto it = words.lowerBound(token); it != words.cend() && it.key().startsWith(token); ++it, ++keys) {
+            positions += it.value();
+        }
+        if (keys > 1) {
+            std::sort(positions.begin(), positions.end());
+            positions.erase(std::unique(positions.begin(), positions.end()), positions.end());
+        }
+        return positions;
+    }
+
+    // Index of each block of the store, by block number
+    std::map<qint64, Words> mBlocks;
+    quint64 mGeneration = 0;
+    QStringList mTokens;
+    qint64 mIndexedUpTo = -1;
+};
+
+LogSearchIndex::LogSearchIndex(QObject *parent)
+    : QObject(parent)
+    , mWorker(new LogSearchWorker)
+{
+    mWorker->moveToThread(&mThread);
+    connect(&mThread, &QThread::finished, mWorker, &QObject::deleteLater);
+    connect(this, &LogSearchIndex::indexMessages, mWorker, &LogSearchWorker::index);
+    connect(this, &LogSearchIndex::dropMessages, mWorker, &LogSearchWorker::drop);
+    connect(this, &LogSearchIndex::clearIndex, mWorker, &LogSearchWorker::clear);
+    connect(this, &LogSearchIndex::searchIndex, mWorker, &LogSearchWorker::search);
+    connect(mWorker, &LogSearchWorker::searchFinished, this, &LogSearchIndex::searchFinished);
+    connect(mWorker, &LogSearchWorker::matchesAdded, this, &LogSearchIndex::matchesAdded);
+    mThread.setObjectName(u"LogSearchIndex"_s);
+    mThread.start(QThread::LowPriority);
+
+    mFlushTimer.setInterval(100ms);
+    mFlushTimer.setSingleShot(true);
+    connect(&mFlushTimer, &QTimer::timeout, this, &LogSearchIndex::flush);
+}
+
+LogSearchIndex::~LogSearchIndex()
+{
+    mThread.quit();
+    mThread.wait();
+}
+
+void LogSearchIndex::addMessage(qint64 serial, const QString &text)
+{
+    mPendingSerials << serial;
+    mPendingTexts << text;
+    if (!mFlushTimer.isActive()) {
+        mFlushTimer.start();
+    }
+}
+
+void LogSearchIndex::dropBefore(qint64 serial)
+{
+    flush();
+    Q_EMIT dropMessages(serial);
+}
+
+void LogSearchIndex::clear()
+{
+    mPendingSerials.clear();
+    mPendingTexts.clear();
+    mFlushTimer.stop();
+    Q_EMIT clearIndex();
+}
+
+quint64 LogSearchIndex::search(const QString &text)
+{
+    // Search whatever has arrived so far
+    flush();
+    Q_EMIT searchIndex(++mGeneration, tokenize(text));
+    return mGeneration;
+}
+
+void LogSearchIndex::flush()
+{
+    mFlushTimer.stop();
+    if (mPendingSerials.isEmpty()) {
+        return;
+    }
+    Q_EMIT indexMessages(mPendingSerials, mPendingTexts);
+    mPendingSerials.clear();
+    mPendingTexts.clear();
+}
+
+QStringList LogSearchIndex::tokenize(QStringView text)
+{
+    QStringList tokens;
+    qsizetype start = -1;
+    for (qsizetype i = 0; i <= text.size(); ++i) {
+        if (i < text.size() && text[i].isLetterOrNumber()) {
+            if (start < 0) {
+                start = i;
+            }
+        } else if (start >= 0) {
+            if (i - start >= MinTokenLength) {
+                tokens << text.mid(start, std::min<qsizetype>(i - start, MaxTokenLength)).toString().toLower();
+            }
+            start = -1;
+        }
+    }
+    return tokens;
+}
+
+bool LogSearchIndex::matches(QStringView text, const QStringList &tokens)
+{
+    const QStringList words = tokenize(text);
+    return std::all_of(tokens.cbegin(), tokens.cend(), [&words](const QString &token) {
+        return isPrefixOfAny(token, words);
+    });
+}
+
+#include "logsearchindex.moc"
+
+#include "moc_logsearchindex.cpp"
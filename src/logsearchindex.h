@@ -0,0 +1,74 @@
+/*
+    SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "libakonadiconsole_export.h"
+
+#include <QList>
+#include <QObject>
+#include <QStringList>
+#include <QThread>
+#include <QTimer>
+
+class LogSearchWorker;
+
+/**
+ * Inverted index of the words in the log messages, for the search in the Logging tab.
+ *
+ * Messages are identified by their LogMessageStore serial. They are queued as
+ * they arrive and indexed on a worker thread, in one index per block of the
+ * store, so that dropping a block of messages drops its part of the index too.
+ * Each word of a search is matched as the prefix of a word in the message.
+ */
+class LIBAKONADICONSOLE_EXPORT LogSearchIndex : public QObject
+{
+    Q_OBJECT
+public:
+    explicit LogSearchIndex(QObject *parent = nullptr);
+    ~LogSearchIndex() override;
+
+    void addMessage(qint64 serial, const QString &text);
+    /** Forgets the messages before @p serial. */
+    void dropBefore(qint64 serial);
+    void clear();
+
+    /**
+     * Starts searching for @p text, the result is delivered by searchFinished()
+     * and messages indexed later by matchesAdded(). Returns the generation of
+     * the search.
+     */
+    quint64 search(const QString &text);
+
+    /** Lowercase words of @p text, the same way messages are indexed. */
+    [[nodiscard]] static QStringList tokenize(QStringView text);
+    /** Whether every token in @p tokens is a prefix of a word in @p text. */
+    [[nodiscard]] static bool matches(QStringView text, const QStringList &tokens);
+
+Q_SIGNALS:
+    /** @p serials are sorted, every message up to @p indexedUpTo was searched. */
+    void searchFinished(quint64 generation, const QList<qint64> &serials, qint64 indexedUpTo);
+    /** Messages matching the current search that were indexed after it finished. */
+    void matchesAdded(quint64 generation, const QList<qint64> &serials, qint64 indexedUpTo);
+    /** The messages before @p serial were dropped, so were their search results. */
+    void dropMessages(qint64 serial);
+    /** Every message was dropped. */
+    void clearIndex();
+
+    // Internal, delivered to the worker thread
+    void indexMessages(const QList<qint64> &serials, const QStringList &texts);
+    void searchIndex(quint64 generation, const QStringList &tokens);
+
+private:
+    void flush();
+
+    QThread mThread;
+    LogSearchWorker *mWorker = nullptr;
+    QList<qint64> mPendingSerials;
+    QStringList mPendingTexts;
+    QTimer mFlushTimer;
+    quint64 mGeneration = 0;
+};
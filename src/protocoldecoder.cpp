@@ -0,0 +1,146 @@
+/*
+    SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "protocoldecoder.h"
+using namespace Qt::Literals::StringLiterals;
+
+namespace
+{
+qint64 utf8Size(QStringView str)
+{
+    qint64 size = 0;
+    for (const QChar c : str) {
+        const char16_t unit = c.unicode();
+        // A surrogate pair takes four bytes, two for each half
+        size += unit < 0x80 ? 1 : unit < 0x800 || c.isSurrogate() ? 2 : 3;
+    }
+    return size;
+}
+
+// Position after the string starting at the quote at pos
+qsizetype skipString(QStringView str, qsizetype pos)
+{
+    for (++pos; pos < str.size(); ++pos) {
+        if (str[pos] == u'\\') {
+            ++pos;
+        } else if (str[pos] == u'"') {
+            return pos + 1;
+        }
+    }
+    return pos;
+}
+
+qsizetype skipSpaces(QStringView str, qsizetype pos)
+{
+    while (pos < str.size() && str[pos].isSpace()) {
+        ++pos;
+    }
+    return pos;
+}
+
+QString commandName(QStringView name, bool &response)
+{
+    if (name.endsWith("Response"_L1)) {
+        response = true;
+        name.chop(8);
+    } else if (name.endsWith("Command"_L1)) {
+        name.chop(7);
+    }
+    return name.toString();
+}
+}
+
+ProtocolMessage ProtocolDecoder::decode(QStringView message)
+{
+    ProtocolMessage decoded;
+    decoded.size = utf8Size(message);
+    const QStringView trimmed = message.trimmed();
+    if (trimmed.startsWith(u'{')) {
+        decodeJson(trimmed, decoded);
+    } else {
+        decodeText(trimmed, decoded);
+    }
+    return decoded;
+}
+
+void ProtocolDecoder::decodeJson(QStringView message, ProtocolMessage &decoded)
+{
+    int depth = 0;
+    for (qsizetype pos = 0; pos < message.size();) {
+        const QChar c = message[pos];
+        if (c == u'{' || c == u'[') {
+            ++depth;
+            ++pos;
+            continue;
+        }
+        if (c == u'}' || c == u']') {
+            --depth;
+            ++pos;
+            continue;
+        }
+        if (c != u'"') {
+            ++pos;
+            continue;
+        }
+
+        const qsizetype end = skipString(message, pos);
+        if (depth != 1) {
+            pos = end;
+            continue;
+        }
+
+        // A key of the top level object, the values of interest are plain
+        const QStringView key = message.mid(pos + 1, end - pos - 2);
+        pos = skipSpaces(message, end);
+        if (pos >= message.size() || message[pos] != u':') {
+            continue;
+        }
+        pos = skipSpaces(message, pos + 1);
+        if (key == "tag"_L1) {
+            qsizetype valueEnd = pos;
+            while (valueEnd < message.size() && (message[valueEnd].isDigit() || message[valueEnd] == u'-')) {
+                ++valueEnd;
+            }
+            bool ok = false;
+            const qint64 tag = message.mid(pos, valueEnd - pos).toLongLong(&ok);
+            if (ok) {
+                decoded.tag = tag;
+            }
+            pos = valueEnd;
+        } else if (key == "type"_L1 && pos < message.size() && message[pos] == u'"') {
+            const qsizetype valueEnd = skipString(message, pos);
+            bool response = false;
+            decoded.command = commandName(message.mid(pos + 1, valueEnd - pos - 2), response);
+            pos = valueEnd;
+        } else if (key == "response"_L1) {
+            decoded.response = message.mid(pos).startsWith("true"_L1);
+        }
+    }
+}
+
+void ProtocolDecoder::decodeText(QStringView message, ProtocolMessage &decoded)
+{
+    qsizetype pos = 0;
+    while (pos < message.size() && (message[pos].isDigit() || (pos == 0 && message[pos] == u'-'))) {
+        ++pos;
+    }
+    if (pos > 0) {
+        bool ok = false;
+        const qint64 tag = message.left(pos).toLongLong(&ok);
+        if (ok) {
+            decoded.tag = tag;
+        }
+    }
+
+    pos = skipSpaces(message, pos);
+    qsizetype end = pos;
+    while (end < message.size() && message[end].isLetterOrNumber()) {
+        ++end;
+    }
+    if (end > pos) {
+        decoded.command = commandName(message.mid(pos, end - pos), decoded.response);
+    }
+}
@@ -0,0 +1,49 @@
+/*
+    SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "libakonadiconsole_export.h"
+
+#include <QString>
+#include <QStringView>
+
+/**
+ * What the Debugger knows about a protocol message, besides its text.
+ *
+ * There is no session field. The tracer reports every message together with
+ * the identifier of the connection it was exchanged on, and each connection
+ * serves exactly one session. The messages themselves do not name it, except
+ * for the Login command. DebugModel therefore uses the sender identifier as
+ * the session, also when pairing requests with responses.
+ */
+struct ProtocolMessage {
+    // -1 when the message has no tag
+    qint64 tag = -1;
+    // Command type without its Command or Response suffix, empty when unknown
+    QString command;
+    bool response = false;
+    // Size of the message in UTF-8
+    qint64 size = 0;
+};
+
+/**
+ * Decodes the protocol messages the Akonadi server passes to its tracer.
+ *
+ * The D-Bus tracer sends every command as a JSON object with its tag, type and
+ * whether it is a response. The text format of other tracers starts with the
+ * tag, followed by the name of the command. Only the top level of a message is
+ * looked at, and nothing is allocated besides the command name.
+ */
+class LIBAKONADICONSOLE_EXPORT ProtocolDecoder
+{
+public:
+    [[nodiscard]] static ProtocolMessage decode(QStringView message);
+
+private:
+    static void decodeJson(QStringView message, ProtocolMessage &decoded);
+    static void decodeText(QStringView message, ProtocolMessage &decoded);
+};
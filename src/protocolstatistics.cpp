@@ -0,0 +1,53 @@
+/*
+    SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "protocolstatistics.h"
+
+#include <algorithm>
+
+void ProtocolStatistics::addRequest(const QString &command, qint64 size)
+{
+    auto &stats = this->command(command);
+    ++stats.requests;
+    stats.requestBytes += size;
+}
+
+void ProtocolStatistics::addResponse(const QString &command, qint64 size, qint64 latency)
+{
+    auto &stats = this->command(command);
+    ++stats.responses;
+    stats.responseBytes += size;
+    if (latency < 0) {
+        return;
+    }
+
+    if (stats.roundTrips == 0) {
+        stats.minimumLatency = latency;
+        stats.maximumLatency = latency;
+    } else {
+        stats.minimumLatency = std::min(stats.minimumLatency, latency);
+        stats.maximumLatency = std::max(stats.maximumLatency, latency);
+    }
+    ++stats.roundTrips;
+    stats.totalLatency += latency;
+}
+
+void ProtocolStatistics::clear()
+{
+    mCommands.clear();
+    mIds.clear();
+}
+
+ProtocolStatistics::Command &ProtocolStatistics::command(const QString &name)
+{
+    auto it = mIds.constFind(name);
+    if (it != mIds.constEnd()) {
+        return mCommands[*it];
+    }
+    mIds.insert(name, int(mCommands.size()));
+    mCommands.push_back({name});
+    return mCommands.back();
+}
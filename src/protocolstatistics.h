@@ -0,0 +1,62 @@
+/*
+    SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "libakonadiconsole_export.h"
+
+#include <QHash>
+#include <QString>
+
+#include <vector>
+
+/**
+ * Request, response and latency figures of every protocol command.
+ *
+ * The figures are updated as messages arrive, so reading them never walks
+ * the messages.
+ */
+class LIBAKONADICONSOLE_EXPORT ProtocolStatistics
+{
+public:
+    struct Command {
+        QString name;
+        quint64 requests = 0;
+        quint64 responses = 0;
+        quint64 requestBytes = 0;
+        quint64 responseBytes = 0;
+        // Round trips measured between a request and its first response
+        quint64 roundTrips = 0;
+        qint64 totalLatency = 0;
+        qint64 minimumLatency = 0;
+        qint64 maximumLatency = 0;
+
+        [[nodiscard]] double averageLatency() const
+        {
+            return roundTrips > 0 ? double(totalLatency) / roundTrips : 0.0;
+        }
+    };
+
+    void addRequest(const QString &command, qint64 size);
+    /** @p latency is -1 when the response does not complete a round trip. */
+    void addResponse(const QString &command, qint64 size, qint64 latency);
+    void clear();
+
+    [[nodiscard]] int count() const
+    {
+        return int(mCommands.size());
+    }
+    [[nodiscard]] const Command &at(int id) const
+    {
+        return mCommands[id];
+    }
+
+private:
+    Command &command(const QString &name);
+
+    std::vector<Command> mCommands;
+    QHash<QString, int> mIds;
+};
@@ -0,0 +1,129 @@
+/*
+    SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "protocolstatisticsmodel.h"
+
+#include "debugmodel.h"
+#include "protocolstatistics.h"
+
+#include <KLocalizedString>
+
+#include <QLocale>
+
+#include <chrono>
+
+using namespace std::chrono_literals;
+
+ProtocolStatisticsModel::ProtocolStatisticsModel(DebugModel *debugModel, QObject *parent)
+    : QAbstractTableModel(parent)
+    , mDebugModel(debugModel)
+{
+    mRefreshTimer.setInterval(1s);
+    connect(&mRefreshTimer, &QTimer::timeout, this, &ProtocolStatisticsModel::refresh);
+}
+
+ProtocolStatisticsModel::~ProtocolStatisticsModel() = default;
+
+void ProtocolStatisticsModel::setActive(bool active)
+{
+    if (active) {
+        refresh();
+        mRefreshTimer.start();
+    } else {
+        mRefreshTimer.stop();
+    }
+}
+
+void ProtocolStatisticsModel::refresh()
+{
+    const int count = mDebugModel->statistics().count();
+    if (count != mCount) {
+        beginResetModel();
+        mCount = count;
+        endResetModel();
+    } else if (count > 0) {
+        Q_EMIT dataChanged(index(0, 0), index(count - 1, _ColumnCount - 1));
+    }
+}
+
+int ProtocolStatisticsModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : mCount;
+}
+
+int ProtocolStatisticsModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : _ColumnCount;
+}
+
+QVariant ProtocolStatisticsModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return {};
+    }
+
+    switch (section) {
+    case CommandColumn:
+        return i18n("Command");
+    case RequestsColumn:
+        return i18n("Requests");
+    case ResponsesColumn:
+        return i18n("Responses");
+    case RequestBytesColumn:
+        return i18n("Sent");
+    case ResponseBytesColumn:
+        return i18n("Received");
+    case AverageLatencyColumn:
+        return i18n("Average Latency");
+    case MinimumLatencyColumn:
+        return i18n("Minimum Latency");
+    case MaximumLatencyColumn:
+        return i18n("Maximum Latency");
+    }
+    return {};
+}
+
+QVariant ProtocolStatisticsModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= mCount || (role != Qt::DisplayRole && role != SortRole && role != Qt::TextAlignmentRole)) {
+        return {};
+    }
+
+    if (role == Qt::TextAlignmentRole) {
+        return index.column() == CommandColumn ? QVariant() : QVariant::fromValue(Qt::AlignRight | Qt::AlignVCenter);
+    }
+
+    const auto &command = mDebugModel->statistics().at(index.row());
+    const bool display = role == Qt::DisplayRole;
+    const auto latency = [&command, display](auto value) -> QVariant {
+        if (!display) {
+            return value;
+        }
+        return command.roundTrips > 0 ? i18nc("@item latency in milliseconds", "%1 ms", value) : QString();
+    };
+
+    switch (index.column()) {
+    case CommandColumn:
+        return command.name;
+    case RequestsColumn:
+        return command.requests;
+    case ResponsesColumn:
+        return command.responses;
+    case RequestBytesColumn:
+        return display ? QVariant(QLocale().formattedDataSize(command.requestBytes)) : QVariant(command.requestBytes);
+    case ResponseBytesColumn:
+        return display ? QVariant(QLocale().formattedDataSize(command.responseBytes)) : QVariant(command.responseBytes);
+    case AverageLatencyColumn:
+        return display ? latency(QString::number(command.averageLatency(), 'f', 1)) : QVariant(command.averageLatency());
+    case MinimumLatencyColumn:
+        return latency(command.minimumLatency);
+    case MaximumLatencyColumn:
+        return latency(command.maximumLatency);
+    }
+    return {};
+}
+
+#include "moc_protocolstatisticsmodel.cpp"
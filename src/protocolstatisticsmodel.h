@@ -0,0 +1,56 @@
+/*
+    SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QAbstractTableModel>
+#include <QTimer>
+
+class DebugModel;
+
+/**
+ * Table of the per-command figures of the protocol messages in a DebugModel.
+ */
+class ProtocolStatisticsModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    enum Columns {
+        CommandColumn,
+        RequestsColumn,
+        ResponsesColumn,
+        RequestBytesColumn,
+        ResponseBytesColumn,
+        AverageLatencyColumn,
+        MinimumLatencyColumn,
+        MaximumLatencyColumn,
+
+        _ColumnCount
+    };
+
+    enum Roles {
+        // Raw value of a column, for sorting
+        SortRole = Qt::UserRole
+    };
+
+    explicit ProtocolStatisticsModel(DebugModel *debugModel, QObject *parent = nullptr);
+    ~ProtocolStatisticsModel() override;
+
+    /** The figures are only updated, once a second, while active. */
+    void setActive(bool active);
+
+    [[nodiscard]] int rowCount(const QModelIndex &parent = {}) const override;
+    [[nodiscard]] int columnCount(const QModelIndex &parent = {}) const override;
+    [[nodiscard]] QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
+    [[nodiscard]] QVariant data(const QModelIndex &index, int role) const override;
+
+private:
+    void refresh();
+
+    DebugModel *const mDebugModel;
+    QTimer mRefreshTimer;
+    int mCount = 0;
+};
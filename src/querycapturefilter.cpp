@@ -0,0 +1,217 @@
+/*
+ * SPDX-FileCopyrightText: 2026 akonadiconsole authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ */
+
+#include "querycapturefilter.h"
+using namespace Qt::Literals::StringLiterals;
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+QueryCaptureFilter::Mode QueryCaptureFilter::mode() const
+{
+    return mMode;
+}
+
+void QueryCaptureFilter::setMode(Mode mode)
+{
+    mMode = mode;
+    reset();
+}
+
+uint QueryCaptureFilter::threshold() const
+{
+    return mThreshold;
+}
+
+void QueryCaptureFilter::setThreshold(uint msecs)
+{
+    mThreshold = msecs;
+}
+
+int QueryCaptureFilter::topCount() const
+{
+    return mTopCount;
+}
+
+void QueryCaptureFilter::setTopCount(int count)
+{
+    mTopCount = std::max(1, count);
+    reset();
+}
+
+void QueryCaptureFilter::reset()
+{
+    // The calls evicted so far are still reported by takeEvicted()
+    for (const auto &heap : std::as_const(mTopDurations)) {
+        for (const auto &entry : heap) {
+            mEvicted << entry.serial;
+        }
+    }
+    mTopDurations.clear();
+    mLastSerial = 0;
+}
+
+bool QueryCaptureFilter::accept(const QString &query, uint duration, const QString &error)
+{
+    mLastSerial = 0;
+    if (!error.trimmed().isEmpty()) {
+        return true;
+    }
+
+    switch (mMode) {
+    case CaptureAll:
+        return true;
+    case CaptureSlowerThan:
+        return duration >= mThreshold;
+    case CaptureTopSlowest: {
+        const QString key = fingerprint(query);
+        auto it = mTopDurations.find(key);
+        if (it == mTopDurations.end()) {
+            if (mTopDurations.size() >= MaximumFingerprints) {
+                evictFastestFingerprint();
+            }
+            it = mTopDurations.insert(key, {});
+        }
+
+        // The fastest of the kept calls is on top
+        const auto byDuration = [](const Entry &a, const Entry &b) {
+            return a.duration > b.duration;
+        };
+        auto &heap = *it;
+        if (heap.count() < mTopCount) {
+            heap.append({duration, mNextSerial});
+            std::push_heap(heap.begin(), heap.end(), byDuration);
+        } else {
+            if (duration <= heap.constFirst().duration) {
+                return false;
+            }
+            std::pop_heap(heap.begin(), heap.end(), byDuration);
+            mEvicted << heap.last().serial;
+            heap.last() = {duration, mNextSerial};
+            std::push_heap(heap.begin(), heap.end(), byDuration);
+        }
+        mLastSerial = mNextSerial++;
+        return true;
+    }
+    }
+
+    return true;
+}
+
+quint64 QueryCaptureFilter::lastSerial() const
+{
+    return mLastSerial;
+}
+
+QList<quint64> QueryCaptureFilter::takeEvicted()
+{
+    return std::exchange(mEvicted, {});
+}
+
+void QueryCaptureFilter::evictFastestFingerprint()
+{
+    // Only runs for new fingerprints once the table is full, the least interesting one goes
+    auto fastest = mTopDurations.end();
+    uint fastestDuration = std::numeric_limits<uint>::max();
+    for (auto it = mTopDurations.begin(); it != mTopDurations.end(); ++it) {
+        const auto slowest = std::max_element(it->cbegin(), it->cend(), [](const Entry &a, const Entry &b) {
+            return a.duration < b.duration;
+        });
+        const uint duration = slowest == it->cend() ? 0 : slowest->duration;
+        if (duration < fastestDuration) {
+            fastest = it;
+            fastestDuration = duration;
+        }
+    }
+    if (fastest == mTopDurations.end()) {
+        return;
+    }
+    for (const auto &entry : std::as_const(*fastest)) {
+        mEvicted << entry.serial;
+    }
+    mTopDurations.erase(fastest);
+}
+
+QString QueryCaptureFilter::fingerprint(QStringView query)
+{
+    QString result;
+    result.reserve(query.size());
+    const auto isWordChar = [](QChar c) {
+        return c.isLetterOrNumber() || c == u'_';
+    };
+    const auto appendPlaceholder = [&result]() {
+        // A list of placeholders counts as one, whatever its length
+        if (result.endsWith(u"?, "_s)) {
+            result.chop(2);
+        } else if (result.endsWith(u"?,"_s)) {
+            result.chop(1);
+        } else {
+            result += u'?';
+        }
+    };
+
+    const qsizetype size = query.size();
+    qsizetype i = 0;
+    while (i < size) {
+        const QChar c = query[i];
+        if (c.isSpace()) {
+            while (i < size && query[i].isSpace()) {
+                ++i;
+            }
+            if (!result.isEmpty() && !result.endsWith(u' ')) {
+                result += u' ';
+            }
+        } else if (c == u'\'') {
+            // String literal, with '' as an escaped quote
+            ++i;
+            while (i < size) {
+                if (query[i] == u'\'') {
+                    if (i + 1 < size && query[i + 1] == u'\'') {
+                        i += 2;
+                        continue;
+                    }
+                    ++i;
+                    break;
+                }
+                ++i;
+            }
+            appendPlaceholder();
+        } else if (c == u'?') {
+            ++i;
+            appendPlaceholder();
+        } else if (c == u':' && i + 1 < size && query[i + 1] == u':') {
+            // A PostgreSQL cast, not a named placeholder
+            result += u"::"_s;
+            i += 2;
+        } else if (c == u':' && i + 1 < size && isWordChar(query[i + 1])) {
+            ++i;
+            while (i < size && isWordChar(query[i])) {
+                ++i;
+            }
+            appendPlaceholder();
+        } else if (c.isDigit()) {
+            while (i < size && (isWordChar(query[i]) || query[i] == u'.')) {
+                ++i;
+            }
+            appendPlaceholder();
+        } else if (isWordChar(c)) {
+            const qsizetype start = i;
+            while (i < size && isWordChar(query[i])) {
+                ++i;
+            }
+            result += query.mid(start, i - start);
+        } else {
+            result += c;
+            ++i;
+        }
+    }
+    if (result.endsWith(u' ')) {
+        result.chop(1);
+    }
+    return result;
+}
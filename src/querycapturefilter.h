@@ -0,0 +1,81 @@
+/*
+ * SPDX-FileCopyrightText: 2026 akonadiconsole authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ */
+
+#pragma once
+
+#include "libakonadiconsole_export.h"
+
+#include <QHash>
+#include <QList>
+#include <QString>
+
+/**
+ * Decides whether a query reported by the storage debugger is worth keeping.
+ *
+ * The filter runs before any model node is created, so that the debugger can
+ * stay enabled on a busy server and only retain the interesting queries.
+ * Queries that failed are always kept.
+ *
+ * In CaptureTopSlowest mode every accepted call gets a serial. A call that
+ * slower calls of the same fingerprint pushed out of the top list is reported
+ * by takeEvicted(), so that what is kept stays bounded by the number of
+ * fingerprints times topCount().
+ */
+class LIBAKONADICONSOLE_EXPORT QueryCaptureFilter
+{
+public:
+    enum Mode {
+        CaptureAll,
+        CaptureSlowerThan,
+        CaptureTopSlowest
+    };
+
+    // Beyond this, a new fingerprint replaces the one with the fastest slowest call
+    static constexpr int MaximumFingerprints = 1000;
+
+    [[nodiscard]] Mode mode() const;
+    void setMode(Mode mode);
+
+    [[nodiscard]] uint threshold() const;
+    void setThreshold(uint msecs);
+
+    [[nodiscard]] int topCount() const;
+    void setTopCount(int count);
+
+    /**
+     * Forgets the slowest durations seen so far. Nothing bounds the calls kept
+     * until now any more, so they are all reported by takeEvicted().
+     */
+    void reset();
+
+    [[nodiscard]] bool accept(const QString &query, uint duration, const QString &error);
+
+    /** Serial of the call accepted last, 0 when it is not tracked. */
+    [[nodiscard]] quint64 lastSerial() const;
+    /** Serials of the accepted calls pushed out of the top lists, or reset, since the last call. */
+    [[nodiscard]] QList<quint64> takeEvicted();
+
+    /** The query with its literals and placeholders replaced by ?, and placeholder lists collapsed. */
+    [[nodiscard]] static QString fingerprint(QStringView query);
+
+private:
+    struct Entry {
+        uint duration;
+        quint64 serial;
+    };
+
+    void evictFastestFingerprint();
+
+    // Min-heap of the slowest calls seen per fingerprint
+    QHash<QString, QList<Entry>> mTopDurations;
+    QList<quint64> mEvicted;
+    quint64 mNextSerial = 1;
+    quint64 mLastSerial = 0;
+    Mode mMode = CaptureAll;
+    uint mThreshold = 100;
+    int mTopCount = 10;
+};
@@ -9,20 +9,29 @@
 #include "querydebugger.h"
 using namespace Qt::Literals::StringLiterals;
 
+#include "queryplancollector.h"
+#include "queryresultsmodel.h"
+#include "querytreeexportjob.h"
+#include "querytreemodel.h"
+#include "repeatedquerieswidget.h"
 #include "storagedebuggerinterface.h"
+#include "transactionanalysiswidget.h"
 #include "ui_querydebugger.h"
 #include "ui_queryviewdialog.h"
 
+#include <KConfigGroup>
 #include <KLocalizedString>
+#include <KSharedConfig>
 
 #include <QAbstractListModel>
-#include <QDateTime>
 #include <QDialog>
 #include <QDialogButtonBox>
+#include <QFile>
 #include <QFileDialog>
 #include <QHeaderView>
+#include <QMessageBox>
+#include <QSet>
 #include <QSortFilterProxyModel>
-#include <QTableWidget>
 
 #include <QDBusArgument>
 #include <QDBusConnection>
@@ -30,11 +39,10 @@ using namespace Qt::Literals::StringLiterals;
 #include <Akonadi/ControlGui>
 #include <Akonadi/ServerManager>
 
-#include <KColorScheme>
-
 #include <algorithm>
+#include <chrono>
 
-Q_DECLARE_METATYPE(QList<QList<QVariant>>)
+using namespace std::chrono_literals;
 
 QDBusArgument &operator<<(QDBusArgument &arg, const DbConnection &con)
 {
@@ -54,8 +62,12 @@ const QDBusArgument &operator>>(const QDBusArgument &arg, DbConnection &con)
 
 struct QueryInfo {
     QString query;
-    quint64 duration;
-    quint64 calls;
+    quint64 duration = 0;
+    quint64 calls = 0;
+    // Bound values of the slowest call, used to explain the query
+    uint slowestDuration = 0;
+    QMap<QString, QVariant> slowestValues;
+    QString plan;
 
     bool operator<(const QString &other) const
     {
@@ -65,457 +77,6 @@ struct QueryInfo {
 
 Q_DECLARE_TYPEINFO(QueryInfo, Q_RELOCATABLE_TYPE);
 
-class QueryTreeModel : public QAbstractItemModel
-{
-    Q_OBJECT
-
-public:
-    enum RowType {
-        Connection,
-        Transaction,
-        Query
-    };
-
-private:
-    class Node
-    {
-    public:
-        virtual ~Node() = default;
-
-        Node *parent;
-        RowType type;
-        qint64 start;
-        uint duration;
-    };
-
-    class QueryNode : public Node
-    {
-    public:
-        QString query;
-        QString error;
-        QMap<QString, QVariant> values;
-        QList<QList<QVariant>> results;
-        int resultsCount;
-    };
-
-    class TransactionNode : public QueryNode
-    {
-    public:
-        ~TransactionNode() override
-        {
-            qDeleteAll(queries);
-        }
-
-        enum TransactionType {
-            Begin,
-            Commit,
-            Rollback
-        };
-        TransactionType transactionType;
-        QList<QueryNode *> queries;
-    };
-
-    class ConnectionNode : public Node
-    {
-    public:
-        ~ConnectionNode() override
-        {
-            qDeleteAll(queries);
-        }
-
-        QString name;
-        QList<Node *> queries; // FIXME: Why can' I use QList<Query*> here??
-    };
-
-public:
-    enum {
-        RowTypeRole = Qt::UserRole + 1,
-        QueryRole,
-        QueryResultsCountRole,
-        QueryResultsRole,
-        QueryValuesRole
-    };
-
-    QueryTreeModel(QObject *parent)
-        : QAbstractItemModel(parent)
-    {
-    }
-
-    ~QueryTreeModel() override
-    {
-        qDeleteAll(mConnections);
-    }
-
-    void clear()
-    {
-        beginResetModel();
-        qDeleteAll(mConnections);
-        mConnections.clear();
-        endResetModel();
-    }
-
-    void addConnection(qint64 id, const QString &name, qint64 timestamp)
-    {
-        auto con = new ConnectionNode;
-        con->parent = nullptr;
-        con->type = Connection;
-        con->name = name;
-        con->start = timestamp;
-        beginInsertRows(QModelIndex(), mConnections.count(), mConnections.count());
-        mConnections << con;
-        mConnectionById.insert(id, con);
-        endInsertRows();
-    }
-
-    void updateConnection(qint64 id, const QString &name)
-    {
-        auto con = mConnectionById.value(id);
-        if (!con) {
-            return;
-        }
-
-        con->name = name;
-        const QModelIndex index = createIndex(mConnections.indexOf(con), columnCount() - 1, con);
-        Q_EMIT dataChanged(index, index.sibling(index.row(), 5));
-    }
-
-    void addTransaction(qint64 connectionId, const QString &name, qint64 timestamp, uint duration, const QString &error)
-    {
-        auto con = mConnectionById.value(connectionId);
-        if (!con) {
-            return;
-        }
-
-        auto trx = new TransactionNode;
-        trx->query = name;
-        trx->parent = con;
-        trx->type = Transaction;
-        trx->start = timestamp;
-        trx->duration = duration;
-        trx->transactionType = TransactionNode::Begin;
-        trx->error = error.trimmed();
-        const QModelIndex conIdx = createIndex(mConnections.indexOf(con), 0, con);
-        beginInsertRows(conIdx, con->queries.count(), con->queries.count());
-        con->queries << trx;
-        endInsertRows();
-    }
-
-    void closeTransaction(qint64 connectionId, bool commit, qint64 timestamp, uint, const QString &error)
-    {
-        auto con = mConnectionById.value(connectionId);
-        if (!con) {
-            return;
-        }
-
-        // Find the last open transaction and change it to closed
-        for (int i = con->queries.count() - 1; i >= 0; i--) {
-            Node *node = con->queries[i];
-            if (node->type == Transaction) {
-                auto trx = static_cast<TransactionNode *>(node);
-                if (trx->transactionType != TransactionNode::Begin) {
-                    continue;
-                }
-
-                trx->transactionType = commit ? TransactionNode::Commit : TransactionNode::Rollback;
-                trx->duration = timestamp - trx->start;
-                trx->error = error.trimmed();
-
-                const QModelIndex trxIdx = createIndex(i, 0, trx);
-                Q_EMIT dataChanged(trxIdx, trxIdx.sibling(trxIdx.row(), columnCount() - 1));
-                return;
-            }
-        }
-    }
-
-    void addQuery(qint64 connectionId,
-                  qint64 timestamp,
-                  uint duration,
-                  const QString &queryStr,
-                  const QMap<QString, QVariant> &values,
-                  int resultsCount,
-                  const QList<QList<QVariant>> &results,
-                  const QString &error)
-    {
-        auto con = mConnectionById.value(connectionId);
-        if (!con) {
-            return;
-        }
-
-        auto query = new QueryNode;
-        query->type = Query;
-        query->start = timestamp;
-        query->duration = duration;
-        query->query = queryStr;
-        query->values = values;
-        query->resultsCount = resultsCount;
-        query->results = results;
-        query->error = error.trimmed();
-
-        if (!con->queries.isEmpty() && con->queries.last()->type == Transaction
-            && static_cast<TransactionNode *>(con->queries.last())->transactionType == TransactionNode::Begin) {
-            auto trx = static_cast<TransactionNode *>(con->queries.last());
-            query->parent = trx;
-            beginInsertRows(createIndex(con->queries.indexOf(trx), 0, trx), trx->queries.count(), trx->queries.count());
-            trx->queries << query;
-            endInsertRows();
-        } else {
-            query->parent = con;
-            beginInsertRows(createIndex(mConnections.indexOf(con), 0, con), con->queries.count(), con->queries.count());
-            con->queries << query;
-            endInsertRows();
-        }
-    }
-
-    [[nodiscard]] int rowCount(const QModelIndex &parent) const override
-    {
-        if (!parent.isValid()) {
-            return mConnections.count();
-        }
-
-        Node *node = reinterpret_cast<Node *>(parent.internalPointer());
-        switch (node->type) {
-        case Connection:
-            return static_cast<ConnectionNode *>(node)->queries.count();
-        case Transaction:
-            return static_cast<TransactionNode *>(node)->queries.count();
-        case Query:
-            return 0;
-        }
-
-        Q_UNREACHABLE();
-    }
-
-    [[nodiscard]] int columnCount(const QModelIndex &parent = QModelIndex()) const override
-    {
-        Q_UNUSED(parent)
-        return 5;
-    }
-
-    [[nodiscard]] QModelIndex parent(const QModelIndex &child) const override
-    {
-        if (!child.isValid() || !child.internalPointer()) {
-            return {};
-        }
-
-        Node *childNode = reinterpret_cast<Node *>(child.internalPointer());
-        // childNode is a Connection
-        if (!childNode->parent) {
-            return {};
-        }
-
-        // childNode is a query in transaction
-        if (childNode->parent->parent) {
-            auto connection = static_cast<ConnectionNode *>(childNode->parent->parent);
-            const int trxIdx = connection->queries.indexOf(childNode->parent);
-            return createIndex(trxIdx, 0, childNode->parent);
-        } else {
-            // childNode is a query without transaction or a transaction
-            return createIndex(mConnections.indexOf(static_cast<ConnectionNode *>(childNode->parent)), 0, childNode->parent);
-        }
-    }
-
-    [[nodiscard]] QModelIndex index(int row, int column, const QModelIndex &parent) const override
-    {
-        if (!parent.isValid()) {
-            if (row < mConnections.count()) {
-                return createIndex(row, column, mConnections.at(row));
-            } else {
-                return {};
-            }
-        }
-
-        Node *parentNode = reinterpret_cast<Node *>(parent.internalPointer());
-        switch (parentNode->type) {
-        case Connection:
-            if (row < static_cast<ConnectionNode *>(parentNode)->queries.count()) {
-                return createIndex(row, column, static_cast<ConnectionNode *>(parentNode)->queries.at(row));
-            } else {
-                return {};
-            }
-        case Transaction:
-            if (row < static_cast<TransactionNode *>(parentNode)->queries.count()) {
-                return createIndex(row, column, static_cast<TransactionNode *>(parentNode)->queries.at(row));
-            } else {
-                return {};
-            }
-        case Query:
-            // Query can never have children
-            return {};
-        }
-
-        Q_UNREACHABLE();
-    }
-
-    [[nodiscard]] QVariant headerData(int section, Qt::Orientation orientation, int role) const override
-    {
-        if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
-            return {};
-        }
-
-        switch (section) {
-        case 0:
-            return i18n("Name / Query");
-        case 1:
-            return i18n("Started");
-        case 2:
-            return i18n("Ended");
-        case 3:
-            return i18n("Duration");
-        case 4:
-            return i18n("Error");
-        }
-
-        return {};
-    }
-
-    [[nodiscard]] QVariant data(const QModelIndex &index, int role) const override
-    {
-        if (!index.isValid()) {
-            return {};
-        }
-
-        Node *node = reinterpret_cast<Node *>(index.internalPointer());
-        if (role == RowTypeRole) {
-            return node->type;
-        } else {
-            switch (node->type) {
-            case Connection:
-                return connectionData(static_cast<ConnectionNode *>(node), index.column(), role);
-            case Transaction:
-                return transactionData(static_cast<TransactionNode *>(node), index.column(), role);
-            case Query:
-                return queryData(static_cast<QueryNode *>(node), index.column(), role);
-            }
-        }
-
-        Q_UNREACHABLE();
-    }
-
-    void dumpRow(QFile &file, const QModelIndex &idx, int depth)
-    {
-        if (idx.isValid()) {
-            QTextStream stream(&file);
-            stream << u"  |"_s.repeated(depth) << QLatin1StringView("- ");
-
-            Node *node = reinterpret_cast<Node *>(idx.internalPointer());
-            switch (node->type) {
-            case Connection: {
-                auto con = static_cast<ConnectionNode *>(node);
-                stream << con->name << "    " << fromMSecsSinceEpoch(con->start);
-                break;
-            }
-            case Transaction: {
-                auto trx = static_cast<TransactionNode *>(node);
-                stream << idx.data(Qt::DisplayRole).toString() << "    " << fromMSecsSinceEpoch(trx->start);
-                if (trx->transactionType > TransactionNode::Begin) {
-                    stream << " - " << fromMSecsSinceEpoch(trx->start + trx->duration);
-                }
-                break;
-            }
-            case Query: {
-                auto query = static_cast<QueryNode *>(node);
-                stream << query->query << "    " << fromMSecsSinceEpoch(query->start) << ", took " << query->duration << " ms";
-                break;
-            }
-            }
-
-            if (node->type >= Transaction) {
-                auto query = static_cast<QueryNode *>(node);
-                if (!query->error.isEmpty()) {
-                    stream << '\n' << u"  |"_s.repeated(depth) << u"  Error: "_s << query->error;
-                }
-            }
-
-            stream << '\n';
-        }
-
-        for (int i = 0, c = rowCount(idx); i < c; ++i) {
-            dumpRow(file, index(i, 0, idx), depth + 1);
-        }
-    }
-
-private:
-    [[nodiscard]] QString fromMSecsSinceEpoch(qint64 msecs) const
-    {
-        return QDateTime::fromMSecsSinceEpoch(msecs).toString(u"dd.MM.yyyy HH:mm:ss.zzz"_s);
-    }
-
-    QVariant connectionData(ConnectionNode *connection, int column, int role) const
-    {
-        if (role != Qt::DisplayRole) {
-            return {};
-        }
-
-        switch (column) {
-        case 0:
-            return connection->name;
-        case 1:
-            return fromMSecsSinceEpoch(connection->start);
-        }
-
-        return {};
-    }
-
-    QVariant transactionData(TransactionNode *transaction, int column, int role) const
-    {
-        if (role == Qt::DisplayRole && column == 0) {
-            QString mode;
-            switch (transaction->transactionType) {
-            case TransactionNode::Begin:
-                mode = u"BEGIN"_s;
-                break;
-            case TransactionNode::Commit:
-                mode = u"COMMIT"_s;
-                break;
-            case TransactionNode::Rollback:
-                mode = u"ROLLBACK"_s;
-                break;
-            }
-            return u"%1 %2"_s.arg(mode, transaction->query);
-        } else {
-            return queryData(transaction, column, role);
-        }
-    }
-
-    QVariant queryData(QueryNode *query, int column, int role) const
-    {
-        switch (role) {
-        case Qt::BackgroundRole:
-            if (!query->error.isEmpty()) {
-                return KColorScheme(QPalette::Normal).background(KColorScheme::NegativeBackground).color();
-            }
-            break;
-        case Qt::DisplayRole:
-            switch (column) {
-            case 0:
-                return query->query;
-            case 1:
-                return fromMSecsSinceEpoch(query->start);
-            case 2:
-                return fromMSecsSinceEpoch(query->start + query->duration);
-            case 3:
-                return QTime(0, 0, 0).addMSecs(query->duration).toString(u"HH:mm:ss.zzz"_s);
-            case 4:
-                return query->error;
-            }
-            break;
-        case QueryRole:
-            return query->query;
-        case QueryResultsCountRole:
-            return query->resultsCount;
-        case QueryResultsRole:
-            return QVariant::fromValue(query->results);
-        case QueryValuesRole:
-            return query->values;
-        }
-
-        return {};
-    }
-
-    QList<ConnectionNode *> mConnections;
-    QHash<qint64, ConnectionNode *> mConnectionById;
-};
-
 class QueryDebuggerModel : public QAbstractListModel
 {
     Q_OBJECT
@@ -537,6 +98,7 @@ public:
         CallsColumn,
         AvgDurationColumn,
         QueryColumn,
+        PlanColumn,
         NUM_COLUMNS
     };
 
@@ -554,6 +116,8 @@ public:
             return i18n("Calls");
         } else if (section == AvgDurationColumn) {
             return i18n("Avg. Duration [ms]");
+        } else if (section == PlanColumn) {
+            return i18n("Query Plan");
         }
 
         return {};
@@ -577,6 +141,9 @@ public:
         const QueryInfo &info = (row < NUM_SPECIAL_ROWS) ? mSpecialRows[row] : mQueries.at(row - NUM_SPECIAL_ROWS);
 
         if (role == Qt::ToolTipRole) {
+            if (column == PlanColumn && !info.plan.isEmpty()) {
+                return QString(QLatin1StringView("<qt><pre>") + info.plan.toHtmlEscaped() + QLatin1StringView("</pre></qt>"));
+            }
             return QString(QLatin1StringView("<qt>") + info.query + QLatin1StringView("</qt>"));
         }
 
@@ -588,6 +155,9 @@ public:
             return info.calls;
         } else if (column == AvgDurationColumn) {
             return float(info.duration) / info.calls;
+        } else if (column == PlanColumn) {
+            // The first line of a plan holds its column names, errors are a single line
+            return info.plan.contains(u'\n') ? info.plan.section(u'\n', 1, 1) : info.plan;
         }
 
         return {};
@@ -611,32 +181,90 @@ public:
         }
     }
 
-    void addQuery(const QString &query, uint duration)
+    void addQueries(const QList<QueryRecord> &queries)
     {
-        QList<QueryInfo>::iterator it = std::lower_bound(mQueries.begin(), mQueries.end(), query);
-
-        const int row = std::distance(mQueries.begin(), it) + NUM_SPECIAL_ROWS;
+        if (queries.isEmpty()) {
+            return;
+        }
 
-        if (it != mQueries.end() && it->query == query) {
-            ++(it->calls);
-            it->duration += duration;
+        // Aggregate the batch first so that every distinct query touches the
+        // sorted list only once
+        QHash<QString, QueryInfo> batch;
+        for (const auto &record : queries) {
+            auto &info = batch[record.query];
+            info.duration += record.duration;
+            ++info.calls;
+            if (info.calls == 1 || record.duration > info.slowestDuration) {
+                info.slowestDuration = record.duration;
+                info.slowestValues = record.values;
+            }
+            mSpecialRows[TOTAL].duration += record.duration;
+            ++mSpecialRows[TOTAL].calls;
+        }
+
+        int firstChanged = -1;
+        int lastChanged = -1;
+        QList<QueryInfo> added;
+        for (auto batchIt = batch.cbegin(), end = batch.cend(); batchIt != end; ++batchIt) {
+            QList<QueryInfo>::iterator it = std::lower_bound(mQueries.begin(), mQueries.end(), batchIt.key());
+            if (it != mQueries.end() && it->query == batchIt.key()) {
+                it->calls += batchIt->calls;
+                it->duration += batchIt->duration;
+                if (batchIt->slowestDuration > it->slowestDuration) {
+                    it->slowestDuration = batchIt->slowestDuration;
+                    it->slowestValues = batchIt->slowestValues;
+                }
+                const int row = std::distance(mQueries.begin(), it) + NUM_SPECIAL_ROWS;
+                firstChanged = firstChanged == -1 ? row : std::min(firstChanged, row);
+                lastChanged = std::max(lastChanged, row);
+            } else {
+                QueryInfo info = batchIt.value();
+                info.query = batchIt.key();
+                added << info;
+            }
+        }
+        if (firstChanged != -1) {
+            Q_EMIT dataChanged(index(firstChanged, DurationColumn), index(lastChanged, AvgDurationColumn));
+        }
 
-            Q_EMIT dataChanged(index(row, DurationColumn), index(row, AvgDurationColumn));
-        } else {
+        for (const auto &info : std::as_const(added)) {
+            QList<QueryInfo>::iterator it = std::lower_bound(mQueries.begin(), mQueries.end(), info.query);
+            const int row = std::distance(mQueries.begin(), it) + NUM_SPECIAL_ROWS;
             beginInsertRows(QModelIndex(), row, row);
-            QueryInfo info;
-            info.query = query;
-            info.duration = duration;
-            info.calls = 1;
             mQueries.insert(it, info);
             endInsertRows();
         }
 
-        mSpecialRows[TOTAL].duration += duration;
-        ++mSpecialRows[TOTAL].calls;
         Q_EMIT dataChanged(index(TOTAL, DurationColumn), index(TOTAL, AvgDurationColumn));
     }
 
+    /** Queries with the highest average duration first. */
+    [[nodiscard]] QList<QueryInfo> slowestQueries(int count) const
+    {
+        QList<QueryInfo> queries = mQueries;
+        const auto avgGreater = [](const QueryInfo &a, const QueryInfo &b) {
+            return double(a.duration) / a.calls > double(b.duration) / b.calls;
+        };
+        if (queries.count() > count) {
+            std::partial_sort(queries.begin(), queries.begin() + count, queries.end(), avgGreater);
+            queries.resize(count);
+        } else {
+            std::sort(queries.begin(), queries.end(), avgGreater);
+        }
+        return queries;
+    }
+
+    void setPlan(const QString &query, const QString &plan)
+    {
+        QList<QueryInfo>::iterator it = std::lower_bound(mQueries.begin(), mQueries.end(), query);
+        if (it == mQueries.end() || it->query != query) {
+            return;
+        }
+        it->plan = plan;
+        const int row = std::distance(mQueries.begin(), it) + NUM_SPECIAL_ROWS;
+        Q_EMIT dataChanged(index(row, PlanColumn), index(row, PlanColumn));
+    }
+
     void clear()
     {
         beginResetModel();
@@ -679,20 +307,23 @@ public:
         }
         mUi->resultsLbl->setText(QString::number(resultsCount));
 
-        if (!results.isEmpty()) {
-            mUi->tableWidget->setRowCount(resultsCount);
-            const auto &headers = results[0];
-            mUi->tableWidget->setColumnCount(headers.count());
-            for (int c = 0; c < headers.count(); ++c) {
-                mUi->tableWidget->setHorizontalHeaderItem(c, new QTableWidgetItem(headers[c].toString()));
-            }
-            for (int r = 1; r <= resultsCount; ++r) {
-                const auto &row = results[r];
-                for (int c = 0; c < row.size(); ++c) {
-                    mUi->tableWidget->setItem(r - 1, c, new QTableWidgetItem(row[c].toString()));
-                }
-            }
+        auto resultsModel = new QueryResultsModel(results, this);
+        auto proxy = new QSortFilterProxyModel(this);
+        proxy->setSourceModel(resultsModel);
+        proxy->setSortRole(QueryResultsModel::RawValueRole);
+        proxy->setFilterCaseSensitivity(Qt::CaseInsensitive);
+        proxy->setFilterKeyColumn(-1);
+        mUi->tableView->setModel(proxy);
+        mUi->tableView->sortByColumn(-1, Qt::AscendingOrder);
+
+        mUi->filterColumnCombo->addItem(i18n("All Columns"));
+        for (int c = 0; c < resultsModel->columnCount(); ++c) {
+            mUi->filterColumnCombo->addItem(resultsModel->headerData(c, Qt::Horizontal).toString());
         }
+        connect(mUi->filterEdit, &QLineEdit::textChanged, proxy, &QSortFilterProxyModel::setFilterFixedString);
+        connect(mUi->filterColumnCombo, &QComboBox::currentIndexChanged, proxy, [proxy](int index) {
+            proxy->setFilterKeyColumn(index - 1);
+        });
 
         connect(mUi->buttonBox, &QDialogButtonBox::rejected, this, &QDialog::accept);
     }
@@ -717,8 +348,28 @@ QueryDebugger::QueryDebugger(QWidget *parent)
 
     connect(mDebugger, &OrgFreedesktopAkonadiStorageDebuggerInterface::queryExecuted, this, &QueryDebugger::addQuery);
 
+    mIngestClock.start();
+    mFlushTimer.setInterval(16ms);
+    mFlushTimer.setSingleShot(true);
+    connect(&mFlushTimer, &QTimer::timeout, this, &QueryDebugger::flushPendingEvents);
+
     mUi->setupUi(this);
     connect(mUi->enableDebuggingChkBox, &QAbstractButton::toggled, this, &QueryDebugger::debuggerToggled);
+    connect(mUi->captureModeCombo, &QComboBox::currentIndexChanged, this, &QueryDebugger::captureModeChanged);
+    connect(mUi->captureThresholdSpin, &QSpinBox::valueChanged, this, [this](int value) {
+        mCaptureFilter.setThreshold(value);
+    });
+    connect(mUi->captureTopCountSpin, &QSpinBox::valueChanged, this, [this](int value) {
+        mCaptureFilter.setTopCount(value);
+        enqueueEvicted();
+    });
+    // The mode itself is restored with the rest of the UI state
+    const KConfigGroup config(KSharedConfig::openConfig(), u"QueryDebugger"_s);
+    mUi->captureThresholdSpin->setValue(config.readEntry("captureThreshold", mUi->captureThresholdSpin->value()));
+    mUi->captureTopCountSpin->setValue(config.readEntry("captureTopCount", mUi->captureTopCountSpin->value()));
+    mCaptureFilter.setThreshold(mUi->captureThresholdSpin->value());
+    mCaptureFilter.setTopCount(mUi->captureTopCountSpin->value());
+    captureModeChanged(mUi->captureModeCombo->currentIndex());
 
     mQueryList = new QueryDebuggerModel(this);
     auto proxy = new QSortFilterProxyModel(this);
@@ -729,14 +380,40 @@ QueryDebugger::QueryDebugger(QWidget *parent)
     mUi->queryListView->header()->setSectionResizeMode(QueryDebuggerModel::AvgDurationColumn, QHeaderView::Fixed);
     mUi->queryListView->header()->setSectionResizeMode(QueryDebuggerModel::QueryColumn, QHeaderView::ResizeToContents);
 
+    mPlanTimer.setInterval(5s);
+    connect(&mPlanTimer, &QTimer::timeout, this, &QueryDebugger::explainSlowQueries);
+    connect(mUi->explainSlowQueriesChkBox, &QAbstractButton::toggled, this, [this](bool on) {
+        if (on) {
+            if (!mPlanCollector) {
+                mPlanCollector = new QueryPlanCollector(this);
+                connect(mPlanCollector, &QueryPlanCollector::planReady, mQueryList, &QueryDebuggerModel::setPlan);
+            }
+            explainSlowQueries();
+            mPlanTimer.start();
+        } else {
+            mPlanTimer.stop();
+        }
+    });
+
     connect(mUi->queryTreeView, &QTreeView::doubleClicked, this, &QueryDebugger::queryTreeDoubleClicked);
     connect(mUi->saveToFileBtn, &QPushButton::clicked, this, &QueryDebugger::saveTreeToFile);
+    connect(mUi->loadFromFileBtn, &QPushButton::clicked, this, &QueryDebugger::loadTreeFromFile);
     mQueryTree = new QueryTreeModel(this);
     mUi->queryTreeView->setModel(mQueryTree);
-    connect(mDebugger, &org::freedesktop::Akonadi::StorageDebugger::connectionOpened, mQueryTree, &QueryTreeModel::addConnection);
-    connect(mDebugger, &org::freedesktop::Akonadi::StorageDebugger::connectionChanged, mQueryTree, &QueryTreeModel::updateConnection);
-    connect(mDebugger, &org::freedesktop::Akonadi::StorageDebugger::transactionStarted, mQueryTree, &QueryTreeModel::addTransaction);
-    connect(mDebugger, &org::freedesktop::Akonadi::StorageDebugger::transactionFinished, mQueryTree, &QueryTreeModel::closeTransaction);
+    mUi->tabWidget->addTab(new TransactionAnalysisWidget(mQueryTree, mUi->tabWidget), i18n("Transactions"));
+    auto repeatedQueries = new RepeatedQueriesWidget(mQueryTree, mUi->tabWidget);
+    connect(repeatedQueries, &RepeatedQueriesWidget::queryActivated, this, [this](const QModelIndex &index) {
+        mUi->tabWidget->setCurrentWidget(mUi->queryTreeTab);
+        mUi->queryTreeView->setCurrentIndex(index);
+        mUi->queryTreeView->scrollTo(index);
+    });
+    mUi->tabWidget->addTab(repeatedQueries, i18n("Repeated Queries"));
+    connect(mDebugger, &org::freedesktop::Akonadi::StorageDebugger::connectionOpened, this, &QueryDebugger::connectionOpened);
+    connect(mDebugger, &org::freedesktop::Akonadi::StorageDebugger::connectionChanged, this, &QueryDebugger::connectionChanged);
+    connect(mDebugger, &org::freedesktop::Akonadi::StorageDebugger::connectionClosed, this, &QueryDebugger::connectionClosed);
+    connect(mDebugger, &org::freedesktop::Akonadi::StorageDebugger::transactionStarted, this, &QueryDebugger::transactionStarted);
+    connect(mDebugger, &org::freedesktop::Akonadi::StorageDebugger::transactionFinished, this, &QueryDebugger::transactionFinished);
+    updateLagIndicator();
 
     Akonadi::ControlGui::widgetNeedsAkonadi(this);
 }
@@ -746,6 +423,10 @@ QueryDebugger::~QueryDebugger()
     // Disable debugging when turning off Akonadi Console so that we don't waste
     // resources on server
     mDebugger->enableSQLDebugging(false);
+
+    KConfigGroup config(KSharedConfig::openConfig(), u"QueryDebugger"_s);
+    config.writeEntry("captureThreshold", mUi->captureThresholdSpin->value());
+    config.writeEntry("captureTopCount", mUi->captureTopCountSpin->value());
 }
 
 void QueryDebugger::clear()
@@ -757,7 +438,13 @@ void QueryDebugger::debuggerToggled(bool on)
 {
     mDebugger->enableSQLDebugging(on);
     if (on) {
+        mFlushTimer.stop();
+        mPendingEvents.clear();
+        updateLagIndicator();
         mQueryTree->clear();
+        mCaptureFilter.reset();
+        // Their queries went with the tree
+        mCaptureFilter.takeEvicted();
 
         const QList<DbConnection> conns = mDebugger->connections();
         for (const auto &con : conns) {
@@ -780,8 +467,221 @@ void QueryDebugger::addQuery(double sequence,
                              const QString &error)
 {
     Q_UNUSED(sequence)
-    mQueryList->addQuery(query, duration);
-    mQueryTree->addQuery(connectionId, timestamp, duration, query, values, resultsCount, result, error);
+    PendingEvent event;
+    event.type = PendingEvent::QueryExecuted;
+    event.captured = mCaptureFilter.accept(query, duration, error);
+    event.record.captureSerial = mCaptureFilter.lastSerial();
+    event.record.connectionId = connectionId;
+    event.record.duration = duration;
+    event.record.query = query;
+    event.record.values = values;
+    if (event.captured) {
+        event.record.timestamp = timestamp;
+        event.record.resultsCount = resultsCount;
+        event.record.results = result;
+        event.record.error = error;
+    }
+    enqueue(std::move(event));
+    enqueueEvicted();
+}
+
+void QueryDebugger::connectionOpened(qint64 id, const QString &name, qint64 timestamp)
+{
+    PendingEvent event;
+    event.type = PendingEvent::ConnectionOpened;
+    event.record.connectionId = id;
+    event.record.query = name;
+    event.record.timestamp = timestamp;
+    enqueue(std::move(event));
+}
+
+void QueryDebugger::connectionChanged(qint64 id, const QString &name)
+{
+    PendingEvent event;
+    event.type = PendingEvent::ConnectionChanged;
+    event.record.connectionId = id;
+    event.record.query = name;
+    enqueue(std::move(event));
+}
+
+void QueryDebugger::connectionClosed(qint64 id, qint64 timestamp)
+{
+    PendingEvent event;
+    event.type = PendingEvent::ConnectionClosed;
+    event.record.connectionId = id;
+    event.record.timestamp = timestamp;
+    enqueue(std::move(event));
+}
+
+void QueryDebugger::transactionStarted(qint64 connectionId, const QString &name, qint64 timestamp, uint duration, const QString &error)
+{
+    PendingEvent event;
+    event.type = PendingEvent::TransactionStarted;
+    event.record.connectionId = connectionId;
+    event.record.query = name;
+    event.record.timestamp = timestamp;
+    event.record.duration = duration;
+    event.record.error = error;
+    enqueue(std::move(event));
+}
+
+void QueryDebugger::transactionFinished(qint64 connectionId, bool commit, qint64 timestamp, uint duration, const QString &error)
+{
+    PendingEvent event;
+    event.type = PendingEvent::TransactionFinished;
+    event.commit = commit;
+    event.record.connectionId = connectionId;
+    event.record.timestamp = timestamp;
+    event.record.duration = duration;
+    event.record.error = error;
+    enqueue(std::move(event));
+}
+
+void QueryDebugger::enqueue(PendingEvent &&event)
+{
+    event.received = mIngestClock.elapsed();
+    mPendingEvents.append(std::move(event));
+    if (!mFlushTimer.isActive()) {
+        mFlushTimer.start();
+    }
+}
+
+void QueryDebugger::enqueueEvicted()
+{
+    // Queued behind the calls they evict, which are then either in the tree or in the same flush
+    QList<quint64> evicted = mCaptureFilter.takeEvicted();
+    if (evicted.isEmpty()) {
+        return;
+    }
+    PendingEvent event;
+    event.type = PendingEvent::QueriesEvicted;
+    event.evicted = std::move(evicted);
+    enqueue(std::move(event));
+}
+
+void QueryDebugger::flushPendingEvents()
+{
+    // Leave the rest of the frame to the event loop, whatever is left over is
+    // picked up by the next flush
+    constexpr qint64 maxFlushTime = 10;
+
+    QElapsedTimer flushTime;
+    flushTime.start();
+
+    // Consecutive queries of a connection are inserted as a single range, the
+    // run only has to be committed before the connection's transaction changes
+    QHash<qint64, QList<QueryRecord>> queryRuns;
+    QList<QueryRecord> executed;
+    QSet<quint64> evicted;
+    const auto addRun = [this, &evicted](qint64 connectionId, QList<QueryRecord> &run) {
+        // Calls evicted before they even made it into the tree
+        if (!evicted.isEmpty()) {
+            run.removeIf([&evicted](const QueryRecord &record) {
+                return record.captureSerial != 0 && evicted.remove(record.captureSerial);
+            });
+        }
+        mQueryTree->addQueries(connectionId, run);
+    };
+    const auto commitRun = [&queryRuns, &addRun](qint64 connectionId) {
+        const auto it = queryRuns.find(connectionId);
+        if (it != queryRuns.end()) {
+            addRun(connectionId, *it);
+            queryRuns.erase(it);
+        }
+    };
+
+    int processed = 0;
+    const int count = mPendingEvents.count();
+    while (processed < count) {
+        auto &event = mPendingEvents[processed++];
+        const auto &record = event.record;
+        switch (event.type) {
+        case PendingEvent::QueryExecuted:
+            executed << record;
+            if (event.captured) {
+                queryRuns[record.connectionId] << record;
+            }
+            break;
+        case PendingEvent::ConnectionOpened:
+            commitRun(record.connectionId);
+            mQueryTree->addConnection(record.connectionId, record.query, record.timestamp);
+            break;
+        case PendingEvent::ConnectionChanged:
+            mQueryTree->updateConnection(record.connectionId, record.query);
+            break;
+        case PendingEvent::ConnectionClosed:
+            // Frees the nodes of the connection at once, which keeps a long session bounded
+            queryRuns.remove(record.connectionId);
+            mQueryTree->removeConnection(record.connectionId);
+            break;
+        case PendingEvent::TransactionStarted:
+            commitRun(record.connectionId);
+            mQueryTree->addTransaction(record.connectionId, record.query, record.timestamp, record.duration, record.error);
+            break;
+        case PendingEvent::TransactionFinished:
+            commitRun(record.connectionId);
+            mQueryTree->closeTransaction(record.connectionId, event.commit, record.timestamp, record.duration, record.error);
+            break;
+        case PendingEvent::QueriesEvicted:
+            for (const auto serial : std::as_const(event.evicted)) {
+                evicted.insert(serial);
+            }
+            break;
+        }
+
+        if (processed % 64 == 0 && flushTime.elapsed() > maxFlushTime) {
+            break;
+        }
+    }
+
+    for (auto it = queryRuns.begin(), end = queryRuns.end(); it != end; ++it) {
+        addRun(it.key(), it.value());
+    }
+    if (!evicted.isEmpty()) {
+        mQueryTree->removeCapturedQueries(evicted.values());
+    }
+    mQueryList->addQueries(executed);
+
+    mPendingEvents.remove(0, processed);
+    if (!mPendingEvents.isEmpty()) {
+        mFlushTimer.start();
+    }
+    updateLagIndicator();
+}
+
+void QueryDebugger::updateLagIndicator()
+{
+    if (mPendingEvents.isEmpty()) {
+        mUi->ingestLagLbl->setText(i18n("Ingestion lag: none"));
+        return;
+    }
+
+    const qint64 lag = mIngestClock.elapsed() - mPendingEvents.constFirst().received;
+    mUi->ingestLagLbl->setText(i18np("Ingestion lag: %2 ms, %1 queued event", "Ingestion lag: %2 ms, %1 queued events", mPendingEvents.count(), lag));
+}
+
+void QueryDebugger::explainSlowQueries()
+{
+    // Only the slowest statements are worth the extra load on the server
+    constexpr int explainedQueries = 10;
+    const auto slowest = mQueryList->slowestQueries(explainedQueries);
+    for (const auto &info : slowest) {
+        const QString plan = mPlanCollector->plan(info.query);
+        if (plan.isEmpty()) {
+            mPlanCollector->requestPlan(info.query, info.slowestValues);
+        } else if (info.plan.isEmpty()) {
+            mQueryList->setPlan(info.query, plan);
+        }
+    }
+}
+
+void QueryDebugger::captureModeChanged(int mode)
+{
+    // The spin boxes keep the threshold and top count up to date, setMode() forgets the slowest calls
+    mCaptureFilter.setMode(static_cast<QueryCaptureFilter::Mode>(mode));
+    enqueueEvicted();
+    mUi->captureThresholdSpin->setVisible(mode == QueryCaptureFilter::CaptureSlowerThan);
+    mUi->captureTopCountSpin->setVisible(mode == QueryCaptureFilter::CaptureTopSlowest);
 }
 
 void QueryDebugger::queryTreeDoubleClicked(const QModelIndex &index)
@@ -801,19 +701,49 @@ void QueryDebugger::queryTreeDoubleClicked(const QModelIndex &index)
 
 void QueryDebugger::saveTreeToFile()
 {
-    const QString fileName = QFileDialog::getSaveFileName(this);
+    const QString textFilter = i18n("Text Files (*.txt)");
+    const QString csvFilter = i18n("CSV Files (*.csv)");
+    const QString jsonFilter = i18n("JSON Lines Files (*.jsonl)");
+    QString selectedFilter = jsonFilter;
+    const QString fileName =
+        QFileDialog::getSaveFileName(this, i18n("Save Query Tree"), QString(), u"%1;;%2;;%3"_s.arg(jsonFilter, textFilter, csvFilter), &selectedFilter);
+    if (fileName.isEmpty()) {
+        return;
+    }
+
+    QueryTreeExportJob::Format format = QueryTreeExportJob::JsonLines;
+    if (selectedFilter == textFilter) {
+        format = QueryTreeExportJob::Text;
+    } else if (selectedFilter == csvFilter) {
+        format = QueryTreeExportJob::Csv;
+    }
+
+    auto job = new QueryTreeExportJob(mQueryTree, fileName, format, this);
+    job->startWithProgressDialog(this, i18n("Saving query tree..."));
+}
+
+void QueryDebugger::loadTreeFromFile()
+{
+    const QString fileName = QFileDialog::getOpenFileName(this, i18n("Load Query Tree"), QString(), i18n("JSON Lines Files (*.jsonl)"));
     if (fileName.isEmpty()) {
         return;
     }
     QFile file(fileName);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
-        // show error
+    if (!file.open(QIODevice::ReadOnly)) {
+        QMessageBox::warning(this, i18n("Error"), i18n("Failed to open file: %1", file.errorString()));
         return;
     }
 
-    mQueryTree->dumpRow(file, QModelIndex(), 0);
+    // A loaded capture must not get mixed up with live queries
+    mUi->enableDebuggingChkBox->setChecked(false);
+    mFlushTimer.stop();
+    mPendingEvents.clear();
+    updateLagIndicator();
 
-    file.close();
+    QString errorString;
+    if (!QueryTreeExportJob::load(&file, mQueryTree, &errorString)) {
+        QMessageBox::warning(this, i18n("Error"), i18n("Failed to load file: %1", errorString));
+    }
 }
 
 #include "querydebugger.moc"
@@ -7,8 +7,13 @@
 
 #pragma once
 
+#include "querycapturefilter.h"
+#include "querytreemodel.h"
+
+#include <QElapsedTimer>
 #include <QMap>
 #include <QScopedPointer>
+#include <QTimer>
 #include <QVariant>
 #include <QWidget>
 
@@ -20,7 +25,7 @@ class QueryDebugger;
 }
 
 class QueryDebuggerModel;
-class QueryTreeModel;
+class QueryPlanCollector;
 class OrgFreedesktopAkonadiStorageDebuggerInterface;
 
 struct DbConnection {
@@ -56,14 +61,58 @@ private Q_SLOTS:
                   int resultsCount,
                   const QList<QList<QVariant>> &result,
                   const QString &error);
+    void connectionOpened(qint64 id, const QString &name, qint64 timestamp);
+    void connectionChanged(qint64 id, const QString &name);
+    void connectionClosed(qint64 id, qint64 timestamp);
+    void transactionStarted(qint64 connectionId, const QString &name, qint64 timestamp, uint duration, const QString &error);
+    void transactionFinished(qint64 connectionId, bool commit, qint64 timestamp, uint duration, const QString &error);
+    void captureModeChanged(int mode);
+    void explainSlowQueries();
     void queryTreeDoubleClicked(const QModelIndex &index);
     void clear();
     void saveTreeToFile();
+    void loadTreeFromFile();
 
 private:
+    // Storage debugger signals are queued and applied to the models once per
+    // frame, so that a busy server does not get one model update per query.
+    struct PendingEvent {
+        enum Type {
+            ConnectionOpened,
+            ConnectionChanged,
+            ConnectionClosed,
+            TransactionStarted,
+            TransactionFinished,
+            QueryExecuted,
+            // Captured queries that slower calls pushed out of the top lists
+            QueriesEvicted
+        };
+        Type type;
+        bool commit = false;
+        // Queries rejected by the capture filter only count towards the statistics
+        bool captured = true;
+        qint64 received = 0;
+        QueryRecord record;
+        QList<quint64> evicted;
+    };
+
+    void enqueue(PendingEvent &&event);
+    // Queues the removal of the calls the capture filter no longer keeps
+    void enqueueEvicted();
+    void flushPendingEvents();
+    void updateLagIndicator();
+
     QScopedPointer<Ui::QueryDebugger> mUi;
     OrgFreedesktopAkonadiStorageDebuggerInterface *mDebugger = nullptr;
 
     QueryDebuggerModel *mQueryList = nullptr;
     QueryTreeModel *mQueryTree = nullptr;
+
+    QueryCaptureFilter mCaptureFilter;
+    QList<PendingEvent> mPendingEvents;
+    QTimer mFlushTimer;
+
+    QueryPlanCollector *mPlanCollector = nullptr;
+    QTimer mPlanTimer;
+    QElapsedTimer mIngestClock;
 };
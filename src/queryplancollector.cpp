@@ -0,0 +1,170 @@
+/*
+ * SPDX-FileCopyrightText: 2026 akonadiconsole authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ */
+
+#include "queryplancollector.h"
+using namespace Qt::Literals::StringLiterals;
+
+#include <Akonadi/DbAccess>
+
+#include <KLocalizedString>
+
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QSqlRecord>
+
+#include <chrono>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+// Minimum pause between two EXPLAINs
+constexpr auto ExplainInterval = 2s;
+}
+
+class QueryPlanWorker : public QObject
+{
+    Q_OBJECT
+public:
+    explicit QueryPlanWorker(const QString &sourceConnectionName)
+        : mSourceConnectionName(sourceConnectionName)
+    {
+    }
+
+    ~QueryPlanWorker() override
+    {
+        const QString connectionName = mDb.connectionName();
+        mDb.close();
+        mDb = QSqlDatabase();
+        if (!connectionName.isEmpty()) {
+            QSqlDatabase::removeDatabase(connectionName);
+        }
+    }
+
+    void explain(const QString &query, const QMap<QString, QVariant> &values)
+    {
+        if (!mDb.isValid()) {
+            // QSqlDatabase connections must not be shared between threads, only
+            // cloning by connection name is safe from another thread
+            mDb = QSqlDatabase::cloneDatabase(mSourceConnectionName, u"akonadiconsole-queryplans"_s);
+        }
+        if (!mDb.isOpen() && !mDb.open()) {
+            Q_EMIT explained(query, i18n("Failed to connect to the database: %1", mDb.lastError().text()));
+            return;
+        }
+
+        const QString driver = mDb.driverName();
+        const QString prefix = driver.startsWith("QSQLITE"_L1) ? u"EXPLAIN QUERY PLAN "_s : u"EXPLAIN "_s;
+
+        QSqlQuery sqlQuery(mDb);
+        if (!sqlQuery.prepare(prefix + query)) {
+            Q_EMIT explained(query, sqlQuery.lastError().text());
+            return;
+        }
+        // The storage debugger reports positional bind values as :0, :1, ...
+        for (int i = 0; i < values.count(); ++i) {
+            sqlQuery.addBindValue(values.value(u":%1"_s.arg(i)));
+        }
+        if (!sqlQuery.exec()) {
+            Q_EMIT explained(query, sqlQuery.lastError().text());
+            return;
+        }
+
+        QStringList lines;
+        const QSqlRecord record = sqlQuery.record();
+        QStringList header;
+        for (int c = 0; c < record.count(); ++c) {
+            header << record.fieldName(c);
+        }
+        lines << header.join(" | "_L1);
+        while (sqlQuery.next()) {
+            QStringList columns;
+            for (int c = 0; c < record.count(); ++c) {
+                columns << sqlQuery.value(c).toString();
+            }
+            lines << columns.join(" | "_L1);
+        }
+        Q_EMIT explained(query, lines.join(u'\n'));
+    }
+
+Q_SIGNALS:
+    void explained(const QString &query, const QString &plan);
+
+private:
+    const QString mSourceConnectionName;
+    QSqlDatabase mDb;
+};
+
+QueryPlanCollector::QueryPlanCollector(QObject *parent)
+    : QObject(parent)
+    , mWorker(new QueryPlanWorker(Akonadi::DbAccess::database().connectionName()))
+{
+    mWorker->moveToThread(&mThread);
+    connect(&mThread, &QThread::finished, mWorker, &QObject::deleteLater);
+    connect(this, &QueryPlanCollector::explain, mWorker, &QueryPlanWorker::explain);
+    connect(mWorker, &QueryPlanWorker::explained, this, &QueryPlanCollector::explained);
+    mThread.setObjectName(u"QueryPlanCollector"_s);
+    mThread.start(QThread::LowPriority);
+
+    mRateLimitTimer.setInterval(ExplainInterval);
+    mRateLimitTimer.setSingleShot(true);
+    connect(&mRateLimitTimer, &QTimer::timeout, this, &QueryPlanCollector::explainNext);
+}
+
+QueryPlanCollector::~QueryPlanCollector()
+{
+    mThread.quit();
+    mThread.wait();
+}
+
+void QueryPlanCollector::requestPlan(const QString &query, const QMap<QString, QVariant> &values)
+{
+    // EXPLAIN is only meaningful, and only harmless, for data manipulation statements
+    const QString statement = query.trimmed();
+    if (!statement.startsWith("SELECT"_L1, Qt::CaseInsensitive) && !statement.startsWith("UPDATE"_L1, Qt::CaseInsensitive)
+        && !statement.startsWith("DELETE"_L1, Qt::CaseInsensitive)) {
+        return;
+    }
+    if (mRequested.contains(query)) {
+        return;
+    }
+
+    mRequested.insert(query);
+    mQueue.append({query, values});
+    if (!mBusy && !mRateLimitTimer.isActive()) {
+        explainNext();
+    }
+}
+
+QString QueryPlanCollector::plan(const QString &query) const
+{
+    return mPlans.value(query);
+}
+
+void QueryPlanCollector::explainNext()
+{
+    if (mBusy || mQueue.isEmpty()) {
+        return;
+    }
+
+    mBusy = true;
+    const auto next = mQueue.takeFirst();
+    Q_EMIT explain(next.first, next.second);
+}
+
+void QueryPlanCollector::explained(const QString &query, const QString &plan)
+{
+    mBusy = false;
+    mPlans.insert(query, plan);
+    Q_EMIT planReady(query, plan);
+    mRateLimitTimer.start();
+}
+
+#include "queryplancollector.moc"
+
+#include "moc_queryplancollector.cpp"
@@ -0,0 +1,57 @@
+/*
+ * SPDX-FileCopyrightText: 2026 akonadiconsole authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ */
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QObject>
+#include <QSet>
+#include <QThread>
+#include <QTimer>
+#include <QVariant>
+
+class QueryPlanWorker;
+
+/**
+ * Runs EXPLAIN for slow statements on a connection of its own.
+ *
+ * Statements are explained one at a time on a worker thread, with a pause in
+ * between, so that the collector does not add noticeable load to a server that
+ * is already struggling. Plans are cached per statement.
+ */
+class QueryPlanCollector : public QObject
+{
+    Q_OBJECT
+public:
+    explicit QueryPlanCollector(QObject *parent = nullptr);
+    ~QueryPlanCollector() override;
+
+    /** Queues @p query to be explained with @p values bound, unless it already has been. */
+    void requestPlan(const QString &query, const QMap<QString, QVariant> &values);
+    [[nodiscard]] QString plan(const QString &query) const;
+
+Q_SIGNALS:
+    void planReady(const QString &query, const QString &plan);
+
+    // Internal, delivered to the worker thread
+    void explain(const QString &query, const QMap<QString, QVariant> &values);
+
+private:
+    void explainNext();
+    void explained(const QString &query, const QString &plan);
+
+    QThread mThread;
+    QueryPlanWorker *mWorker = nullptr;
+    QHash<QString, QString> mPlans;
+    QList<QPair<QString, QMap<QString, QVariant>>> mQueue;
+    QSet<QString> mRequested;
+    QTimer mRateLimitTimer;
+    bool mBusy = false;
+};
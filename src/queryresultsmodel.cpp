@@ -0,0 +1,65 @@
+/*
+ * SPDX-FileCopyrightText: 2026 akonadiconsole authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ */
+
+#include "queryresultsmodel.h"
+
+QueryResultsModel::QueryResultsModel(const QList<QList<QVariant>> &results, QObject *parent)
+    : QAbstractTableModel(parent)
+    , mResults(results)
+{
+}
+
+QueryResultsModel::~QueryResultsModel() = default;
+
+int QueryResultsModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid() || mResults.isEmpty()) {
+        return 0;
+    }
+    return mResults.count() - 1;
+}
+
+int QueryResultsModel::columnCount(const QModelIndex &parent) const
+{
+    if (parent.isValid() || mResults.isEmpty()) {
+        return 0;
+    }
+    return mResults.constFirst().count();
+}
+
+QVariant QueryResultsModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || (role != Qt::DisplayRole && role != Qt::ToolTipRole && role != RawValueRole)) {
+        return {};
+    }
+
+    const auto &row = mResults.at(index.row() + 1);
+    if (index.column() >= row.count()) {
+        return {};
+    }
+
+    const QVariant &value = row.at(index.column());
+    if (role == RawValueRole) {
+        return value;
+    }
+    return value.toString();
+}
+
+QVariant QueryResultsModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole || mResults.isEmpty()) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+
+    const auto &headers = mResults.constFirst();
+    if (section < 0 || section >= headers.count()) {
+        return {};
+    }
+    return headers.at(section).toString();
+}
+
+#include "moc_queryresultsmodel.cpp"
@@ -0,0 +1,42 @@
+/*
+ * SPDX-FileCopyrightText: 2026 akonadiconsole authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ */
+
+#pragma once
+
+#include "libakonadiconsole_export.h"
+
+#include <QAbstractTableModel>
+#include <QList>
+#include <QVariant>
+
+/**
+ * Table model over the result set of a query reported by the storage debugger.
+ *
+ * The model shares the result list with the query tree instead of copying it
+ * and only converts a cell to text when it is displayed. The first row of the
+ * result set holds the column names.
+ */
+class LIBAKONADICONSOLE_EXPORT QueryResultsModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    enum {
+        // The value as returned by the database, used for sorting
+        RawValueRole = Qt::UserRole + 1
+    };
+
+    explicit QueryResultsModel(const QList<QList<QVariant>> &results, QObject *parent = nullptr);
+    ~QueryResultsModel() override;
+
+    [[nodiscard]] int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    [[nodiscard]] int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    [[nodiscard]] QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    [[nodiscard]] QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    const QList<QList<QVariant>> mResults;
+};
@@ -0,0 +1,317 @@
+/*
+ * SPDX-FileCopyrightText: 2026 akonadiconsole authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ */
+
+#include "querytreeexportjob.h"
+using namespace Qt::Literals::StringLiterals;
+
+#include <KLocalizedString>
+
+#include <QDateTime>
+#include <QIODevice>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+
+namespace
+{
+QString formatTime(qint64 msecs)
+{
+    return QDateTime::fromMSecsSinceEpoch(msecs).toString(u"dd.MM.yyyy HH:mm:ss.zzz"_s);
+}
+
+QString transactionState(QueryTreeModel::TransactionState state)
+{
+    switch (state) {
+    case QueryTreeModel::TransactionOpen:
+        return u"BEGIN"_s;
+    case QueryTreeModel::TransactionCommitted:
+        return u"COMMIT"_s;
+    case QueryTreeModel::TransactionRolledBack:
+        return u"ROLLBACK"_s;
+    }
+    return {};
+}
+
+QString csvField(const QString &value)
+{
+    if (!value.contains(u',') && !value.contains(u'"') && !value.contains(u'\n')) {
+        return value;
+    }
+    QString escaped = value;
+    escaped.replace(u"\""_s, u"\"\""_s);
+    return u'"' + escaped + u'"';
+}
+
+QJsonArray resultsToJson(const QList<QList<QVariant>> &results)
+{
+    QJsonArray array;
+    for (const auto &row : results) {
+        array.append(QJsonArray::fromVariantList(row));
+    }
+    return array;
+}
+
+QList<QList<QVariant>> resultsFromJson(const QJsonArray &array)
+{
+    QList<QList<QVariant>> results;
+    results.reserve(array.size());
+    for (const auto &row : array) {
+        results << row.toArray().toVariantList();
+    }
+    return results;
+}
+
+// Progress is reported every this many rows
+constexpr int ProgressInterval = 1024;
+}
+
+QueryTreeExportJob::QueryTreeExportJob(const QueryTreeModel *model, const QString &fileName, Format format, QObject *parent)
+    : ExportJob(fileName, parent)
+    , mRows(model->snapshot())
+    , mFormat(format)
+{
+}
+
+QueryTreeExportJob::~QueryTreeExportJob() = default;
+
+bool QueryTreeExportJob::write(QIODevice *device)
+{
+    switch (mFormat) {
+    case Text:
+        return writeText(device);
+    case Csv:
+        return writeCsv(device);
+    case JsonLines:
+        return writeJsonLines(device);
+    }
+    return false;
+}
+
+bool QueryTreeExportJob::writeText(QIODevice *device)
+{
+    QTextStream stream(device);
+    for (qsizetype i = 0, count = mRows.count(); i < count; ++i) {
+        if (i % ProgressInterval == 0) {
+            if (isCanceled()) {
+                return false;
+            }
+            reportProgress(i, count);
+        }
+
+        const auto &row = mRows.at(i);
+        const int depth = row.type == QueryTreeModel::Connection ? 1 : row.inTransaction ? 3 : 2;
+        const QString indent = u"  |"_s.repeated(depth);
+        stream << indent << "- ";
+        switch (row.type) {
+        case QueryTreeModel::Connection:
+            stream << row.name << "    " << formatTime(row.start);
+            break;
+        case QueryTreeModel::Transaction:
+            stream << transactionState(row.transactionState) << ' ' << row.name << "    " << formatTime(row.start);
+            if (row.transactionState != QueryTreeModel::TransactionOpen) {
+                stream << " - " << formatTime(row.start + row.duration);
+            }
+            break;
+        case QueryTreeModel::Query:
+            stream << row.name << "    " << formatTime(row.start) << ", took " << row.duration << " ms";
+            break;
+        }
+        if (!row.error.isEmpty()) {
+            stream << '\n' << indent << "  Error: " << row.error;
+        }
+        stream << '\n';
+    }
+
+    stream.flush();
+    return stream.status() == QTextStream::Ok;
+}
+
+bool QueryTreeExportJob::writeCsv(QIODevice *device)
+{
+    QTextStream stream(device);
+    stream << "type,connection,transaction,name,started,ended,duration,results,error\n";
+    QString connectionName;
+    for (qsizetype i = 0, count = mRows.count(); i < count; ++i) {
+        if (i % ProgressInterval == 0) {
+            if (isCanceled()) {
+                return false;
+            }
+            reportProgress(i, count);
+        }
+
+        const auto &row = mRows.at(i);
+        switch (row.type) {
+        case QueryTreeModel::Connection:
+            connectionName = row.name;
+            stream << "connection," << csvField(connectionName) << ",," << csvField(row.name) << ',' << formatTime(row.start) << ",,,,";
+            break;
+        case QueryTreeModel::Transaction:
+            stream << "transaction," << csvField(connectionName) << ',' << transactionState(row.transactionState) << ',' << csvField(row.name) << ','
+                   << formatTime(row.start) << ',';
+            if (row.transactionState != QueryTreeModel::TransactionOpen) {
+                stream << formatTime(row.start + row.duration) << ',' << row.duration;
+            } else {
+                stream << ',';
+            }
+            stream << ",," << csvField(row.error);
+            break;
+        case QueryTreeModel::Query:
+            stream << "query," << csvField(connectionName) << ',' << (row.inTransaction ? "yes" : "no") << ',' << csvField(row.name) << ','
+                   << formatTime(row.start) << ',' << formatTime(row.start + row.duration) << ',' << row.duration << ',' << row.resultsCount << ','
+                   << csvField(row.error);
+            break;
+        }
+        stream << '\n';
+    }
+
+    stream.flush();
+    return stream.status() == QTextStream::Ok;
+}
+
+bool QueryTreeExportJob::writeJsonLines(QIODevice *device)
+{
+    for (qsizetype i = 0, count = mRows.count(); i < count; ++i) {
+        if (i % ProgressInterval == 0) {
+            if (isCanceled()) {
+                return false;
+            }
+            reportProgress(i, count);
+        }
+
+        const auto &row = mRows.at(i);
+        QJsonObject json;
+        switch (row.type) {
+        case QueryTreeModel::Connection:
+            json["type"_L1] = u"connection"_s;
+            json["id"_L1] = row.connectionId;
+            json["name"_L1] = row.name;
+            json["start"_L1] = row.start;
+            break;
+        case QueryTreeModel::Transaction:
+            json["type"_L1] = u"transaction"_s;
+            json["connection"_L1] = row.connectionId;
+            json["name"_L1] = row.name;
+            json["start"_L1] = row.start;
+            json["duration"_L1] = static_cast<qint64>(row.duration);
+            json["state"_L1] = transactionState(row.transactionState);
+            json["error"_L1] = row.error;
+            break;
+        case QueryTreeModel::Query:
+            json["type"_L1] = u"query"_s;
+            json["connection"_L1] = row.connectionId;
+            json["inTransaction"_L1] = row.inTransaction;
+            json["query"_L1] = row.name;
+            json["start"_L1] = row.start;
+            json["duration"_L1] = static_cast<qint64>(row.duration);
+            json["values"_L1] = QJsonObject::fromVariantMap(row.values);
+            json["resultsCount"_L1] = row.resultsCount;
+            json["results"_L1] = resultsToJson(row.results);
+            json["error"_L1] = row.error;
+            break;
+        }
+
+        if (device->write(QJsonDocument(json).toJson(QJsonDocument::Compact) + '\n') < 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool QueryTreeExportJob::load(QIODevice *device, QueryTreeModel *model, QString *errorString)
+{
+    struct ClosedTransaction {
+        bool commit = true;
+        qint64 end = 0;
+        QString error;
+    };
+
+    model->clear();
+
+    // Same as when receiving from the server: consecutive queries of a
+    // connection are inserted at once, and a transaction is only closed
+    // once all of its queries have been added.
+    QHash<qint64, QList<QueryRecord>> queryRuns;
+    QHash<qint64, ClosedTransaction> closedTransactions;
+    const auto commitRun = [model, &queryRuns](qint64 connectionId) {
+        const auto queries = queryRuns.take(connectionId);
+        if (!queries.isEmpty()) {
+            model->addQueries(connectionId, queries);
+        }
+    };
+    const auto closeTransaction = [model, &closedTransactions, &commitRun](qint64 connectionId) {
+        commitRun(connectionId);
+        const auto it = closedTransactions.constFind(connectionId);
+        if (it != closedTransactions.cend()) {
+            model->closeTransaction(connectionId, it->commit, it->end, 0, it->error);
+            closedTransactions.erase(it);
+        }
+    };
+
+    int lineNumber = 0;
+    while (!device->atEnd()) {
+        const QByteArray line = device->readLine().trimmed();
+        ++lineNumber;
+        if (line.isEmpty()) {
+            continue;
+        }
+
+        QJsonParseError parseError;
+        const QJsonObject json = QJsonDocument::fromJson(line, &parseError).object();
+        if (parseError.error != QJsonParseError::NoError) {
+            *errorString = i18n("Line %1: %2", lineNumber, parseError.errorString());
+            return false;
+        }
+
+        const QString type = json["type"_L1].toString();
+        if (type == "connection"_L1) {
+            const qint64 id = json["id"_L1].toInteger();
+            closeTransaction(id);
+            model->addConnection(id, json["name"_L1].toString(), json["start"_L1].toInteger());
+        } else if (type == "transaction"_L1) {
+            const qint64 connectionId = json["connection"_L1].toInteger();
+            closeTransaction(connectionId);
+            const QString state = json["state"_L1].toString();
+            const qint64 start = json["start"_L1].toInteger();
+            model->addTransaction(connectionId, json["name"_L1].toString(), start, 0, QString());
+            if (state != "BEGIN"_L1) {
+                ClosedTransaction trx;
+                trx.commit = state == "COMMIT"_L1;
+                trx.end = start + json["duration"_L1].toInteger();
+                trx.error = json["error"_L1].toString();
+                closedTransactions.insert(connectionId, trx);
+            }
+        } else if (type == "query"_L1) {
+            QueryRecord record;
+            record.connectionId = json["connection"_L1].toInteger();
+            record.timestamp = json["start"_L1].toInteger();
+            record.duration = json["duration"_L1].toInteger();
+            record.query = json["query"_L1].toString();
+            record.values = json["values"_L1].toObject().toVariantMap();
+            record.resultsCount = json["resultsCount"_L1].toInt();
+            record.results = resultsFromJson(json["results"_L1].toArray());
+            record.error = json["error"_L1].toString();
+            if (!json["inTransaction"_L1].toBool()) {
+                closeTransaction(record.connectionId);
+            }
+            queryRuns[record.connectionId] << record;
+        } else {
+            *errorString = i18n("Line %1: unknown record type \"%2\"", lineNumber, type);
+            return false;
+        }
+    }
+
+    const auto connections = queryRuns.keys() + closedTransactions.keys();
+    for (const auto connectionId : connections) {
+        closeTransaction(connectionId);
+    }
+
+    return true;
+}
+
+#include "moc_querytreeexportjob.cpp"
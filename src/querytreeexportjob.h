@@ -0,0 +1,47 @@
+/*
+ * SPDX-FileCopyrightText: 2026 akonadiconsole authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ */
+
+#pragma once
+
+#include "exportjob.h"
+#include "querytreemodel.h"
+
+class QIODevice;
+
+/**
+ * Writes a snapshot of the Query Debugger's query tree to a file.
+ *
+ * The JSON Lines format keeps everything the tree knows and can be loaded back
+ * into a QueryTreeModel with load().
+ */
+class LIBAKONADICONSOLE_EXPORT QueryTreeExportJob : public ExportJob
+{
+    Q_OBJECT
+public:
+    enum Format {
+        Text,
+        Csv,
+        JsonLines
+    };
+
+    QueryTreeExportJob(const QueryTreeModel *model, const QString &fileName, Format format, QObject *parent = nullptr);
+    ~QueryTreeExportJob() override;
+
+    /** Replaces the content of @p model with a capture written in the JsonLines format. */
+    static bool load(QIODevice *device, QueryTreeModel *model, QString *errorString);
+
+protected:
+    bool write(QIODevice *device) override;
+
+private:
+    bool writeText(QIODevice *device);
+    bool writeCsv(QIODevice *device);
+    bool writeJsonLines(QIODevice *device);
+
+    const QList<QueryTreeModel::SnapshotRow> mRows;
+    const Format mFormat;
+};
@@ -0,0 +1,717 @@
+/*
+ * SPDX-FileCopyrightText: 2013 Daniel Vrátil <dvratil@redhat.com>
+ * SPDX-FileCopyrightText: 2017 Daniel Vrátil <dvratil@kde.org>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ */
+
+#include "querytreemodel.h"
+using namespace Qt::Literals::StringLiterals;
+
+#include <KColorScheme>
+#include <KLocalizedString>
+
+#include <QDateTime>
+
+#include <algorithm>
+
+QueryTreeModel::QueryTreeModel(QObject *parent)
+    : QAbstractItemModel(parent)
+{
+}
+
+QueryTreeModel::~QueryTreeModel() = default;
+
+int QueryTreeModel::TextTable::acquire(const QString &text)
+{
+    auto it = mIds.constFind(text);
+    if (it == mIds.constEnd()) {
+        int id;
+        if (mFree.empty()) {
+            id = int(mTexts.size());
+            mTexts.push_back({text});
+        } else {
+            id = mFree.back();
+            mFree.pop_back();
+            mTexts[id].text = text;
+        }
+        it = mIds.insert(text, id);
+    }
+    ++mTexts[*it].references;
+    return *it;
+}
+
+void QueryTreeModel::TextTable::release(int id)
+{
+    auto &text = mTexts[id];
+    if (--text.references == 0) {
+        mIds.remove(text.text);
+        text.text.clear();
+        mFree.push_back(id);
+    }
+}
+
+void QueryTreeModel::clear()
+{
+    beginResetModel();
+    mConnections.clear();
+    mConnectionById.clear();
+    mRepeatedRuns.clear();
+    mCapturedQueries.clear();
+    mConnectionPool.clear();
+    endResetModel();
+}
+
+void QueryTreeModel::addConnection(qint64 id, const QString &name, qint64 timestamp)
+{
+    auto con = mConnectionPool.allocate();
+    con->parent = nullptr;
+    con->type = Connection;
+    con->id = id;
+    con->row = mConnections.count();
+    con->name = name;
+    con->start = timestamp;
+    beginInsertRows(QModelIndex(), con->row, con->row);
+    mConnections << con;
+    mConnectionById.insert(id, con);
+    endInsertRows();
+}
+
+void QueryTreeModel::updateConnection(qint64 id, const QString &name)
+{
+    auto con = mConnectionById.value(id);
+    if (!con) {
+        return;
+    }
+
+    con->name = name;
+    const QModelIndex index = createIndex(con->row, 0, con);
+    Q_EMIT dataChanged(index, index.sibling(index.row(), columnCount() - 1));
+}
+
+void QueryTreeModel::removeConnection(qint64 id)
+{
+    auto con = mConnectionById.value(id);
+    if (!con) {
+        return;
+    }
+
+    beginRemoveRows(QModelIndex(), con->row, con->row);
+    mConnections.removeAt(con->row);
+    for (int row = con->row; row < mConnections.count(); ++row) {
+        mConnections[row]->row = row;
+    }
+    mConnectionById.remove(id);
+    const auto removedRuns = mRepeatedRuns.removeIf([con](const RepeatRun *run) {
+        return connectionOf(run->parent) == con;
+    });
+    for (auto it = mCapturedQueries.begin(); it != mCapturedQueries.end();) {
+        if (connectionOf(*it) == con) {
+            it = mCapturedQueries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    endRemoveRows();
+
+    // Drops the pools of its queries, transactions, runs and texts in one go
+    mConnectionPool.release(con);
+    if (removedRuns > 0) {
+        Q_EMIT repeatedQueriesChanged();
+    }
+}
+
+void QueryTreeModel::addTransaction(qint64 connectionId, const QString &name, qint64 timestamp, uint duration, const QString &error)
+{
+    auto con = mConnectionById.value(connectionId);
+    if (!con) {
+        return;
+    }
+
+    auto trx = con->transactionPool.allocate();
+    trx->name = con->texts.acquire(name);
+    trx->parent = con;
+    trx->type = Transaction;
+    trx->row = con->queries.count();
+    trx->start = timestamp;
+    trx->duration = duration;
+    trx->transactionType = TransactionNode::Begin;
+    trx->error = error.trimmed();
+    // Repeats are only looked for among siblings
+    con->runParent = nullptr;
+    const QModelIndex conIdx = createIndex(con->row, 0, con);
+    beginInsertRows(conIdx, trx->row, trx->row);
+    con->queries << trx;
+    endInsertRows();
+}
+
+void QueryTreeModel::closeTransaction(qint64 connectionId, bool commit, qint64 timestamp, uint, const QString &error)
+{
+    auto con = mConnectionById.value(connectionId);
+    if (!con) {
+        return;
+    }
+
+    // Find the last open transaction and change it to closed
+    for (int i = con->queries.count() - 1; i >= 0; i--) {
+        Node *node = con->queries[i];
+        if (node->type == Transaction) {
+            auto trx = static_cast<TransactionNode *>(node);
+            if (trx->transactionType != TransactionNode::Begin) {
+                continue;
+            }
+
+            trx->transactionType = commit ? TransactionNode::Commit : TransactionNode::Rollback;
+            trx->duration = timestamp - trx->start;
+            trx->error = error.trimmed();
+
+            const QModelIndex trxIdx = createIndex(trx->row, 0, trx);
+            Q_EMIT dataChanged(trxIdx, trxIdx.sibling(trxIdx.row(), columnCount() - 1));
+            Q_EMIT transactionClosed(connectionId, con->name, con->texts.at(trx->name), trx->start, timestamp, commit);
+            return;
+        }
+    }
+}
+
+void QueryTreeModel::addQuery(qint64 connectionId,
+                              qint64 timestamp,
+                              uint duration,
+                              const QString &queryStr,
+                              const QMap<QString, QVariant> &values,
+                              int resultsCount,
+                              const QList<QList<QVariant>> &results,
+                              const QString &error)
+{
+    QueryRecord record;
+    record.connectionId = connectionId;
+    record.timestamp = timestamp;
+    record.duration = duration;
+    record.query = queryStr;
+    record.values = values;
+    record.resultsCount = resultsCount;
+    record.results = results;
+    record.error = error;
+    addQueries(connectionId, {record});
+}
+
+void QueryTreeModel::addQueries(qint64 connectionId, const QList<QueryRecord> &queries)
+{
+    auto con = mConnectionById.value(connectionId);
+    if (!con || queries.isEmpty()) {
+        return;
+    }
+
+    // Queries executed while a transaction is open belong to that transaction
+    Node *parent = con;
+    if (!con->queries.isEmpty() && con->queries.last()->type == Transaction
+        && static_cast<TransactionNode *>(con->queries.last())->transactionType == TransactionNode::Begin) {
+        parent = con->queries.last();
+    }
+    QList<QueryNode *> *trxQueries = parent->type == Transaction ? &static_cast<TransactionNode *>(parent)->queries : nullptr;
+
+    const int first = trxQueries ? trxQueries->count() : con->queries.count();
+    beginInsertRows(createIndex(parent->row, 0, parent), first, first + queries.count() - 1);
+    QList<RepeatRun *> changedRuns;
+    int row = first;
+    for (const auto &record : queries) {
+        auto query = con->queryPool.allocate();
+        query->parent = parent;
+        query->type = Query;
+        query->row = row++;
+        query->start = record.timestamp;
+        query->duration = record.duration;
+        query->text = con->texts.acquire(record.query);
+        query->resultsCount = record.resultsCount;
+        const QString error = record.error.trimmed();
+        if (!error.isEmpty() || !record.values.isEmpty() || !record.results.isEmpty()) {
+            query->details = con->detailsPool.allocate();
+            query->details->error = error;
+            query->details->values = record.values;
+            query->details->results = record.results;
+        }
+        if (record.captureSerial != 0) {
+            mCapturedQueries.insert(record.captureSerial, query);
+        }
+        if (trxQueries) {
+            trxQueries->append(query);
+        } else {
+            con->queries.append(query);
+        }
+        detectRepeat(con, parent, query, changedRuns);
+    }
+    endInsertRows();
+
+    if (changedRuns.isEmpty()) {
+        return;
+    }
+    for (const auto run : std::as_const(changedRuns)) {
+        const QModelIndex firstIdx = createIndex(run->first->row, 0, run->first);
+        if (run->reported) {
+            const QModelIndex repeatedIdx = firstIdx.sibling(firstIdx.row(), RepeatedColumn);
+            Q_EMIT dataChanged(repeatedIdx, repeatedIdx);
+        } else {
+            run->reported = true;
+            mRepeatedRuns << run;
+            // Highlight the queries of the run that were already in the tree
+            if (run->first->row < first) {
+                Q_EMIT dataChanged(firstIdx, firstIdx.sibling(first - 1, columnCount() - 1));
+            }
+        }
+    }
+    Q_EMIT repeatedQueriesChanged();
+}
+
+void QueryTreeModel::removeCapturedQueries(const QList<quint64> &serials)
+{
+    bool runsChanged = false;
+    for (const auto serial : serials) {
+        if (auto query = mCapturedQueries.take(serial)) {
+            runsChanged |= removeQuery(query);
+        }
+    }
+    if (runsChanged) {
+        Q_EMIT repeatedQueriesChanged();
+    }
+}
+
+bool QueryTreeModel::removeQuery(QueryNode *query)
+{
+    Node *parent = query->parent;
+    auto con = connectionOf(parent);
+    auto trx = parent->type == Transaction ? static_cast<TransactionNode *>(parent) : nullptr;
+    const auto siblingCount = [con, trx]() {
+        return trx ? trx->queries.count() : con->queries.count();
+    };
+    const auto sibling = [con, trx](int row) -> Node * {
+        return trx ? trx->queries.at(row) : con->queries.at(row);
+    };
+
+    const int row = query->row;
+    beginRemoveRows(createIndex(parent->row, 0, parent), row, row);
+    if (trx) {
+        trx->queries.removeAt(row);
+    } else {
+        con->queries.removeAt(row);
+    }
+    for (int i = row; i < siblingCount(); ++i) {
+        sibling(i)->row = i;
+    }
+    endRemoveRows();
+
+    if (con->runParent == parent) {
+        auto candidate = con->runCandidates.find(query->text);
+        if (candidate != con->runCandidates.end() && candidate->last == query) {
+            con->runCandidates.erase(candidate);
+        }
+    }
+
+    bool runChanged = false;
+    if (auto run = query->run) {
+        --run->count;
+        run->duration -= query->duration;
+        if (run->first == query) {
+            // The rest of the run follows among the siblings
+            run->first = nullptr;
+            for (int i = row; i < siblingCount(); ++i) {
+                Node *node = sibling(i);
+                if (node->type == Query && static_cast<QueryNode *>(node)->run == run) {
+                    run->first = static_cast<QueryNode *>(node);
+                    break;
+                }
+            }
+        }
+        if (!run->first) {
+            runChanged = mRepeatedRuns.removeOne(run);
+            con->runPool.release(run);
+        } else if (run->reported) {
+            runChanged = true;
+            const QModelIndex repeatedIdx = createIndex(run->first->row, RepeatedColumn, run->first);
+            Q_EMIT dataChanged(repeatedIdx, repeatedIdx);
+        }
+    }
+
+    if (query->details) {
+        con->detailsPool.release(query->details);
+    }
+    con->texts.release(query->text);
+    con->queryPool.release(query);
+    return runChanged;
+}
+
+QueryTreeModel::ConnectionNode *QueryTreeModel::connectionOf(Node *node)
+{
+    while (node->parent) {
+        node = node->parent;
+    }
+    return static_cast<ConnectionNode *>(node);
+}
+
+void QueryTreeModel::detectRepeat(ConnectionNode *con, Node *parent, QueryNode *query, QList<RepeatRun *> &changedRuns)
+{
+    if (con->runParent != parent) {
+        con->runParent = parent;
+        con->runCandidates.clear();
+    }
+
+    const qint64 position = ++con->runPosition;
+    auto it = con->runCandidates.find(query->text);
+    if (it == con->runCandidates.end()) {
+        // Forget the statements that fell out of the window before the hash grows
+        if (con->runCandidates.size() >= 256) {
+            for (auto candidate = con->runCandidates.begin(); candidate != con->runCandidates.end();) {
+                if (position - candidate->position > RepeatWindow + 1) {
+                    candidate = con->runCandidates.erase(candidate);
+                } else {
+                    ++candidate;
+                }
+            }
+        }
+        con->runCandidates.insert(query->text, {query, position});
+        return;
+    }
+
+    if (position - it->position <= RepeatWindow + 1) {
+        auto run = it->last->run;
+        if (!run) {
+            // Only allocated once a statement is seen twice in a row
+            run = con->runPool.allocate();
+            run->parent = parent;
+            run->first = it->last;
+            run->count = 1;
+            run->duration = it->last->duration;
+            it->last->run = run;
+        }
+        query->run = run;
+        ++run->count;
+        run->duration += query->duration;
+        if (run->count >= RepeatThreshold && !changedRuns.contains(run)) {
+            changedRuns << run;
+        }
+    }
+    it->last = query;
+    it->position = position;
+}
+
+int QueryTreeModel::rowCount(const QModelIndex &parent) const
+{
+    if (!parent.isValid()) {
+        return mConnections.count();
+    }
+
+    Node *node = reinterpret_cast<Node *>(parent.internalPointer());
+    switch (node->type) {
+    case Connection:
+        return static_cast<ConnectionNode *>(node)->queries.count();
+    case Transaction:
+        return static_cast<TransactionNode *>(node)->queries.count();
+    case Query:
+        return 0;
+    }
+
+    Q_UNREACHABLE();
+}
+
+int QueryTreeModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent)
+    return RepeatedColumn + 1;
+}
+
+QModelIndex QueryTreeModel::parent(const QModelIndex &child) const
+{
+    if (!child.isValid() || !child.internalPointer()) {
+        return {};
+    }
+
+    Node *childNode = reinterpret_cast<Node *>(child.internalPointer());
+    // childNode is a Connection
+    if (!childNode->parent) {
+        return {};
+    }
+
+    return createIndex(childNode->parent->row, 0, childNode->parent);
+}
+
+QModelIndex QueryTreeModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (row < 0 || column < 0) {
+        return {};
+    }
+
+    if (!parent.isValid()) {
+        if (row < mConnections.count()) {
+            return createIndex(row, column, mConnections.at(row));
+        } else {
+            return {};
+        }
+    }
+
+    Node *parentNode = reinterpret_cast<Node *>(parent.internalPointer());
+    switch (parentNode->type) {
+    case Connection:
+        if (row < static_cast<ConnectionNode *>(parentNode)->queries.count()) {
+            return createIndex(row, column, static_cast<ConnectionNode *>(parentNode)->queries.at(row));
+        } else {
+            return {};
+        }
+    case Transaction:
+        if (row < static_cast<TransactionNode *>(parentNode)->queries.count()) {
+            return createIndex(row, column, static_cast<TransactionNode *>(parentNode)->queries.at(row));
+        } else {
+            return {};
+        }
+    case Query:
+        // Query can never have children
+        return {};
+    }
+
+    Q_UNREACHABLE();
+}
+
+QVariant QueryTreeModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return {};
+    }
+
+    switch (section) {
+    case 0:
+        return i18n("Name / Query");
+    case 1:
+        return i18n("Started");
+    case 2:
+        return i18n("Ended");
+    case 3:
+        return i18n("Duration");
+    case 4:
+        return i18n("Error");
+    case RepeatedColumn:
+        return i18n("Repeated");
+    }
+
+    return {};
+}
+
+QVariant QueryTreeModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid()) {
+        return {};
+    }
+
+    Node *node = reinterpret_cast<Node *>(index.internalPointer());
+    if (role == RowTypeRole) {
+        return node->type;
+    } else {
+        switch (node->type) {
+        case Connection:
+            return connectionData(static_cast<ConnectionNode *>(node), index.column(), role);
+        case Transaction:
+            return transactionData(static_cast<TransactionNode *>(node), index.column(), role);
+        case Query:
+            return queryData(static_cast<QueryNode *>(node), index.column(), role);
+        }
+    }
+
+    Q_UNREACHABLE();
+}
+
+QList<QueryTreeModel::SnapshotRow> QueryTreeModel::snapshot() const
+{
+    QList<SnapshotRow> rows;
+    for (const auto con : mConnections) {
+        SnapshotRow conRow;
+        conRow.type = Connection;
+        conRow.connectionId = con->id;
+        conRow.name = con->name;
+        conRow.start = con->start;
+        rows << conRow;
+
+        const auto queryRow = [con](const QueryNode *query) {
+            SnapshotRow row;
+            row.type = Query;
+            row.connectionId = con->id;
+            row.name = con->texts.at(query->text);
+            row.start = query->start;
+            row.duration = query->duration;
+            if (const auto details = query->details) {
+                row.error = details->error;
+                row.values = details->values;
+                row.results = details->results;
+            }
+            row.resultsCount = query->resultsCount;
+            return row;
+        };
+
+        for (const auto node : std::as_const(con->queries)) {
+            if (node->type != Transaction) {
+                rows << queryRow(static_cast<QueryNode *>(node));
+                continue;
+            }
+            const auto trx = static_cast<TransactionNode *>(node);
+            SnapshotRow trxRow;
+            trxRow.type = Transaction;
+            trxRow.connectionId = con->id;
+            trxRow.name = con->texts.at(trx->name);
+            trxRow.start = trx->start;
+            trxRow.duration = trx->duration;
+            trxRow.error = trx->error;
+            trxRow.transactionState = static_cast<TransactionState>(trx->transactionType);
+            rows << trxRow;
+            for (const auto query : std::as_const(trx->queries)) {
+                rows << queryRow(query);
+                rows.last().inTransaction = true;
+            }
+        }
+    }
+    return rows;
+}
+
+QList<QueryTreeModel::RepeatedQuery> QueryTreeModel::repeatedQueries(int count) const
+{
+    QList<RepeatRun *> runs = mRepeatedRuns;
+    const auto byDuration = [](const RepeatRun *a, const RepeatRun *b) {
+        return a->duration > b->duration;
+    };
+    if (count < runs.count()) {
+        std::partial_sort(runs.begin(), runs.begin() + count, runs.end(), byDuration);
+        runs.resize(count);
+    } else {
+        std::sort(runs.begin(), runs.end(), byDuration);
+    }
+
+    QList<RepeatedQuery> result;
+    result.reserve(runs.count());
+    for (const auto run : std::as_const(runs)) {
+        RepeatedQuery repeated;
+        const auto con = connectionOf(run->parent);
+        if (run->parent->type == Transaction) {
+            repeated.transactionName = con->texts.at(static_cast<TransactionNode *>(run->parent)->name);
+        }
+        repeated.connectionName = con->name;
+        repeated.query = con->texts.at(run->first->text);
+        repeated.count = run->count;
+        repeated.duration = run->duration;
+        repeated.first = createIndex(run->first->row, 0, run->first);
+        result << repeated;
+    }
+    return result;
+}
+
+QString QueryTreeModel::fromMSecsSinceEpoch(qint64 msecs) const
+{
+    return QDateTime::fromMSecsSinceEpoch(msecs).toString(u"dd.MM.yyyy HH:mm:ss.zzz"_s);
+}
+
+QVariant QueryTreeModel::connectionData(ConnectionNode *connection, int column, int role) const
+{
+    if (role != Qt::DisplayRole) {
+        return {};
+    }
+
+    switch (column) {
+    case 0:
+        return connection->name;
+    case 1:
+        return fromMSecsSinceEpoch(connection->start);
+    }
+
+    return {};
+}
+
+QVariant QueryTreeModel::timeData(Node *node, int column) const
+{
+    switch (column) {
+    case 1:
+        return fromMSecsSinceEpoch(node->start);
+    case 2:
+        return fromMSecsSinceEpoch(node->start + node->duration);
+    case 3:
+        return QTime(0, 0, 0).addMSecs(node->duration).toString(u"HH:mm:ss.zzz"_s);
+    }
+    return {};
+}
+
+QVariant QueryTreeModel::transactionData(TransactionNode *transaction, int column, int role) const
+{
+    const QString &name = connectionOf(transaction)->texts.at(transaction->name);
+    switch (role) {
+    case Qt::BackgroundRole:
+        if (!transaction->error.isEmpty()) {
+            return KColorScheme(QPalette::Normal).background(KColorScheme::NegativeBackground).color();
+        }
+        break;
+    case Qt::DisplayRole:
+        switch (column) {
+        case 0: {
+            QString mode;
+            switch (transaction->transactionType) {
+            case TransactionNode::Begin:
+                mode = u"BEGIN"_s;
+                break;
+            case TransactionNode::Commit:
+                mode = u"COMMIT"_s;
+                break;
+            case TransactionNode::Rollback:
+                mode = u"ROLLBACK"_s;
+                break;
+            }
+            return u"%1 %2"_s.arg(mode, name);
+        }
+        case 1:
+        case 2:
+        case 3:
+            return timeData(transaction, column);
+        case 4:
+            return transaction->error;
+        }
+        break;
+    case QueryRole:
+        return name;
+    }
+
+    return {};
+}
+
+QVariant QueryTreeModel::queryData(QueryNode *query, int column, int role) const
+{
+    const auto details = query->details;
+    switch (role) {
+    case Qt::BackgroundRole:
+        if (details && !details->error.isEmpty()) {
+            return KColorScheme(QPalette::Normal).background(KColorScheme::NegativeBackground).color();
+        } else if (query->run && query->run->reported) {
+            return KColorScheme(QPalette::Normal).background(KColorScheme::NeutralBackground).color();
+        }
+        break;
+    case Qt::DisplayRole:
+        switch (column) {
+        case 0:
+            return connectionOf(query)->texts.at(query->text);
+        case 1:
+        case 2:
+        case 3:
+            return timeData(query, column);
+        case 4:
+            return details ? details->error : QString();
+        case RepeatedColumn:
+            if (query->run && query->run->reported && query->run->first == query) {
+                return i18n("%1× in a row, %2 ms total", query->run->count, query->run->duration);
+            }
+            break;
+        }
+        break;
+    case QueryRole:
+        return connectionOf(query)->texts.at(query->text);
+    case QueryResultsCountRole:
+        return query->resultsCount;
+    case QueryResultsRole:
+        return QVariant::fromValue(details ? details->results : QList<QList<QVariant>>());
+    case QueryValuesRole:
+        return details ? details->values : QMap<QString, QVariant>();
+    }
+
+    return {};
+}
+
+#include "moc_querytreemodel.cpp"
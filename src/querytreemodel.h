@@ -0,0 +1,309 @@
+/*
+ * SPDX-FileCopyrightText: 2013 Daniel Vrátil <dvratil@redhat.com>
+ * SPDX-FileCopyrightText: 2017 Daniel Vrátil <dvratil@kde.org>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ */
+
+#pragma once
+
+#include "libakonadiconsole_export.h"
+
+#include <QAbstractItemModel>
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QVariant>
+
+#include <memory>
+#include <vector>
+
+Q_DECLARE_METATYPE(QList<QList<QVariant>>)
+
+struct QueryRecord {
+    qint64 connectionId = 0;
+    qint64 timestamp = 0;
+    uint duration = 0;
+    QString query;
+    QMap<QString, QVariant> values;
+    int resultsCount = 0;
+    QList<QList<QVariant>> results;
+    QString error;
+    // Serial given by the QueryCaptureFilter, to remove the query once it is evicted
+    quint64 captureSerial = 0;
+};
+
+class LIBAKONADICONSOLE_EXPORT QueryTreeModel : public QAbstractItemModel
+{
+    Q_OBJECT
+
+public:
+    enum RowType {
+        Connection,
+        Transaction,
+        Query
+    };
+
+    enum TransactionState {
+        TransactionOpen,
+        TransactionCommitted,
+        TransactionRolledBack
+    };
+
+    /** A copy of a single row of the tree, in depth-first order. */
+    struct SnapshotRow {
+        RowType type = Query;
+        qint64 connectionId = 0;
+        // Connection name, transaction name or query
+        QString name;
+        qint64 start = 0;
+        uint duration = 0;
+        TransactionState transactionState = TransactionOpen;
+        // Whether a query was executed within a transaction
+        bool inTransaction = false;
+        QString error;
+        QMap<QString, QVariant> values;
+        int resultsCount = 0;
+        QList<QList<QVariant>> results;
+    };
+
+    /** The same statement executed over and over within a connection or transaction. */
+    struct RepeatedQuery {
+        QString connectionName;
+        // Empty when the queries were not executed within a transaction
+        QString transactionName;
+        QString query;
+        int count = 0;
+        quint64 duration = 0;
+        QModelIndex first;
+    };
+
+    // A statement is reported as repeated once it was executed this many
+    // times, with at most RepeatWindow other statements between two calls
+    static constexpr int RepeatThreshold = 5;
+    static constexpr int RepeatWindow = 4;
+
+    // Count and total time of a run of repeated statements, set on its first query
+    static constexpr int RepeatedColumn = 5;
+
+    enum {
+        RowTypeRole = Qt::UserRole + 1,
+        QueryRole,
+        QueryResultsCountRole,
+        QueryResultsRole,
+        QueryValuesRole
+    };
+
+    explicit QueryTreeModel(QObject *parent = nullptr);
+    ~QueryTreeModel() override;
+
+    void clear();
+
+    void addConnection(qint64 id, const QString &name, qint64 timestamp);
+    void updateConnection(qint64 id, const QString &name);
+    /** Removes the connection with all its transactions and queries. */
+    void removeConnection(qint64 id);
+    void addTransaction(qint64 connectionId, const QString &name, qint64 timestamp, uint duration, const QString &error);
+    void closeTransaction(qint64 connectionId, bool commit, qint64 timestamp, uint, const QString &error);
+    void addQuery(qint64 connectionId,
+                  qint64 timestamp,
+                  uint duration,
+                  const QString &queryStr,
+                  const QMap<QString, QVariant> &values,
+                  int resultsCount,
+                  const QList<QList<QVariant>> &results,
+                  const QString &error);
+    // Appends consecutive queries of a single connection with one row insertion
+    void addQueries(qint64 connectionId, const QList<QueryRecord> &queries);
+    /** Removes the queries added with these capture serials, unknown ones are ignored. */
+    void removeCapturedQueries(const QList<quint64> &serials);
+
+    [[nodiscard]] int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    [[nodiscard]] int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    [[nodiscard]] QModelIndex parent(const QModelIndex &child) const override;
+    [[nodiscard]] QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    [[nodiscard]] QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    [[nodiscard]] QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    /** Copies the whole tree, cheap as all strings and results are shared. */
+    [[nodiscard]] QList<SnapshotRow> snapshot() const;
+
+    /** Repeated statements that took the most time first. */
+    [[nodiscard]] QList<RepeatedQuery> repeatedQueries(int count) const;
+
+Q_SIGNALS:
+    void transactionClosed(qint64 connectionId, const QString &connectionName, const QString &name, qint64 start, qint64 end, bool commit);
+    void repeatedQueriesChanged();
+
+private:
+    // Nodes are carved out of fixed-size chunks, so that a burst of queries
+    // does not turn into a malloc() per row. Removing a connection (or the
+    // whole tree) releases its chunks at once.
+    template<typename T, int ChunkSize>
+    class NodePool
+    {
+    public:
+        T *allocate()
+        {
+            if (!mFree.empty()) {
+                T *node = mFree.back();
+                mFree.pop_back();
+                return node;
+            }
+            if (mUsed == ChunkSize) {
+                mChunks.push_back(std::make_unique<T[]>(ChunkSize));
+                mUsed = 0;
+            }
+            return &mChunks.back()[mUsed++];
+        }
+
+        // Resets the node, its slot is handed out again by the next allocate()
+        void release(T *node)
+        {
+            *node = T();
+            mFree.push_back(node);
+        }
+
+        void clear()
+        {
+            mChunks.clear();
+            mFree.clear();
+            mUsed = ChunkSize;
+        }
+
+    private:
+        std::vector<std::unique_ptr<T[]>> mChunks;
+        std::vector<T *> mFree;
+        int mUsed = ChunkSize;
+    };
+
+    // Statements and transaction names of a connection, each distinct text is
+    // stored once however often it is executed. A text is forgotten with the
+    // last node referring to it.
+    class TextTable
+    {
+    public:
+        [[nodiscard]] int acquire(const QString &text);
+        void release(int id);
+        [[nodiscard]] const QString &at(int id) const
+        {
+            return mTexts[id].text;
+        }
+
+    private:
+        struct Text {
+            QString text;
+            int references = 0;
+        };
+        std::vector<Text> mTexts;
+        std::vector<int> mFree;
+        QHash<QString, int> mIds;
+    };
+
+    class Node
+    {
+    public:
+        Node *parent = nullptr;
+        qint64 start = 0;
+        // Position of the node within its parent, kept up to date so that
+        // parent() does not have to search for it.
+        int row = 0;
+        uint duration = 0;
+        RowType type = Query;
+    };
+
+    class RepeatRun;
+
+    // The parts of a query that many statements do not have, kept out of line
+    class QueryDetails
+    {
+    public:
+        QString error;
+        QMap<QString, QVariant> values;
+        QList<QList<QVariant>> results;
+    };
+
+    class QueryNode : public Node
+    {
+    public:
+        // Set when the query is part of a run of repeated statements
+        RepeatRun *run = nullptr;
+        // Nullptr when the query has no error, bound values or results
+        QueryDetails *details = nullptr;
+        // Statement in the TextTable of the connection
+        int text = -1;
+        int resultsCount = 0;
+    };
+
+    class TransactionNode : public Node
+    {
+    public:
+        enum TransactionType {
+            Begin,
+            Commit,
+            Rollback
+        };
+        TransactionType transactionType = Begin;
+        // Name in the TextTable of the connection
+        int name = -1;
+        QString error;
+        QList<QueryNode *> queries;
+    };
+
+    class RepeatRun
+    {
+    public:
+        Node *parent = nullptr;
+        QueryNode *first = nullptr;
+        int count = 0;
+        quint64 duration = 0;
+        bool reported = false;
+    };
+
+    class RepeatCandidate
+    {
+    public:
+        // Last execution of the statement and its position within runParent
+        QueryNode *last = nullptr;
+        qint64 position = 0;
+    };
+
+    class ConnectionNode : public Node
+    {
+    public:
+        qint64 id = 0;
+        QString name;
+        QList<Node *> queries;
+
+        // Owns everything below this connection
+        NodePool<QueryNode, 256> queryPool;
+        NodePool<QueryDetails, 256> detailsPool;
+        NodePool<TransactionNode, 32> transactionPool;
+        NodePool<RepeatRun, 64> runPool;
+        TextTable texts;
+
+        // Sliding window of the statements recently executed under runParent, by text
+        Node *runParent = nullptr;
+        qint64 runPosition = 0;
+        QHash<int, RepeatCandidate> runCandidates;
+    };
+
+    void detectRepeat(ConnectionNode *con, Node *parent, QueryNode *query, QList<RepeatRun *> &changedRuns);
+    // Returns whether a reported run changed
+    bool removeQuery(QueryNode *query);
+    [[nodiscard]] static ConnectionNode *connectionOf(Node *node);
+
+    [[nodiscard]] QString fromMSecsSinceEpoch(qint64 msecs) const;
+    // Started, Ended and Duration columns of a transaction or query
+    QVariant timeData(Node *node, int column) const;
+    QVariant connectionData(ConnectionNode *connection, int column, int role) const;
+    QVariant transactionData(TransactionNode *transaction, int column, int role) const;
+    QVariant queryData(QueryNode *query, int column, int role) const;
+
+    NodePool<ConnectionNode, 16> mConnectionPool;
+    QList<ConnectionNode *> mConnections;
+    QHash<qint64, ConnectionNode *> mConnectionById;
+    QList<RepeatRun *> mRepeatedRuns;
+    QHash<quint64, QueryNode *> mCapturedQueries;
+};
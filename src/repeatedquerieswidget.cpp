@@ -0,0 +1,107 @@
+/*
+ * SPDX-FileCopyrightText: 2026 akonadiconsole authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ */
+
+#include "repeatedquerieswidget.h"
+using namespace Qt::Literals::StringLiterals;
+
+#include "querytreemodel.h"
+#include "utils.h"
+
+#include <KLocalizedString>
+
+#include <QHeaderView>
+#include <QStandardItemModel>
+#include <QTreeView>
+#include <QVBoxLayout>
+
+#include <chrono>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+// Only the worst offenders are of any interest
+constexpr int MaxRepeatedQueries = 100;
+}
+
+RepeatedQueriesWidget::RepeatedQueriesWidget(QueryTreeModel *queryTree, QWidget *parent)
+    : QWidget(parent)
+    , mQueryTree(queryTree)
+    , mModel(new QStandardItemModel(this))
+{
+    auto layout = new QVBoxLayout(this);
+    layout->setContentsMargins({});
+
+    mModel->setHorizontalHeaderLabels(
+        {i18n("Total Duration [ms]"), i18n("Count"), i18n("Avg Duration [ms]"), i18n("Connection"), i18n("Transaction"), i18n("Query")});
+
+    auto view = new QTreeView(this);
+    view->setObjectName("repeatedQueriesView"_L1);
+    view->setRootIsDecorated(false);
+    view->setUniformRowHeights(true);
+    view->setModel(mModel);
+    view->header()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    view->setToolTip(i18n("Statements executed at least %1 times in a row. Double-click to show them in the Query Tree.", QueryTreeModel::RepeatThreshold));
+    layout->addWidget(view);
+
+    connect(view, &QTreeView::doubleClicked, this, [this](const QModelIndex &index) {
+        if (index.row() < mFirstQueries.count() && mFirstQueries.at(index.row()).isValid()) {
+            Q_EMIT queryActivated(mFirstQueries.at(index.row()));
+        }
+    });
+
+    mRefreshTimer.setInterval(1s);
+    mRefreshTimer.setSingleShot(true);
+    connect(&mRefreshTimer, &QTimer::timeout, this, &RepeatedQueriesWidget::refresh);
+
+    connect(queryTree, &QueryTreeModel::repeatedQueriesChanged, this, &RepeatedQueriesWidget::scheduleRefresh);
+    connect(queryTree, &QAbstractItemModel::modelReset, this, &RepeatedQueriesWidget::refresh);
+}
+
+RepeatedQueriesWidget::~RepeatedQueriesWidget() = default;
+
+void RepeatedQueriesWidget::scheduleRefresh()
+{
+    if (!mRefreshTimer.isActive()) {
+        mRefreshTimer.start();
+    }
+}
+
+void RepeatedQueriesWidget::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    if (mDirty) {
+        refresh();
+    }
+}
+
+void RepeatedQueriesWidget::refresh()
+{
+    // The indexes would not survive a reset of the tree, so always drop them
+    if (!isVisible()) {
+        mModel->removeRows(0, mModel->rowCount());
+        mFirstQueries.clear();
+        mDirty = true;
+        return;
+    }
+    mDirty = false;
+
+    mModel->removeRows(0, mModel->rowCount());
+    mFirstQueries.clear();
+    const auto repeated = mQueryTree->repeatedQueries(MaxRepeatedQueries);
+    for (const auto &run : repeated) {
+        mModel->appendRow({numberItem(run.duration),
+                           numberItem(run.count),
+                           numberItem(qRound64(double(run.duration) / run.count)),
+                           textItem(run.connectionName),
+                           textItem(run.transactionName),
+                           textItem(run.query)});
+        mFirstQueries << run.first;
+    }
+}
+
+#include "moc_repeatedquerieswidget.cpp"
@@ -0,0 +1,45 @@
+/*
+ * SPDX-FileCopyrightText: 2026 akonadiconsole authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ */
+
+#pragma once
+
+#include <QPersistentModelIndex>
+#include <QTimer>
+#include <QWidget>
+
+class QStandardItemModel;
+class QueryTreeModel;
+
+/**
+ * Lists the statements the Query Debugger saw executed over and over in a row,
+ * the typical symptom of an N+1 query pattern.
+ */
+class RepeatedQueriesWidget : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit RepeatedQueriesWidget(QueryTreeModel *queryTree, QWidget *parent = nullptr);
+    ~RepeatedQueriesWidget() override;
+
+Q_SIGNALS:
+    /** Emitted with the first query of the run the user double-clicked. */
+    void queryActivated(const QModelIndex &index);
+
+protected:
+    void showEvent(QShowEvent *event) override;
+
+private:
+    void scheduleRefresh();
+    void refresh();
+
+    QueryTreeModel *const mQueryTree;
+    QStandardItemModel *mModel = nullptr;
+    // Connections can be removed before the next refresh
+    QList<QPersistentModelIndex> mFirstQueries;
+    QTimer mRefreshTimer;
+    bool mDirty = false;
+};
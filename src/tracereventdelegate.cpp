@@ -0,0 +1,42 @@
+/*
+    SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "tracereventdelegate.h"
+
+#include "tracereventmodel.h"
+
+#include <KColorScheme>
+
+TracerEventDelegate::TracerEventDelegate(QObject *parent)
+    : QStyledItemDelegate(parent)
+{
+}
+
+TracerEventDelegate::~TracerEventDelegate() = default;
+
+void TracerEventDelegate::initStyleOption(QStyleOptionViewItem *option, const QModelIndex &index) const
+{
+    QStyledItemDelegate::initStyleOption(option, index);
+
+    KColorScheme::ForegroundRole role = KColorScheme::NormalText;
+    switch (index.data(TracerEventModel::SeverityRole).toInt()) {
+    case TracerEventModel::Signal:
+        role = KColorScheme::PositiveText;
+        break;
+    case TracerEventModel::Warning:
+        role = KColorScheme::NeutralText;
+        break;
+    case TracerEventModel::Error:
+        role = KColorScheme::NegativeText;
+        option->font.setBold(index.column() == TracerEventModel::SeverityColumn);
+        break;
+    }
+    const QColor color = KColorScheme(option->palette.currentColorGroup()).foreground(role).color();
+    option->palette.setColor(QPalette::Text, color);
+    option->palette.setColor(QPalette::WindowText, color);
+}
+
+#include "moc_tracereventdelegate.cpp"
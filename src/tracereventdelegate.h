@@ -0,0 +1,23 @@
+/*
+    SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QStyledItemDelegate>
+
+/**
+ * Colors the rows of a TracerEventModel by their severity.
+ */
+class TracerEventDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+public:
+    explicit TracerEventDelegate(QObject *parent = nullptr);
+    ~TracerEventDelegate() override;
+
+protected:
+    void initStyleOption(QStyleOptionViewItem *option, const QModelIndex &index) const override;
+};
@@ -0,0 +1,145 @@
+/*
+    SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "tracereventmodel.h"
+using namespace Qt::Literals::StringLiterals;
+
+#include <KLocalizedString>
+
+#include <QDateTime>
+
+#include <algorithm>
+
+namespace
+{
+// Share of the maximum count dropped at once when the model is full
+constexpr int DropDivisor = 16;
+}
+
+TracerEventModel::TracerEventModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+TracerEventModel::~TracerEventModel() = default;
+
+void TracerEventModel::addEvents(const QList<Event> &events)
+{
+    // Events that would be dropped right away are not even inserted
+    const int count = std::min<int>(events.count(), mMaximumCount);
+    if (count == 0) {
+        return;
+    }
+
+    const int excess = int(mEvents.size()) + count - mMaximumCount;
+    if (excess > 0) {
+        dropOldest(std::min(std::max(excess, mMaximumCount / DropDivisor), int(mEvents.size())));
+    }
+
+    const int first = int(mEvents.size());
+    beginInsertRows({}, first, first + count - 1);
+    mEvents.insert(mEvents.end(), events.cend() - count, events.cend());
+    endInsertRows();
+}
+
+void TracerEventModel::dropOldest(int count)
+{
+    if (count <= 0) {
+        return;
+    }
+    beginRemoveRows({}, 0, count - 1);
+    mEvents.erase(mEvents.begin(), mEvents.begin() + count);
+    endRemoveRows();
+}
+
+void TracerEventModel::clear()
+{
+    beginResetModel();
+    mEvents.clear();
+    mEvents.shrink_to_fit();
+    endResetModel();
+}
+
+int TracerEventModel::maximumCount() const
+{
+    return mMaximumCount;
+}
+
+void TracerEventModel::setMaximumCount(int count)
+{
+    mMaximumCount = std::max(count, 1);
+    dropOldest(int(mEvents.size()) - mMaximumCount);
+}
+
+int TracerEventModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : int(mEvents.size());
+}
+
+int TracerEventModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : _ColumnCount;
+}
+
+QVariant TracerEventModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return {};
+    }
+
+    switch (section) {
+    case TimeColumn:
+        return i18n("Time");
+    case SeverityColumn:
+        return i18n("Severity");
+    case ComponentColumn:
+        return i18n("Component");
+    case MessageColumn:
+        return i18n("Message");
+    }
+    return {};
+}
+
+QVariant TracerEventModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= rowCount()) {
+        return {};
+    }
+
+    const auto &event = mEvents[index.row()];
+    switch (role) {
+    case Qt::DisplayRole:
+        switch (index.column()) {
+        case TimeColumn:
+            return QDateTime::fromMSecsSinceEpoch(event.timestamp).toString(u"HH:mm:ss.zzz"_s);
+        case SeverityColumn:
+            switch (event.severity) {
+            case Signal:
+                return i18n("Signal");
+            case Warning:
+                return i18n("Warning");
+            case Error:
+                return i18n("Error");
+            }
+            return {};
+        case ComponentColumn:
+            return event.component;
+        case MessageColumn:
+            return event.message;
+        }
+        break;
+    case Qt::ToolTipRole:
+        if (index.column() == MessageColumn) {
+            return event.message;
+        }
+        break;
+    case SeverityRole:
+        return event.severity;
+    }
+    return {};
+}
+
+#include "moc_tracereventmodel.cpp"
@@ -0,0 +1,77 @@
+/*
+    SPDX-FileCopyrightText: 2026 akonadiconsole authors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "libakonadiconsole_export.h"
+
+#include <QAbstractTableModel>
+#include <QList>
+
+#include <deque>
+
+/**
+ * The signals, warnings and errors reported by the Akonadi tracer.
+ *
+ * Events are kept as plain text, at most maximumCount() of them. Once that is
+ * reached the oldest ones are dropped in chunks, so that adding an event
+ * stays O(1) and the memory use stays flat.
+ */
+class LIBAKONADICONSOLE_EXPORT TracerEventModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    enum Severity {
+        Signal,
+        Warning,
+        Error
+    };
+    Q_ENUM(Severity)
+
+    struct Event {
+        // Milliseconds since the epoch
+        qint64 timestamp = 0;
+        Severity severity = Signal;
+        // The component that reported a warning or an error, the name of a signal
+        QString component;
+        QString message;
+    };
+
+    enum Columns {
+        TimeColumn,
+        SeverityColumn,
+        ComponentColumn,
+        MessageColumn,
+
+        _ColumnCount
+    };
+
+    enum Roles {
+        SeverityRole = Qt::UserRole
+    };
+
+    static constexpr int DefaultMaximumCount = 10'000;
+
+    explicit TracerEventModel(QObject *parent = nullptr);
+    ~TracerEventModel() override;
+
+    void addEvents(const QList<Event> &events);
+    void clear();
+
+    [[nodiscard]] int maximumCount() const;
+    void setMaximumCount(int count);
+
+    [[nodiscard]] int rowCount(const QModelIndex &parent = {}) const override;
+    [[nodiscard]] int columnCount(const QModelIndex &parent = {}) const override;
+    [[nodiscard]] QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
+    [[nodiscard]] QVariant data(const QModelIndex &index, int role) const override;
+
+private:
+    void dropOldest(int count);
+
+    std::deque<Event> mEvents;
+    int mMaximumCount = DefaultMaximumCount;
+};
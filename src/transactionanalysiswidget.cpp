@@ -0,0 +1,169 @@
+/*
+ * SPDX-FileCopyrightText: 2026 akonadiconsole authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ */
+
+#include "transactionanalysiswidget.h"
+using namespace Qt::Literals::StringLiterals;
+
+#include "querytreemodel.h"
+#include "utils.h"
+
+#include <KLocalizedString>
+
+#include <QDateTime>
+#include <QHeaderView>
+#include <QStandardItemModel>
+#include <QTabWidget>
+#include <QTreeView>
+#include <QVBoxLayout>
+
+#include <chrono>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+QStandardItem *timeItem(qint64 msecs)
+{
+    return textItem(QDateTime::fromMSecsSinceEpoch(msecs).toString(u"dd.MM.yyyy HH:mm:ss.zzz"_s));
+}
+
+QStandardItem *outcomeItem(bool commit)
+{
+    return textItem(commit ? u"COMMIT"_s : u"ROLLBACK"_s);
+}
+
+QTreeView *createView(QStandardItemModel *model, QWidget *parent)
+{
+    auto view = new QTreeView(parent);
+    view->setRootIsDecorated(false);
+    view->setUniformRowHeights(true);
+    view->setModel(model);
+    view->header()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    return view;
+}
+}
+
+TransactionAnalysisWidget::TransactionAnalysisWidget(QueryTreeModel *queryTree, QWidget *parent)
+    : QWidget(parent)
+    , mLongestModel(new QStandardItemModel(this))
+    , mOverlapsModel(new QStandardItemModel(this))
+    , mConnectionsModel(new QStandardItemModel(this))
+    , mRollbacksModel(new QStandardItemModel(this))
+{
+    auto layout = new QVBoxLayout(this);
+    layout->setContentsMargins({});
+
+    auto tabWidget = new QTabWidget(this);
+    tabWidget->setObjectName("transactionAnalysisTab"_L1);
+    layout->addWidget(tabWidget);
+
+    mLongestModel->setHorizontalHeaderLabels(
+        {i18n("Connection"), i18n("Transaction"), i18n("Started"), i18n("Duration [ms]"), i18n("Result"), i18n("Concurrent Transactions")});
+    tabWidget->addTab(createView(mLongestModel, tabWidget), i18n("Longest Transactions"));
+
+    mOverlapsModel->setHorizontalHeaderLabels({i18n("Overlap [ms]"),
+                                               i18n("Connection"),
+                                               i18n("Transaction"),
+                                               i18n("Duration [ms]"),
+                                               i18n("Connection"),
+                                               i18n("Transaction"),
+                                               i18n("Duration [ms]")});
+    tabWidget->addTab(createView(mOverlapsModel, tabWidget), i18n("Overlapping Transactions"));
+
+    mConnectionsModel->setHorizontalHeaderLabels(
+        {i18n("Connection"), i18n("Transactions"), i18n("Rollbacks"), i18n("Time in Transactions [ms]"), i18n("Share of Transaction Time [%]")});
+    tabWidget->addTab(createView(mConnectionsModel, tabWidget), i18n("Connections"));
+
+    mRollbacksModel->setHorizontalHeaderLabels({i18n("Transaction"), i18n("Rollbacks"), i18n("Transactions"), i18n("Rollback Rate [%]")});
+    tabWidget->addTab(createView(mRollbacksModel, tabWidget), i18n("Rollback Hot Spots"));
+
+    mRefreshTimer.setInterval(1s);
+    mRefreshTimer.setSingleShot(true);
+    connect(&mRefreshTimer, &QTimer::timeout, this, &TransactionAnalysisWidget::refresh);
+
+    connect(queryTree, &QueryTreeModel::transactionClosed, this, &TransactionAnalysisWidget::transactionClosed);
+    connect(queryTree, &QAbstractItemModel::modelReset, this, &TransactionAnalysisWidget::reset);
+}
+
+TransactionAnalysisWidget::~TransactionAnalysisWidget() = default;
+
+void TransactionAnalysisWidget::transactionClosed(qint64 connectionId,
+                                                  const QString &connectionName,
+                                                  const QString &name,
+                                                  qint64 start,
+                                                  qint64 end,
+                                                  bool commit)
+{
+    mAnalyzer.addTransaction(connectionId, connectionName, name, start, end, commit);
+    if (!mRefreshTimer.isActive()) {
+        mRefreshTimer.start();
+    }
+}
+
+void TransactionAnalysisWidget::reset()
+{
+    mAnalyzer.clear();
+    refresh();
+}
+
+void TransactionAnalysisWidget::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    if (mDirty) {
+        refresh();
+    }
+}
+
+void TransactionAnalysisWidget::refresh()
+{
+    // Nobody is looking, rebuild the tables once the panel is shown again
+    if (!isVisible()) {
+        mDirty = true;
+        return;
+    }
+    mDirty = false;
+
+    mLongestModel->removeRows(0, mLongestModel->rowCount());
+    for (const auto &trx : mAnalyzer.longestTransactions()) {
+        mLongestModel->appendRow({textItem(trx.connectionName),
+                                  textItem(trx.name),
+                                  timeItem(trx.start),
+                                  numberItem(trx.duration()),
+                                  outcomeItem(trx.commit),
+                                  numberItem(trx.concurrent)});
+    }
+
+    mOverlapsModel->removeRows(0, mOverlapsModel->rowCount());
+    for (const auto &overlap : mAnalyzer.longestOverlaps()) {
+        mOverlapsModel->appendRow({numberItem(overlap.duration),
+                                   textItem(overlap.first.connectionName),
+                                   textItem(overlap.first.name),
+                                   numberItem(overlap.first.duration()),
+                                   textItem(overlap.second.connectionName),
+                                   textItem(overlap.second.name),
+                                   numberItem(overlap.second.duration())});
+    }
+
+    const qint64 totalTime = mAnalyzer.totalTransactionTime();
+    mConnectionsModel->removeRows(0, mConnectionsModel->rowCount());
+    for (const auto &con : mAnalyzer.connections()) {
+        auto share = new QStandardItem;
+        share->setData(totalTime > 0 ? qRound(1000.0 * con.time / totalTime) / 10.0 : 0.0, Qt::DisplayRole);
+        share->setEditable(false);
+        mConnectionsModel->appendRow({textItem(con.name), numberItem(con.transactions), numberItem(con.rollbacks), numberItem(con.time), share});
+    }
+
+    mRollbacksModel->removeRows(0, mRollbacksModel->rowCount());
+    for (const auto &stats : mAnalyzer.rollbackHotSpots()) {
+        auto rate = new QStandardItem;
+        rate->setData(qRound(1000.0 * stats.rollbacks / stats.transactions) / 10.0, Qt::DisplayRole);
+        rate->setEditable(false);
+        mRollbacksModel->appendRow({textItem(stats.name), numberItem(stats.rollbacks), numberItem(stats.transactions), rate});
+    }
+}
+
+#include "moc_transactionanalysiswidget.cpp"
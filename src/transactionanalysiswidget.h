@@ -0,0 +1,43 @@
+/*
+ * SPDX-FileCopyrightText: 2026 akonadiconsole authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ */
+
+#pragma once
+
+#include "transactionanalyzer.h"
+
+#include <QTimer>
+#include <QWidget>
+
+class QStandardItemModel;
+class QueryTreeModel;
+
+/**
+ * Shows the contention analysis of the transactions recorded by the Query Debugger.
+ */
+class TransactionAnalysisWidget : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit TransactionAnalysisWidget(QueryTreeModel *queryTree, QWidget *parent = nullptr);
+    ~TransactionAnalysisWidget() override;
+
+protected:
+    void showEvent(QShowEvent *event) override;
+
+private:
+    void transactionClosed(qint64 connectionId, const QString &connectionName, const QString &name, qint64 start, qint64 end, bool commit);
+    void reset();
+    void refresh();
+
+    TransactionAnalyzer mAnalyzer;
+    QStandardItemModel *mLongestModel = nullptr;
+    QStandardItemModel *mOverlapsModel = nullptr;
+    QStandardItemModel *mConnectionsModel = nullptr;
+    QStandardItemModel *mRollbacksModel = nullptr;
+    QTimer mRefreshTimer;
+    bool mDirty = false;
+};
@@ -0,0 +1,143 @@
+/*
+ * SPDX-FileCopyrightText: 2026 akonadiconsole authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ */
+
+#include "transactionanalyzer.h"
+
+#include <algorithm>
+
+namespace
+{
+// How long a closed transaction is remembered to detect overlaps with
+// transactions that are still running
+constexpr qint64 OverlapWindow = 10 * 60 * 1000;
+constexpr int MaxRecentTransactions = 10000;
+}
+
+TransactionAnalyzer::TransactionAnalyzer(int maxRanked)
+    : mMaxRanked(maxRanked)
+{
+}
+
+template<typename T, typename LessThan>
+void TransactionAnalyzer::insertRanked(QList<T> &list, const T &value, LessThan lessThan)
+{
+    if (list.count() == mMaxRanked && !lessThan(list.constLast(), value)) {
+        return;
+    }
+
+    list.insert(std::upper_bound(list.begin(), list.end(), value, [&lessThan](const T &a, const T &b) {
+                    return lessThan(b, a);
+                }),
+                value);
+    if (list.count() > mMaxRanked) {
+        list.removeLast();
+    }
+}
+
+void TransactionAnalyzer::addTransaction(qint64 connectionId, const QString &connectionName, const QString &name, qint64 start, qint64 end, bool commit)
+{
+    Transaction trx;
+    trx.connectionId = connectionId;
+    trx.connectionName = connectionName;
+    trx.name = name;
+    trx.start = start;
+    trx.end = std::max(start, end);
+    trx.commit = commit;
+
+    // mRecent is ordered by end, so only its tail can overlap the new transaction
+    for (auto it = mRecent.crbegin(), rend = mRecent.crend(); it != rend && it->end > trx.start; ++it) {
+        if (it->connectionId == trx.connectionId || it->start >= trx.end) {
+            continue;
+        }
+        ++trx.concurrent;
+        Overlap overlap;
+        overlap.first = *it;
+        overlap.second = trx;
+        overlap.duration = std::min(it->end, trx.end) - std::max(it->start, trx.start);
+        insertRanked(mOverlaps, overlap, [](const Overlap &a, const Overlap &b) {
+            return a.duration < b.duration;
+        });
+    }
+
+    const auto pos = std::upper_bound(mRecent.begin(), mRecent.end(), trx, [](const Transaction &a, const Transaction &b) {
+        return a.end < b.end;
+    });
+    mRecent.insert(pos, trx);
+    const qint64 oldest = mRecent.constLast().end - OverlapWindow;
+    qsizetype expired = 0;
+    while (expired < mRecent.count() && (mRecent.at(expired).end < oldest || mRecent.count() - expired > MaxRecentTransactions)) {
+        ++expired;
+    }
+    mRecent.remove(0, expired);
+
+    insertRanked(mLongest, trx, [](const Transaction &a, const Transaction &b) {
+        return a.duration() < b.duration();
+    });
+
+    auto &con = mConnections[connectionId];
+    con.connectionId = connectionId;
+    con.name = connectionName;
+    ++con.transactions;
+    con.time += trx.duration();
+    mTotalTime += trx.duration();
+
+    auto &rollback = mRollbacks[name];
+    rollback.name = name;
+    ++rollback.transactions;
+    if (!commit) {
+        ++con.rollbacks;
+        ++rollback.rollbacks;
+    }
+}
+
+void TransactionAnalyzer::clear()
+{
+    mRecent.clear();
+    mLongest.clear();
+    mOverlaps.clear();
+    mConnections.clear();
+    mRollbacks.clear();
+    mTotalTime = 0;
+}
+
+const QList<TransactionAnalyzer::Transaction> &TransactionAnalyzer::longestTransactions() const
+{
+    return mLongest;
+}
+
+const QList<TransactionAnalyzer::Overlap> &TransactionAnalyzer::longestOverlaps() const
+{
+    return mOverlaps;
+}
+
+QList<TransactionAnalyzer::ConnectionStats> TransactionAnalyzer::connections() const
+{
+    QList<ConnectionStats> connections = mConnections.values();
+    std::sort(connections.begin(), connections.end(), [](const ConnectionStats &a, const ConnectionStats &b) {
+        return a.time > b.time;
+    });
+    return connections;
+}
+
+QList<TransactionAnalyzer::RollbackStats> TransactionAnalyzer::rollbackHotSpots() const
+{
+    QList<RollbackStats> hotSpots;
+    for (const auto &stats : mRollbacks) {
+        if (stats.rollbacks > 0) {
+            hotSpots << stats;
+        }
+    }
+    std::sort(hotSpots.begin(), hotSpots.end(), [](const RollbackStats &a, const RollbackStats &b) {
+        return a.rollbacks > b.rollbacks || (a.rollbacks == b.rollbacks && a.transactions < b.transactions);
+    });
+    return hotSpots;
+}
+
+qint64 TransactionAnalyzer::totalTransactionTime() const
+{
+    return mTotalTime;
+}
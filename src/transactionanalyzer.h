@@ -0,0 +1,92 @@
+/*
+ * SPDX-FileCopyrightText: 2026 akonadiconsole authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ */
+
+#pragma once
+
+#include "libakonadiconsole_export.h"
+
+#include <QHash>
+#include <QList>
+#include <QString>
+
+/**
+ * Incremental contention analysis of database transactions.
+ *
+ * Every transaction is fed in once it has been committed or rolled back. The
+ * analyzer keeps the longest-held transactions, the longest overlaps between
+ * transactions of different connections, the time each connection spent in
+ * transactions and the number of rollbacks per transaction name. All ranked
+ * lists are bounded, so the analysis can run for as long as the debugger does.
+ */
+class LIBAKONADICONSOLE_EXPORT TransactionAnalyzer
+{
+public:
+    struct Transaction {
+        qint64 connectionId = 0;
+        QString connectionName;
+        QString name;
+        qint64 start = 0;
+        qint64 end = 0;
+        bool commit = true;
+        // Transactions of other connections that overlapped this one and
+        // were closed before it
+        int concurrent = 0;
+
+        [[nodiscard]] qint64 duration() const
+        {
+            return end - start;
+        }
+    };
+
+    struct Overlap {
+        Transaction first;
+        Transaction second;
+        qint64 duration = 0;
+    };
+
+    struct ConnectionStats {
+        qint64 connectionId = 0;
+        QString name;
+        int transactions = 0;
+        int rollbacks = 0;
+        qint64 time = 0;
+    };
+
+    struct RollbackStats {
+        QString name;
+        int transactions = 0;
+        int rollbacks = 0;
+    };
+
+    explicit TransactionAnalyzer(int maxRanked = 100);
+
+    void addTransaction(qint64 connectionId, const QString &connectionName, const QString &name, qint64 start, qint64 end, bool commit);
+    void clear();
+
+    /** Longest transactions first. */
+    [[nodiscard]] const QList<Transaction> &longestTransactions() const;
+    /** Longest overlaps between transactions of different connections first. */
+    [[nodiscard]] const QList<Overlap> &longestOverlaps() const;
+    /** Connections that spent the most time in transactions first. */
+    [[nodiscard]] QList<ConnectionStats> connections() const;
+    /** Transaction names with the most rollbacks first, names that never rolled back are skipped. */
+    [[nodiscard]] QList<RollbackStats> rollbackHotSpots() const;
+    [[nodiscard]] qint64 totalTransactionTime() const;
+
+private:
+    template<typename T, typename LessThan>
+    void insertRanked(QList<T> &list, const T &value, LessThan lessThan);
+
+    const int mMaxRanked;
+    // Recently closed transactions ordered by their end, used to find overlaps
+    QList<Transaction> mRecent;
+    QList<Transaction> mLongest;
+    QList<Overlap> mOverlaps;
+    QHash<qint64, ConnectionStats> mConnections;
+    QHash<QString, RollbackStats> mRollbacks;
+    qint64 mTotalTime = 0;
+};
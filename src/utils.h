@@ -76,3 +76,20 @@ inline void appendRow(QStandardItem *parent, const QString &name, const QString
     item->setToolTip(value);
     parent->appendRow({new QStandardItem(name), item});
 }
+
+// Read-only cells for the QStandardItemModel based reports
+inline QStandardItem *textItem(const QString &text)
+{
+    auto item = new QStandardItem(text);
+    item->setToolTip(text);
+    item->setEditable(false);
+    return item;
+}
+
+inline QStandardItem *numberItem(qint64 value)
+{
+    auto item = new QStandardItem;
+    item->setData(value, Qt::DisplayRole);
+    item->setEditable(false);
+    return item;
+}